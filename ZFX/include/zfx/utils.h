@@ -6,6 +6,7 @@
 #include <vector>
 #include <cstring>
 #include <cstdlib>
+#include <functional>
 #include <iostream>
 #include <sstream>
 #include <memory>
@@ -89,6 +90,25 @@ public:
   char const *what() const noexcept { return msg.c_str(); }
 };
 
+// compiler diagnostics go to stdout unless the host takes them, e.g. into
+// its own logger
+inline std::function<void(std::string const &)> &log_handler() {
+    static std::function<void(std::string const &)> handler;
+    return handler;
+}
+
+inline void log_message(std::string const &msg) {
+    if (auto &handler = log_handler())
+        handler(msg);
+    else
+        puts(msg.c_str());
+}
+
+template <class ...Ts>
+void debug_log(const char *fmt, Ts &&...ts) {
+    log_message(format(fmt, std::forward<Ts>(ts)...));
+}
+
 template <class E = Exception, class ...Ts>
 [[noreturn]] void error(const char *fmt, Ts &&...ts) {
     throw E(format(fmt, std::forward<Ts>(ts)...));
@@ -343,11 +343,11 @@ struct ImplAssembler {
         auto const &insts = builder->getResult();
 
 #ifdef ZFX_PRINT_IR
-        printf("variables: %d slots\n", nlocals);
-        printf("consts: %d values\n", nconsts);
-        printf("insts:");
-        for (auto const &inst: insts) printf(" %02X", inst);
-        printf("\n");
+        debug_log("variables: %d slots", nlocals);
+        debug_log("consts: %d values", nconsts);
+        std::string dump = "insts:";
+        for (auto const &inst: insts) dump += format(" %02X", inst);
+        log_message(dump);
 #endif
 
         if (!functable)
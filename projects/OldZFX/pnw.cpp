@@ -73,7 +73,7 @@ struct ParticlesNeighborWrangle : zeno::INode {
                 if constexpr (std::is_same_v<T, zeno::vec3f>) oss << "f3";
                 else if constexpr (std::is_same_v<T, float>) oss << "f1";
                 else oss << "unknown";
-            }, attr);
+            }, attr.read());
             oss << " @" << key << '\n';
         }
         for (auto const &[key, attr]: prim2->m_attrs) {
@@ -83,7 +83,7 @@ struct ParticlesNeighborWrangle : zeno::INode {
                 if constexpr (std::is_same_v<T, zeno::vec3f>) oss << "f3";
                 else if constexpr (std::is_same_v<T, float>) oss << "f1";
                 else oss << "unknown";
-            }, attr);
+            }, attr.read());
             oss << " @" << key << ":j" << '\n';
         }
 
@@ -141,8 +141,8 @@ struct ParticlesNeighborWrangle : zeno::INode {
             iob.which = chan[1][0] - 'i';
             chs[i] = iob;
         }
-        auto const &p1pos = prim1->attr<zeno::vec3f>("pos");
-        auto const &p2pos = prim2->attr<zeno::vec3f>("pos");
+        auto const &p1pos = prim1->read_attr<zeno::vec3f>("pos");
+        auto const &p2pos = prim2->read_attr<zeno::vec3f>("pos");
 
         auto pmin = p2pos[0], pmax = p2pos[0];
         for (int i = 1; i < p2pos.size(); i++) {
@@ -57,7 +57,7 @@ struct ParticleParticleWrangle : zeno::INode {
                 if constexpr (std::is_same_v<T, zeno::vec3f>) oss << "f3";
                 else if constexpr (std::is_same_v<T, float>) oss << "f1";
                 else oss << "unknown";
-            }, attr);
+            }, attr.read());
             oss << " @" << key << '\n';
         }
         for (auto const &[key, attr]: prim2->m_attrs) {
@@ -67,7 +67,7 @@ struct ParticleParticleWrangle : zeno::INode {
                 if constexpr (std::is_same_v<T, zeno::vec3f>) oss << "f3";
                 else if constexpr (std::is_same_v<T, float>) oss << "f1";
                 else oss << "unknown";
-            }, attr);
+            }, attr.read());
             oss << " @" << key << ":j" << '\n';
         }
 
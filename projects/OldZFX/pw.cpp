@@ -50,7 +50,7 @@ struct ParticlesWrangle : zeno::INode {
                 if constexpr (std::is_same_v<T, zeno::vec3f>) oss << "f3";
                 else if constexpr (std::is_same_v<T, float>) oss << "f1";
                 else oss << "unknown";
-            }, attr);
+            }, attr.read());
             oss << " @" << key << '\n';
         }
 
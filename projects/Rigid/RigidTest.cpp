@@ -2,6 +2,7 @@
 #include <zeno/ListObject.h>
 #include <zeno/NumericObject.h>
 #include <zeno/PrimitiveObject.h>
+#include <zeno/utils/zlog.h>
 #include <btBulletDynamicsCommon.h>
 #include <BulletCollision/CollisionShapes/btShapeHull.h>
 #include <BulletCollision/CollisionShapes/btConvexPointCloudShape.h>
@@ -12,8 +13,11 @@
 #include <hacdHACD.h>
 #include <memory>
 #include <vector>
+#include <set>
 
 
+static auto &rigidlog = zlog::module("rigid");
+
 struct BulletTransform : zeno::IObject {
     btTransform trans;
 };
@@ -24,6 +28,18 @@ struct BulletCollisionShape : zeno::IObject {
     BulletCollisionShape(std::unique_ptr<btCollisionShape> &&shape)
         : shape(std::move(shape)) {
     }
+
+    // bullet doesn't tell sizes, these are estimates by shape type
+    virtual size_t memoryUsage() const override {
+        size_t res = sizeof(*this);
+        if (auto hull = dynamic_cast<btConvexHullShape const *>(shape.get()))
+            res += sizeof(*hull) + hull->getNumPoints() * sizeof(btVector3);
+        else if (auto comp = dynamic_cast<btCompoundShape const *>(shape.get()))
+            res += sizeof(*comp) + comp->getNumChildShapes() * sizeof(btCompoundShapeChild);
+        else if (shape)
+            res += sizeof(btBoxShape);  // boxes and spheres
+        return res;
+    }
 };
 
 struct BulletCompoundShape : BulletCollisionShape {
@@ -37,6 +53,13 @@ struct BulletCompoundShape : BulletCollisionShape {
         comShape->addChildShape(trans, child->shape.get());
         children.push_back(std::move(child));
     }
+
+    virtual size_t memoryUsage() const override {
+        size_t res = BulletCollisionShape::memoryUsage();
+        for (auto const &child: children)
+            res += child->memoryUsage();
+        return res;
+    }
 };
 
 struct BulletMakeBoxShape : zeno::INode {
@@ -74,6 +97,12 @@ ZENDEFNODE(BulletMakeSphereShape, {
 
 struct BulletTriangleMesh : zeno::IObject {
     btTriangleMesh mesh;
+
+    virtual size_t memoryUsage() const override {
+        // addTriangle keeps 3 four-float vertices and 3 int indices
+        return sizeof(*this) + mesh.getNumTriangles() * 3
+            * (sizeof(btVector3) + sizeof(unsigned int));
+    }
 };
 
 struct PrimitiveToBulletMesh : zeno::INode {
@@ -138,11 +167,11 @@ struct PrimitiveConvexDecomposition : zeno::INode {
         auto listPrim = std::make_shared<zeno::ListObject>();
         listPrim->arr.clear();
 
-        printf("hacd got %d clusters\n", nClusters);
+        rigidlog.debug("hacd got {} clusters", nClusters);
         for (size_t c = 0; c < nClusters; c++) {
             size_t nPoints = hacd.GetNPointsCH(c);
             size_t nTriangles = hacd.GetNTrianglesCH(c);
-            printf("hacd cluster %d have %d points, %d triangles\n",
+            rigidlog.debug("hacd cluster {} have {} points, {} triangles",
                 c, nPoints, nTriangles);
 
             points.clear();
@@ -307,6 +336,11 @@ struct BulletObject : zeno::IObject {
         btRigidBody::btRigidBodyConstructionInfo rbInfo(mass, myMotionState.get(), colShape->shape.get(), localInertia);
         body = std::make_unique<btRigidBody>(rbInfo);
     }
+
+    virtual size_t memoryUsage() const override {
+        return sizeof(*this) + sizeof(btRigidBody) + sizeof(btDefaultMotionState)
+            + (colShape ? colShape->memoryUsage() : 0);
+    }
 };
 
 struct BulletMakeObject : zeno::INode {
@@ -435,6 +469,21 @@ struct BulletWorld : zeno::IObject {
         dynamicsWorld->setGravity(btVector3(0, -10, 0));
     }
 
+    virtual size_t memoryUsage() const override {
+        size_t res = sizeof(*this) + sizeof(btDefaultCollisionConfiguration)
+            + sizeof(btCollisionDispatcher) + sizeof(btDbvtBroadphase)
+            + sizeof(btSequentialImpulseConstraintSolver)
+            + sizeof(btDiscreteDynamicsWorld);
+        // objects often share a shape, count it once
+        std::set<BulletCollisionShape const *> shapes;
+        for (auto const &obj: objects) {
+            res += sizeof(*obj) + sizeof(btRigidBody) + sizeof(btDefaultMotionState);
+            if (obj->colShape && shapes.insert(obj->colShape.get()).second)
+                res += obj->colShape->memoryUsage();
+        }
+        return res;
+    }
+
     void addObject(std::shared_ptr<BulletObject> obj) {
         dynamicsWorld->addRigidBody(obj->body.get());
         objects.push_back(std::move(obj));
@@ -465,7 +514,7 @@ struct BulletWorld : zeno::IObject {
     }*/
 
     void step(float dt = 1.f / 60.f) {
-        std::cout<<dt<<std::endl;
+        rigidlog.trace("stepping world by {}", dt);
         for(int i=0;i<10;i++)
             dynamicsWorld->stepSimulation(0.1*dt, 1, 0.1*dt);
 
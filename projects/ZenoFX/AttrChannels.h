@@ -0,0 +1,109 @@
+#pragma once
+
+#include <zeno/types/PrimitiveObject.h>
+#include <functional>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace zeno {
+
+// dimension of an attribute as a zfx symbol
+inline int zfx_attr_dim(AttributeArray const &arr) {
+    return std::visit([] (auto const &v) -> int {
+        return is_vec_n<decltype(v[0])>;
+    }, arr);
+}
+
+// attributes defined by programs are floats, false for bad dimensions
+inline bool zfx_add_attr(PrimitiveObject *prim, std::string const &key, int dim) {
+    switch (dim) {
+    case 1: prim->add_attr<float>(key); return true;
+    case 2: prim->add_attr<vec2f>(key); return true;
+    case 3: prim->add_attr<vec3f>(key); return true;
+    case 4: prim->add_attr<vec4f>(key); return true;
+    default: return false;
+    }
+}
+
+// programs see channels as strided floats: float attributes are bound in
+// place, others through a float copy of the component, stored back by
+// commit() only where the program changed it, so that e.g. integers too
+// large for a float survive programs that just read them
+struct ZfxChannels {
+    std::map<std::pair<void const *, int>, std::vector<float>> m_staged;
+    std::vector<std::function<void()>> m_commits;
+
+    template <class Buffer>
+    void bind(Buffer &iob, AttributeArray &attr, int dimid) {
+        std::visit([&] (auto &arr) {
+            using T = std::decay_t<decltype(arr[0])>;
+            using S = decay_vec_t<T>;
+            iob.count = arr.size();
+            if constexpr (std::is_same_v<S, float>) {
+                iob.base = (float *)arr.data() + dimid;
+                iob.stride = sizeof(T) / sizeof(float);
+                return;
+            } else {
+                auto comp = [dimid] (auto &val) -> auto & {
+                    if constexpr (is_vec_v<T>) return val[dimid];
+                    else return val;
+                };
+                auto [it, fresh] = m_staged.try_emplace({&arr, dimid});
+                auto &data = it->second;
+                if (fresh) {
+                    data.resize(arr.size());
+                    for (size_t i = 0; i < arr.size(); i++)
+                        data[i] = (float)comp(arr[i]);
+                    m_commits.push_back([&arr, &data, comp] {
+                        for (size_t i = 0; i < arr.size(); i++)
+                            if (data[i] != (float)comp(arr[i]))
+                                comp(arr[i]) = attr_cast<S>(data[i]);
+                    });
+                }
+                iob.base = data.data();
+                iob.stride = 1;
+            }
+        }, attr);
+    }
+
+    // for channels only read by programs, like those of neighbors: never
+    // stored back, so shared buffers aren't copied
+    template <class Buffer>
+    void bind(Buffer &iob, AttributeArray const &attr, int dimid) {
+        std::visit([&] (auto const &arr) {
+            using T = std::decay_t<decltype(arr[0])>;
+            using S = decay_vec_t<T>;
+            iob.count = arr.size();
+            if constexpr (std::is_same_v<S, float>) {
+                iob.base = (float *)arr.data() + dimid;
+                iob.stride = sizeof(T) / sizeof(float);
+            } else {
+                // apart from the copies stored back, in case the same
+                // array is also bound for writing
+                auto [it, fresh] = m_staged.try_emplace({&arr, -1 - dimid});
+                auto &data = it->second;
+                if (fresh) {
+                    data.resize(arr.size());
+                    for (size_t i = 0; i < arr.size(); i++) {
+                        if constexpr (is_vec_v<T>)
+                            data[i] = (float)arr[i][dimid];
+                        else
+                            data[i] = (float)arr[i];
+                    }
+                }
+                iob.base = data.data();
+                iob.stride = 1;
+            }
+        }, attr);
+    }
+
+    void commit() {
+        for (auto const &fn: m_commits)
+            fn();
+        m_commits.clear();
+        m_staged.clear();
+    }
+};
+
+}
@@ -4,12 +4,17 @@
 #include <zeno/DictObject.h>
 #include <zfx/zfx.h>
 #include <zfx/x64.h>
+#include <zeno/utils/zlog.h>
 #include <cassert>
+#include <mutex>
 
 namespace {
 
 static zfx::Compiler compiler;
 static zfx::x64::Assembler assembler;
+// compiled programs are cached and their parameters set in place
+static std::mutex wrangle_mutex;
+static auto &zfxlog = zlog::module("zfx");
 
 static void numeric_wrangle
     ( zfx::x64::Executable *exec
@@ -27,6 +32,7 @@ static void numeric_wrangle
 
 struct NumericWrangle : zeno::INode {
     virtual void apply() override {
+        std::lock_guard lck(wrangle_mutex);
         auto code = get_input<zeno::StringObject>("zfxCode")->get();
 
         zfx::Options opts(zfx::Options::for_x64);
@@ -56,7 +62,7 @@ struct NumericWrangle : zeno::INode {
                     return 1;
                 } else return 0;
             }, par->value);
-            printf("define param: %s dim %d\n", key.c_str(), dim);
+            zfxlog.debug("define param: {} dim {}", key, dim);
             opts.define_param(key, dim);
         }
 
@@ -65,8 +71,7 @@ struct NumericWrangle : zeno::INode {
 
         auto result = std::make_shared<zeno::DictObject>();
         for (auto const &[name, dim]: prog->newsyms) {
-            printf("output numeric value: %s with dim %d\n",
-                    name.c_str(), dim);
+            zfxlog.debug("output numeric value: {} with dim {}", name, dim);
             assert(name[0] == '@');
             auto key = name.substr(1);
             zeno::NumericValue value;
@@ -79,7 +84,7 @@ struct NumericWrangle : zeno::INode {
             } else if (dim == 1) {
                 value = float{};
             } else {
-                printf("ERROR: bad output dimension for numeric: %d\n", dim);
+                zfxlog.error("bad output dimension for numeric: {}", dim);
                 abort();
             }
             result->lut[key] = std::make_shared<zeno::NumericObject>(value);
@@ -87,19 +92,19 @@ struct NumericWrangle : zeno::INode {
 
         for (int i = 0; i < prog->params.size(); i++) {
             auto [name, dimid] = prog->params[i];
-            printf("parameter %d: %s.%d\n", i, name.c_str(), dimid);
+            zfxlog.debug("parameter {}: {}.{}", i, name, dimid);
             assert(name[0] == '$');
             auto it = std::find(parnames.begin(),
                 parnames.end(), std::pair{name, dimid});
             auto value = parvals.at(it - parnames.begin());
-            printf("(valued %f)\n", value);
+            zfxlog.debug("(valued {})", value);
             exec->parameter(prog->param_id(name, dimid)) = value;
         }
 
         std::vector<float> chs(prog->symbols.size());
         for (int i = 0; i < chs.size(); i++) {
             auto [name, dimid] = prog->symbols[i];
-            printf("output %d: %s.%d\n", i, name.c_str(), dimid);
+            zfxlog.debug("output {}: {}.{}", i, name, dimid);
             assert(name[0] == '@');
         }
 
@@ -108,7 +113,7 @@ struct NumericWrangle : zeno::INode {
         for (int i = 0; i < chs.size(); i++) {
             auto [name, dimid] = prog->symbols[i];
             float value = chs[i];
-            printf("output %d: %s.%d = %f\n", i, name.c_str(), dimid, value);
+            zfxlog.debug("output {}: {}.{} = {}", i, name, dimid, value);
             auto key = name.substr(1);
             std::visit([dimid = dimid, value] (auto &res) {
                     dimid[(float *)(void *)&res] = value;
@@ -28,7 +28,7 @@ struct ParticlesFromPrimitive : zeno::INode {
                         }
                     }
                 }
-            }, attr);
+            }, attr.read());
         }
 
         set_output("pars", std::move(pars));
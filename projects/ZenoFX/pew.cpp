@@ -5,12 +5,18 @@
 #include <zeno/DictObject.h>
 #include <zfx/zfx.h>
 #include <zfx/x64.h>
+#include <zeno/utils/zlog.h>
+#include "AttrChannels.h"
 #include <cassert>
+#include <mutex>
 
 namespace {
 
 static zfx::Compiler compiler;
 static zfx::x64::Assembler assembler;
+// compiled programs are cached and their parameters set in place
+static std::mutex wrangle_mutex;
+static auto &zfxlog = zlog::module("zfx");
 
 struct Buffer {
     float *base = nullptr;
@@ -43,6 +49,7 @@ static void vectors_wrangle
 
 struct PrimitiveEdgeWrangle : zeno::INode {
     virtual void apply() override {
+        std::lock_guard lck(wrangle_mutex);
         auto prim = get_input<zeno::PrimitiveObject>("prim");
         auto edgePrim = get_input<zeno::PrimitiveObject>("edgePrim");
         auto code = get_input<zeno::StringObject>("zfxCode")->get();
@@ -50,25 +57,15 @@ struct PrimitiveEdgeWrangle : zeno::INode {
         zfx::Options opts(zfx::Options::for_x64);
         opts.detect_new_symbols = true;
         for (auto const &[key, attr]: prim->m_attrs) {
-            int dim = std::visit([] (auto const &v) {
-                using T = std::decay_t<decltype(v[0])>;
-                if constexpr (std::is_same_v<T, zeno::vec3f>) return 3;
-                else if constexpr (std::is_same_v<T, float>) return 1;
-                else return 0;
-            }, attr);
-            printf("define symbol: @1%s dim %d\n", key.c_str(), dim);
+            int dim = zeno::zfx_attr_dim(attr.read());
+            zfxlog.debug("define symbol: @1{} dim {}", key, dim);
             opts.define_symbol("@1" + key, dim);
-            printf("define symbol: @2%s dim %d\n", key.c_str(), dim);
+            zfxlog.debug("define symbol: @2{} dim {}", key, dim);
             opts.define_symbol("@2" + key, dim);
         }
         for (auto const &[key, attr]: edgePrim->m_attrs) {
-            int dim = std::visit([] (auto const &v) {
-                using T = std::decay_t<decltype(v[0])>;
-                if constexpr (std::is_same_v<T, zeno::vec3f>) return 3;
-                else if constexpr (std::is_same_v<T, float>) return 1;
-                else return 0;
-            }, attr);
-            printf("define symbol: @%s dim %d\n", key.c_str(), dim);
+            int dim = zeno::zfx_attr_dim(attr.read());
+            zfxlog.debug("define symbol: @{} dim {}", key, dim);
             opts.define_symbol('@' + key, dim);
         }
 
@@ -96,7 +93,7 @@ struct PrimitiveEdgeWrangle : zeno::INode {
                     return 1;
                 } else return 0;
             }, par->value);
-            printf("define param: %s dim %d\n", key.c_str(), dim);
+            zfxlog.debug("define param: {} dim {}", key, dim);
             opts.define_param(key, dim);
         }
 
@@ -104,8 +101,7 @@ struct PrimitiveEdgeWrangle : zeno::INode {
         auto exec = assembler.assemble(prog->assembly);
 
         for (auto const &[name, dim]: prog->newsyms) {
-            printf("auto-defined new attribute: %s with dim %d\n",
-                    name.c_str(), dim);
+            zfxlog.debug("auto-defined new attribute: {} with dim {}", name, dim);
             assert(name[0] == '@');
             std::string key = name.substr(1);
             auto *primPtr = edgePrim.get();
@@ -113,13 +109,8 @@ struct PrimitiveEdgeWrangle : zeno::INode {
                 key = key.substr(1);
                 primPtr = prim.get();
             }
-            if (dim == 3) {
-                primPtr->add_attr<zeno::vec3f>(key);
-            } else if (dim == 1) {
-                primPtr->add_attr<float>(key);
-            } else {
-                printf("ERROR: bad attribute dimension for primitive: %d\n",
-                    dim);
+            if (!zeno::zfx_add_attr(primPtr, key, dim)) {
+                zfxlog.error("bad attribute dimension for primitive: {}", dim);
                 abort();
             }
         }
@@ -128,19 +119,20 @@ struct PrimitiveEdgeWrangle : zeno::INode {
 
         for (int i = 0; i < prog->params.size(); i++) {
             auto [name, dimid] = prog->params[i];
-            printf("parameter %d: %s.%d\n", i, name.c_str(), dimid);
+            zfxlog.debug("parameter {}: {}.{}", i, name, dimid);
             assert(name[0] == '$');
             auto it = std::find(parnames.begin(),
                 parnames.end(), std::pair{name, dimid});
             auto value = parvals.at(it - parnames.begin());
-            printf("(valued %f)\n", value);
+            zfxlog.debug("(valued {})", value);
             exec->parameter(prog->param_id(name, dimid)) = value;
         }
 
+        zeno::ZfxChannels channels;
         std::vector<Buffer> chs(prog->symbols.size());
         for (int i = 0; i < chs.size(); i++) {
             auto [name, dimid] = prog->symbols[i];
-            printf("channel %d: %s.%d\n", i, name.c_str(), dimid);
+            zfxlog.debug("channel {}: {}.{}", i, name, dimid);
             assert(name[0] == '@');
             Buffer iob;
             zeno::PrimitiveObject *primPtr;
@@ -153,16 +145,12 @@ struct PrimitiveEdgeWrangle : zeno::INode {
                 name = name.substr(1);
                 primPtr = edgePrim.get();
             }
-            auto const &attr = primPtr->attr(name);
-            std::visit([&, dimid_ = dimid] (auto const &arr) {
-                iob.base = (float *)arr.data() + dimid_;
-                iob.count = arr.size();
-                iob.stride = sizeof(arr[0]) / sizeof(float);
-            }, attr);
+            channels.bind(iob, primPtr->attr(name), dimid);
             chs[i] = iob;
         }
 
         vectors_wrangle(exec, chs, prim->lines);
+        channels.commit();
 
         set_output("prim", std::move(prim));
         set_output("edgePrim", std::move(edgePrim));
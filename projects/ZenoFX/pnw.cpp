@@ -5,12 +5,19 @@
 #include <zeno/DictObject.h>
 #include <zfx/zfx.h>
 #include <zfx/x64.h>
+#include <zeno/utils/parallel.h>
+#include <zeno/utils/zlog.h>
+#include "AttrChannels.h"
 #include <cassert>
+#include <mutex>
 
 namespace {
 
 static zfx::Compiler compiler;
 static zfx::x64::Assembler assembler;
+// compiled programs are cached and their parameters set in place
+static std::mutex wrangle_mutex;
+static auto &zfxlog = zlog::module("zfx");
 
 struct Buffer {
     float *base = nullptr;
@@ -69,12 +76,12 @@ struct HashGrid : zeno::IObject {
         pMax += radius;
         gridRes = zeno::toint(zeno::floor((pMax - pMin) * inv_dx)) + 1;
 
-        printf("grid res: %dx%dx%d\n", gridRes[0], gridRes[1], gridRes[2]);
+        zfxlog.debug("grid res: {}x{}x{}", gridRes[0], gridRes[1], gridRes[2]);
         table.clear();
         table.resize(gridRes[0] * gridRes[1] * gridRes[2]);
 #else
         int table_size = refpos.size() / 8;
-        printf("table size: %d\n", table_size);
+        zfxlog.debug("table size: {}", table_size);
         table.clear();
         table.resize(table_size);
 #endif
@@ -137,8 +144,7 @@ static void vectors_wrangle
     if (chs.size() == 0)
         return;
 
-    #pragma omp parallel for
-    for (int i = 0; i < pos.size(); i++) {
+    zeno::parallel_for(pos.size(), [&] (size_t i) {
         auto ctx = exec->make_context();
         for (int k = 0; k < chs.size(); k++) {
             if (!chs[k].which)
@@ -155,7 +161,7 @@ static void vectors_wrangle
             if (!chs[k].which)
                 chs[k].base[chs[k].stride * i] = ctx.channel(k)[0];
         }
-    }
+    }, 64);  // each particle visits its neighbors
 }
 
 struct ParticlesBuildHashGrid : zeno::INode {
@@ -165,7 +171,7 @@ struct ParticlesBuildHashGrid : zeno::INode {
         float radiusMin = has_input("radiusMin") ?
             get_input<zeno::NumericObject>("radiusMin")->get<float>() : -1.f;
         auto hashgrid = std::make_shared<HashGrid>(
-                primNei->attr<zeno::vec3f>("pos"), radius, radiusMin);
+                primNei->read_attr<zeno::vec3f>("pos"), radius, radiusMin);
         set_output("hashGrid", std::move(hashgrid));
     }
 };
@@ -179,6 +185,7 @@ ZENDEFNODE(ParticlesBuildHashGrid, {
 
 struct ParticlesNeighborWrangle : zeno::INode {
     virtual void apply() override {
+        std::lock_guard lck(wrangle_mutex);
         auto prim = get_input<zeno::PrimitiveObject>("prim");
         auto primNei = get_input<zeno::PrimitiveObject>("primNei");
         auto hashgrid = get_input<HashGrid>("hashGrid");
@@ -187,23 +194,13 @@ struct ParticlesNeighborWrangle : zeno::INode {
         zfx::Options opts(zfx::Options::for_x64);
         opts.detect_new_symbols = true;
         for (auto const &[key, attr]: prim->m_attrs) {
-            int dim = std::visit([] (auto const &v) {
-                using T = std::decay_t<decltype(v[0])>;
-                if constexpr (std::is_same_v<T, zeno::vec3f>) return 3;
-                else if constexpr (std::is_same_v<T, float>) return 1;
-                else return 0;
-            }, attr);
-            printf("define symbol: @%s dim %d\n", key.c_str(), dim);
+            int dim = zeno::zfx_attr_dim(attr.read());
+            zfxlog.debug("define symbol: @{} dim {}", key, dim);
             opts.define_symbol('@' + key, dim);
         }
         for (auto const &[key, attr]: primNei->m_attrs) {
-            int dim = std::visit([] (auto const &v) {
-                using T = std::decay_t<decltype(v[0])>;
-                if constexpr (std::is_same_v<T, zeno::vec3f>) return 3;
-                else if constexpr (std::is_same_v<T, float>) return 1;
-                else return 0;
-            }, attr);
-            printf("define symbol: @@%s dim %d\n", key.c_str(), dim);
+            int dim = zeno::zfx_attr_dim(attr.read());
+            zfxlog.debug("define symbol: @@{} dim {}", key, dim);
             opts.define_symbol("@@" + key, dim);
         }
 
@@ -231,7 +228,7 @@ struct ParticlesNeighborWrangle : zeno::INode {
                     return 1;
                 } else return 0;
             }, par->value);
-            printf("define param: %s dim %d\n", key.c_str(), dim);
+            zfxlog.debug("define param: {} dim {}", key, dim);
             opts.define_param(key, dim);
         }
 
@@ -239,40 +236,34 @@ struct ParticlesNeighborWrangle : zeno::INode {
         auto exec = assembler.assemble(prog->assembly);
 
         for (auto const &[name, dim]: prog->newsyms) {
-            printf("auto-defined new attribute: %s with dim %d\n",
-                    name.c_str(), dim);
+            zfxlog.debug("auto-defined new attribute: {} with dim {}", name, dim);
             assert(name[0] == '@');
             if (name[1] == '@') {
-                printf("ERROR: cannot define new attribute %s on primNei\n",
-                        name.c_str());
+                zfxlog.error("cannot define new attribute {} on primNei", name);
             }
             auto key = name.substr(1);
-            if (dim == 3) {
-                prim->add_attr<zeno::vec3f>(key);
-            } else if (dim == 1) {
-                prim->add_attr<float>(key);
-            } else {
-                printf("ERROR: bad attribute dimension for primitive: %d\n",
-                    dim);
+            if (!zeno::zfx_add_attr(prim.get(), key, dim)) {
+                zfxlog.error("bad attribute dimension for primitive: {}", dim);
                 abort();
             }
         }
 
         for (int i = 0; i < prog->params.size(); i++) {
             auto [name, dimid] = prog->params[i];
-            printf("parameter %d: %s.%d\n", i, name.c_str(), dimid);
+            zfxlog.debug("parameter {}: {}.{}", i, name, dimid);
             assert(name[0] == '$');
             auto it = std::find(parnames.begin(),
                 parnames.end(), std::pair{name, dimid});
             auto value = parvals.at(it - parnames.begin());
-            printf("(valued %f)\n", value);
+            zfxlog.debug("(valued {})", value);
             exec->parameter(prog->param_id(name, dimid)) = value;
         }
 
+        zeno::ZfxChannels channels;
         std::vector<Buffer> chs(prog->symbols.size());
         for (int i = 0; i < chs.size(); i++) {
             auto [name, dimid] = prog->symbols[i];
-            printf("channel %d: %s.%d\n", i, name.c_str(), dimid);
+            zfxlog.debug("channel {}: {}.{}", i, name, dimid);
             assert(name[0] == '@');
             Buffer iob;
             zeno::PrimitiveObject *primPtr;
@@ -285,17 +276,16 @@ struct ParticlesNeighborWrangle : zeno::INode {
                 primPtr = prim.get();
                 iob.which = 0;
             }
-            auto const &attr = primPtr->attr(name);
-            std::visit([&, dimid_ = dimid] (auto const &arr) {
-                iob.base = (float *)arr.data() + dimid_;
-                iob.count = arr.size();
-                iob.stride = sizeof(arr[0]) / sizeof(float);
-            }, attr);
+            if (iob.which)  // neighbors are only read
+                channels.bind(iob, primPtr->read_attr(name), dimid);
+            else
+                channels.bind(iob, primPtr->attr(name), dimid);
             chs[i] = iob;
         }
 
-        vectors_wrangle(exec, chs, prim->attr<zeno::vec3f>("pos"),
+        vectors_wrangle(exec, chs, prim->read_attr<zeno::vec3f>("pos"),
                 hashgrid.get());
+        channels.commit();
 
         set_output("prim", std::move(prim));
     }
@@ -5,12 +5,24 @@
 #include <zeno/DictObject.h>
 #include <zfx/zfx.h>
 #include <zfx/x64.h>
+#include <zfx/utils.h>
+#include <zeno/utils/parallel.h>
+#include <zeno/utils/zlog.h>
+#include "AttrChannels.h"
 #include <cassert>
+#include <mutex>
 
 namespace {
 
 static zfx::Compiler compiler;
 static zfx::x64::Assembler assembler;
+// compiled programs are cached and their parameters set in place
+static std::mutex wrangle_mutex;
+static auto &zfxlog = zlog::module("zfx");
+// the compiler's own diagnostics, e.g. register spills
+static int defZfxLogHandler = (zfx::log_handler() = [] (std::string const &msg) {
+    zfxlog.debug("{}", msg);
+}, 1);
 
 struct Buffer {
     float *base = nullptr;
@@ -29,8 +41,9 @@ static void vectors_wrangle
         size = std::min(chs[i].count, size);
     }
 
-    #pragma omp parallel for
-    for (int i = 0; i < size - exec->SimdWidth + 1; i += exec->SimdWidth) {
+    size_t nsimd = size / exec->SimdWidth;
+    zeno::parallel_for(nsimd, [&] (size_t c) {
+        size_t i = c * exec->SimdWidth;
         auto ctx = exec->make_context();
         for (int j = 0; j < chs.size(); j++) {
             for (int k = 0; k < exec->SimdWidth; k++)
@@ -41,8 +54,8 @@ static void vectors_wrangle
             for (int k = 0; k < exec->SimdWidth; k++)
                  chs[j].base[chs[j].stride * (i + k)] = ctx.channel(j)[k];
         }
-    }
-    for (int i = size / exec->SimdWidth * exec->SimdWidth; i < size; i++) {
+    });
+    for (size_t i = nsimd * exec->SimdWidth; i < size; i++) {
         auto ctx = exec->make_context();
         for (int j = 0; j < chs.size(); j++) {
             ctx.channel(j)[0] = chs[j].base[chs[j].stride * i];
@@ -56,19 +69,15 @@ static void vectors_wrangle
 
 struct ParticlesWrangle : zeno::INode {
     virtual void apply() override {
+        std::lock_guard lck(wrangle_mutex);
         auto prim = get_input<zeno::PrimitiveObject>("prim");
         auto code = get_input<zeno::StringObject>("zfxCode")->get();
 
         zfx::Options opts(zfx::Options::for_x64);
         opts.detect_new_symbols = true;
         for (auto const &[key, attr]: prim->m_attrs) {
-            int dim = std::visit([] (auto const &v) {
-                using T = std::decay_t<decltype(v[0])>;
-                if constexpr (std::is_same_v<T, zeno::vec3f>) return 3;
-                else if constexpr (std::is_same_v<T, float>) return 1;
-                else return 0;
-            }, attr);
-            printf("define symbol: @%s dim %d\n", key.c_str(), dim);
+            int dim = zeno::zfx_attr_dim(attr.read());
+            zfxlog.debug("define symbol: @{} dim {}", key, dim);
             opts.define_symbol('@' + key, dim);
         }
 
@@ -96,7 +105,7 @@ struct ParticlesWrangle : zeno::INode {
                     return 1;
                 } else return 0;
             }, par->value);
-            printf("define param: %s dim %d\n", key.c_str(), dim);
+            zfxlog.debug("define param: {} dim {}", key, dim);
             opts.define_param(key, dim);
         }
 
@@ -104,47 +113,38 @@ struct ParticlesWrangle : zeno::INode {
         auto exec = assembler.assemble(prog->assembly);
 
         for (auto const &[name, dim]: prog->newsyms) {
-            printf("auto-defined new attribute: %s with dim %d\n",
-                    name.c_str(), dim);
+            zfxlog.debug("auto-defined new attribute: {} with dim {}", name, dim);
             assert(name[0] == '@');
             auto key = name.substr(1);
-            if (dim == 3) {
-                prim->add_attr<zeno::vec3f>(key);
-            } else if (dim == 1) {
-                prim->add_attr<float>(key);
-            } else {
-                printf("ERROR: bad attribute dimension for primitive: %d\n",
-                    dim);
+            if (!zeno::zfx_add_attr(prim.get(), key, dim)) {
+                zfxlog.error("bad attribute dimension for primitive: {}", dim);
                 abort();
             }
         }
 
         for (int i = 0; i < prog->params.size(); i++) {
             auto [name, dimid] = prog->params[i];
-            printf("parameter %d: %s.%d\n", i, name.c_str(), dimid);
+            zfxlog.debug("parameter {}: {}.{}", i, name, dimid);
             assert(name[0] == '$');
             auto it = std::find(parnames.begin(),
                 parnames.end(), std::pair{name, dimid});
             auto value = parvals.at(it - parnames.begin());
-            printf("(valued %f)\n", value);
+            zfxlog.debug("(valued {})", value);
             exec->parameter(prog->param_id(name, dimid)) = value;
         }
 
+        zeno::ZfxChannels channels;
         std::vector<Buffer> chs(prog->symbols.size());
         for (int i = 0; i < chs.size(); i++) {
             auto [name, dimid] = prog->symbols[i];
-            printf("channel %d: %s.%d\n", i, name.c_str(), dimid);
+            zfxlog.debug("channel {}: {}.{}", i, name, dimid);
             assert(name[0] == '@');
             Buffer iob;
-            auto const &attr = prim->attr(name.substr(1));
-            std::visit([&, dimid_ = dimid] (auto const &arr) {
-                iob.base = (float *)arr.data() + dimid_;
-                iob.count = arr.size();
-                iob.stride = sizeof(arr[0]) / sizeof(float);
-            }, attr);
+            channels.bind(iob, prim->attr(name.substr(1)), dimid);
             chs[i] = iob;
         }
         vectors_wrangle(exec, chs);
+        channels.commit();
 
         set_output("prim", std::move(prim));
     }
@@ -5,12 +5,17 @@
 #include <zeno/VDBGrid.h>
 #include <zfx/zfx.h>
 #include <zfx/x64.h>
+#include <zeno/utils/zlog.h>
 #include <cassert>
+#include <mutex>
 
 namespace {
 
 static zfx::Compiler compiler;
 static zfx::x64::Assembler assembler;
+// compiled programs are cached and their parameters set in place
+static std::mutex wrangle_mutex;
+static auto &zfxlog = zlog::module("zfx");
 
 struct Buffer {
     float *base = nullptr;
@@ -47,6 +52,7 @@ void vdb_wrangle(zfx::x64::Executable *exec, GridPtr &grid) {
 
 struct VDBWrangle : zeno::INode {
     virtual void apply() override {
+        std::lock_guard lck(wrangle_mutex);
         auto grid = get_input<zeno::VDBGrid>("grid");
         auto code = get_input<zeno::StringObject>("zfxCode")->get();
 
@@ -56,7 +62,7 @@ struct VDBWrangle : zeno::INode {
         else if (dynamic_cast<zeno::VDBFloat3Grid *>(grid.get()))
             opts.define_symbol("@val", 3);
         else
-            printf("unexpected vdb grid type");
+            zfxlog.error("unexpected vdb grid type");
         opts.reassign_channels = false;
 
         auto params = has_input("params") ?
@@ -93,11 +99,11 @@ struct VDBWrangle : zeno::INode {
         for (int i = 0; i < pars.size(); i++) {
             auto [name, dimid] = prog->params[i];
             assert(name[0] == '$');
-            printf("parameter %d: %s.%d\n", i, name.c_str(), dimid);
+            zfxlog.debug("parameter {}: {}.{}", i, name, dimid);
             auto it = std::find(parnames.begin(),
                 parnames.end(), std::pair{name, dimid});
             auto value = parvals.at(it - parnames.begin());
-            printf("(valued %f)\n", value);
+            zfxlog.debug("(valued {})", value);
             exec->parameter(prog->param_id(name, dimid)) = value;
         }
 
@@ -1,4 +1,7 @@
 #include "Render.h"
+#include <zeno/utils/zlog.h>
+
+static auto &meshlog = zlog::module("mesher");
 
 Render::Render() {}
 
@@ -6,14 +9,13 @@ Render::~Render() {}
 
 void Render::preprocess()
 {
-    std::cout << "*******************PreProcess***********************" << std::endl;
+    meshlog.debug("*******************PreProcess***********************");
     Mesh3D newframe(m_vtk_path, 0);
     clock_t start, end;
     start = clock();
     newframe.DualMeshTest();
     end = clock();
-    std::cout << "========DualMesh Done! total time elapsed:"
-              << (double)(end - start) / (double)CLOCKS_PER_SEC << "s" << std::endl;
+    meshlog.debug("========DualMesh Done! total time elapsed:{}s", (double)(end - start) / (double)CLOCKS_PER_SEC);
 
     // make a copy for debug purpose..
     vertices_copy.resize(newframe.num_of_vertices + newframe.num_of_tets * 4 + newframe.num_of_faces * 3 + newframe.num_of_edges * 2);
@@ -21,13 +23,12 @@ void Render::preprocess()
     {
         vertices_copy[k] = newframe.vertices[k];
     }
-    std::cout << "total pts num: " << vertices_copy.size() << std::endl;
+    meshlog.debug("total pts num: {}", vertices_copy.size());
 
     start = clock();
     CrackSmoothTest(newframe, max_smooth_iter_bound, max_smooth_iter_int);
     end = clock();
-    std::cout << "=========Crack Smooth Done! total time elapsed:"
-              << (double)(end - start) / (double)CLOCKS_PER_SEC << "s" << std::endl;
+    meshlog.debug("=========Crack Smooth Done! total time elapsed:{}s", (double)(end - start) / (double)CLOCKS_PER_SEC);
 
     // make a copy for debug purpose..
     vertices_initial.resize(
@@ -41,26 +42,25 @@ void Render::preprocess()
 
     WriteFile(newframe, "uncutmesh", 0);
 
-    std::cout << "done!" << std::endl;
+    meshlog.debug("done!");
 }
 
 void Render::process(int frame)
 {
-    std::cout << "************Rendering Frame " << frame << "************" << std::endl;
+    meshlog.debug("************Rendering Frame {}************", frame);
 
     clock_t start, end;
 
     start = clock();
 
-    std::cout << "Load File" << std::endl;
+    meshlog.debug("Load File");
     LoadFile(frame);
-    std::cout << "Load File done" << std::endl;
+    meshlog.debug("Load File done");
     Mesh3D &newframe = origmesh;
     newframe.UpdateVertices(old_points);
 
     end = clock();
-    std::cout << "Update Done! runtime:"
-              << (double)(end - start) / (double)CLOCKS_PER_SEC << "s" << std::endl;
+    meshlog.debug("Update Done! runtime:{}s", (double)(end - start) / (double)CLOCKS_PER_SEC);
 
     start = clock();
 
@@ -68,30 +68,26 @@ void Render::process(int frame)
     newframe.UpdateFaceBreak();
 
     end = clock();
-    std::cout << "Topology Update runtime:"
-              << (double)(end - start) / (double)CLOCKS_PER_SEC << "s" << std::endl;
+    meshlog.debug("Topology Update runtime:{}s", (double)(end - start) / (double)CLOCKS_PER_SEC);
 
     start = clock();
 
     UpdateCoreF(newframe, frame);
 
     end = clock();
-    std::cout << "F runtime:" << (double)(end - start) / (double)CLOCKS_PER_SEC
-              << "s" << std::endl;
+    meshlog.debug("F runtime:{}s", (double)(end - start) / (double)CLOCKS_PER_SEC);
 
     start = clock();
 
     Sewing(newframe);
 
     end = clock();
-    std::cout << "core vertices sewing runtime:"
-              << (double)(end - start) / CLOCKS_PER_SEC << "s" << std::endl;
+    meshlog.debug("core vertices sewing runtime:{}s", (double)(end - start) / CLOCKS_PER_SEC);
     
     start = clock();
     WriteFile(newframe, "mesh", frame);
     end = clock();
-    std::cout << "Write cut mesh done! runtime:"
-              << (double)(end - start) / CLOCKS_PER_SEC << "s" << std::endl;
+    meshlog.debug("Write cut mesh done! runtime:{}s", (double)(end - start) / CLOCKS_PER_SEC);
 }
 
 void Render::UpdateCoreF(Mesh3D &newmesh, int frame)
@@ -176,8 +172,7 @@ void Render::Sewing(Mesh3D &newmesh)
         }
     }
     end = clock();
-    std::cout << "Sewing Edge center done! runtime:"
-              << (double)(end - start) / CLOCKS_PER_SEC << "s" << std::endl;
+    meshlog.debug("Sewing Edge center done! runtime:{}s", (double)(end - start) / CLOCKS_PER_SEC);
 
     start = clock();
     for (size_t i = 0; i < newmesh.FacetList.size(); i++)
@@ -205,8 +200,7 @@ void Render::Sewing(Mesh3D &newmesh)
         }
     }
     end = clock();
-    std::cout << "Sewing Face center done! runtime:"
-              << (double)(end - start) / CLOCKS_PER_SEC << "s" << std::endl;
+    meshlog.debug("Sewing Face center done! runtime:{}s", (double)(end - start) / CLOCKS_PER_SEC);
 
     start = clock();
     int nv = newmesh.num_of_vertices;
@@ -277,8 +271,7 @@ void Render::Sewing(Mesh3D &newmesh)
         }
     }
     end = clock();
-    std::cout << "Sewing Tet center done! runtime:"
-              << (double)(end - start) / CLOCKS_PER_SEC << "s" << std::endl;
+    meshlog.debug("Sewing Tet center done! runtime:{}s", (double)(end - start) / CLOCKS_PER_SEC);
 }
 
 std::vector<int> FindCore(std::vector<int> &core, int core_id)
@@ -338,7 +331,7 @@ void Render::CrackSmoothTest(Mesh3D &origmesh, int max_bound, int max_int)
     for (int i = start_frame; i <= end_frame; i++)
     {
         LoadFile(i);
-        std::cout << i << std::endl;
+        meshlog.debug("{}", i);
         for (int j = 0; j < newmesh.num_of_edges; j++)
         {
             auto pe = newmesh.EdgetList[j];
@@ -359,14 +352,12 @@ void Render::CrackSmoothTest(Mesh3D &origmesh, int max_bound, int max_int)
     }
     newmesh.UpdateFaceBreak();
     end = clock();
-    std::cout << "run all frame done! runtime:"
-              << (double)(end - start) / (double)CLOCKS_PER_SEC << "s" << std::endl;
+    meshlog.debug("run all frame done! runtime:{}s", (double)(end - start) / (double)CLOCKS_PER_SEC);
 
     start = clock();
     ProcessOutput(newmesh);
     end = clock();
-    std::cout << "Process for output done! runtime:"
-              << (double)(end - start) / (double)CLOCKS_PER_SEC << "s" << std::endl;
+    meshlog.debug("Process for output done! runtime:{}s", (double)(end - start) / (double)CLOCKS_PER_SEC);
     std::vector<Facet *> &f = newmesh.FacetList;
     std::vector<Eigen::Vector3d> &vert = origmesh.vertices;
 
@@ -504,8 +495,7 @@ void Render::CrackSmoothTest(Mesh3D &origmesh, int max_bound, int max_int)
     }
 
     end = clock();
-    std::cout << "Smooth Boundary Done! runtime:"
-              << (double)(end - start) / (double)CLOCKS_PER_SEC << "s" << std::endl;
+    meshlog.debug("Smooth Boundary Done! runtime:{}s", (double)(end - start) / (double)CLOCKS_PER_SEC);
 
     /****************crack smooth interior surface********************/
     std::vector<Eigen::Vector4i> cut_list;
@@ -535,7 +525,7 @@ void Render::CrackSmoothTest(Mesh3D &origmesh, int max_bound, int max_int)
         }
     }
 
-    std::cout << "Constructed cutlist: " << cut_list.size() << std::endl;
+    meshlog.debug("Constructed cutlist: {}", cut_list.size());
 
     std::set<int> bound_list;
     for (size_t i = 0; i < newmesh.FacetList.size(); i++)
@@ -583,9 +573,7 @@ void Render::CrackSmoothTest(Mesh3D &origmesh, int max_bound, int max_int)
         }
     }
 
-    std::cout << "SurfaceSmoothener: Constructed vertex_neighbors with "
-              << vertex_neighbors.size() << " entries. Vertices have at most "
-              << max_neighbor_count << " neighbors. " << std::endl;
+    meshlog.debug("SurfaceSmoothener: Constructed vertex_neighbors with {} entries. Vertices have at most {} neighbors. ", vertex_neighbors.size(), max_neighbor_count);
 
     start = clock();
     double smooth_scale = 0;
@@ -626,8 +614,7 @@ void Render::CrackSmoothTest(Mesh3D &origmesh, int max_bound, int max_int)
     }
 
     end = clock();
-    std::cout << "Smooth Interior Done! runtime:"
-              << (double)(end - start) / (double)CLOCKS_PER_SEC << "s" << std::endl;
+    meshlog.debug("Smooth Interior Done! runtime:{}s", (double)(end - start) / (double)CLOCKS_PER_SEC);
 
     //=========================recover changed
     // data=================================//
@@ -1120,7 +1107,7 @@ void Render::ParametersIn(std::string cmd_input_path)
     infile.open("config.txt");
     if (!infile.is_open())
     {
-        std::cout << "Could Not Open File!!!";
+        meshlog.error("Could Not Open File!!!");
         exit(EXIT_FAILURE);
     }
 
@@ -1179,12 +1166,12 @@ void Render::ParametersIn(std::string cmd_input_path)
         if (st.compare("pid") == 0)
         {
             infile >> pid_min >> pid_max;
-            std::cout << "PID: [" << pid_min << " - " << pid_max << "]" << std::endl;
+            meshlog.debug("PID: [{} - {}]", pid_min, pid_max);
         }
 
         infile >> st;
     }
     if (infile.eof())
-        std::cout << "Parameters Loaded!!" << std::endl;
+        meshlog.debug("Parameters Loaded!!");
     infile.close();
 }
\ No newline at end of file
@@ -79,13 +79,13 @@ struct PrimitiveToSDF : zeno::INode{
     std::vector<openvdb::Vec3s> points;
     std::vector<openvdb::Vec3I> triangles;
     std::vector<openvdb::Vec4I> quads;
-    points.resize(mesh->attr<zeno::vec3f>("pos").size());
+    points.resize(mesh->read_attr<zeno::vec3f>("pos").size());
     triangles.resize(mesh->tris.size());
     quads.resize(0);
 #pragma omp parallel for
     for(int i=0;i<points.size();i++)
     {
-        points[i] = openvdb::Vec3s(mesh->attr<zeno::vec3f>("pos")[i][0], mesh->attr<zeno::vec3f>("pos")[i][1], mesh->attr<zeno::vec3f>("pos")[i][2]);
+        points[i] = openvdb::Vec3s(mesh->read_attr<zeno::vec3f>("pos")[i][0], mesh->read_attr<zeno::vec3f>("pos")[i][1], mesh->read_attr<zeno::vec3f>("pos")[i][2]);
     }
 #pragma omp parallel for
     for(int i=0;i<triangles.size();i++)
@@ -128,11 +128,11 @@ struct SDFToPoly : zeno::INode{
     std::vector<openvdb::Vec4I> quads(0);
     openvdb::tools::volumeToMesh(*(sdf->m_grid), points, tris, quads, isoValue, adaptivity, true);
     mesh->resize(points.size());
-    mesh->add_attr<zeno::vec3f>("pos");
+    auto &pos = mesh->add_attr_uninit<zeno::vec3f>("pos");
 #pragma omp parallel for
     for(size_t i=0;i<points.size();i++)
     {
-        mesh->attr<zeno::vec3f>("pos")[i] = zeno::vec3f(points[i][0],points[i][1],points[i][2]);
+        pos[i] = zeno::vec3f(points[i][0],points[i][1],points[i][2]);
     }
     mesh->tris.resize(tris.size() + 2*quads.size());
 #pragma omp parallel for
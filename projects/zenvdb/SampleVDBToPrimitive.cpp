@@ -60,12 +60,12 @@ struct SampleVDBToPrimitive : INode {
     auto prim = get_input<PrimitiveObject>("prim");
     auto grid = get_input<VDBGrid>("vdbGrid");
     auto attr = get_input<StringObject>("primAttr")->get();
-    auto &pos = prim->attr<vec3f>("pos");
+    auto const &pos = prim->read_attr<vec3f>("pos");
 
     if (dynamic_cast<VDBFloatGrid *>(grid.get()))
-        prim->add_attr<float>(attr);
+        prim->add_attr_uninit<float>(attr);
     else if (dynamic_cast<VDBFloat3Grid *>(grid.get()))
-        prim->add_attr<vec3f>(attr);
+        prim->add_attr_uninit<vec3f>(attr);
     else
         printf("unknown vdb grid type\n");
 
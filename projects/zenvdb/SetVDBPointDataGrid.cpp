@@ -87,15 +87,15 @@ struct PrimToVDBPointDataGrid : zeno::INode {
     }
     auto prims = get_input("ParticleGeo")->as<PrimitiveObject>();
     auto particles = std::make_unique<ParticlesObject>();
-    particles->pos.resize(prims->attr<zeno::vec3f>("pos").size());
-    particles->vel.resize(prims->attr<zeno::vec3f>("pos").size());
+    particles->pos.resize(prims->read_attr<zeno::vec3f>("pos").size());
+    particles->vel.resize(prims->read_attr<zeno::vec3f>("pos").size());
     #pragma omp parallel for
-    for(int i=0;i<prims->attr<zeno::vec3f>("pos").size();i++)
+    for(int i=0;i<prims->read_attr<zeno::vec3f>("pos").size();i++)
     {
-        particles->pos[i] = zeno::vec_to_other<glm::vec3>(prims->attr<zeno::vec3f>("pos")[i]);
+        particles->pos[i] = zeno::vec_to_other<glm::vec3>(prims->read_attr<zeno::vec3f>("pos")[i]);
         particles->vel[i] = glm::vec3(0,0,0);
         if(prims->has_attr("vel"))
-            particles->vel[i] = zeno::vec_to_other<glm::vec3>(prims->attr<zeno::vec3f>("vel")[i]);
+            particles->vel[i] = zeno::vec_to_other<glm::vec3>(prims->read_attr<zeno::vec3f>("vel")[i]);
     }
     auto data = zeno::IObject::make<VDBPointsGrid>();
     data->m_grid = particleArrayToGrid(particles.get(), dx);
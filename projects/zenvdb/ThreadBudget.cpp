@@ -0,0 +1,12 @@
+#include <zeno/utils/ThreadPool.h>
+#include <tbb/global_control.h>
+
+namespace {
+
+// OpenVDB tools run on TBB's own workers, keep them within zeno's thread
+// budget as long as this extension is loaded
+static tbb::global_control budget(
+        tbb::global_control::max_allowed_parallelism,
+        zeno::getThreadBudget());
+
+}
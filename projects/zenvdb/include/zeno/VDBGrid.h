@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <zeno/zeno.h>
+#include <zeno/utils/zlog.h>
 
 #include <openvdb/points/PointCount.h>
 #include <openvdb/tree/LeafManager.h>
@@ -13,6 +14,8 @@
 #include <string.h>
 namespace zeno {
 
+static auto &vdblog = zlog::module("vdb");
+
 template <typename GridT>
 typename GridT::Ptr readFloatGrid(const std::string &fn) {
   openvdb::io::File file(fn);
@@ -28,16 +31,15 @@ typename GridT::Ptr readFloatGrid(const std::string &fn) {
       grid = openvdb::gridPtrCast<GridT>(*iter);
       count++;
       /// display meta data
-      for (openvdb::MetaMap::MetaIterator it = grid->beginMeta();
-           it != grid->endMeta(); ++it) {
-        const std::string &name = it->first;
-        openvdb::Metadata::Ptr value = it->second;
-        std::string valueAsString = value->str();
-        std::cout << name << " = " << valueAsString << std::endl;
+      if (vdblog.enabled(zlog::LogLevel::debug)) {
+        for (openvdb::MetaMap::MetaIterator it = grid->beginMeta();
+             it != grid->endMeta(); ++it) {
+          vdblog.debug("{} = {}", it->first, it->second->str());
+        }
       }
     }
   }
-  std::cout << "count = " << count << std::endl;
+  vdblog.debug("{}: {} grids", fn, count);
   return grid;
 }
 
@@ -102,6 +104,10 @@ struct VDBGridWrapper : VDBGrid {
       openvdb::tools::NearestNeighbors::NN_FACE_EDGE_VERTEX);
   }
 
+  virtual size_t memoryUsage() const override {
+    return sizeof(*this) + m_grid->memUsage();
+  }
+
   virtual std::string getType() {
     if (std::is_same<GridT, openvdb::FloatGrid>::value) {
       return std::string("FloatGrid");
@@ -121,6 +127,10 @@ struct VDBGridWrapper : VDBGrid {
 
 struct TBBConcurrentIntArray : zeno::IObject {
   tbb::concurrent_vector<openvdb::Index32> m_data;
+
+  virtual size_t memoryUsage() const override {
+    return sizeof(*this) + m_data.capacity() * sizeof(openvdb::Index32);
+  }
 };
 
 using VDBFloatGrid = VDBGridWrapper<openvdb::FloatGrid>;
@@ -20,7 +20,7 @@ struct FishYields : zeno::INode {
             for (int i = 0, j = 0; j < arr.size(); i++, j += rate) {
                 arr[i] = arr[j];
             }
-        }, arr);
+        }, arr.write());
     }
     size_t new_size = stars->size() / rate;
     printf("fish yields new_size = %zd\n", new_size);
@@ -128,7 +128,7 @@ struct LinearOctree : zeno::INode {
             for (int i = 0; i < arr.size(); i++) {
                 arr[i] = tmparr[indices[i]];
             }
-        }, arr);
+        }, arr.write());
     }
 #endif
 
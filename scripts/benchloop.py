@@ -0,0 +1,61 @@
+#!/usr/bin/env python
+
+# writes a graph timing loop bodies in a large graph: a BeginFor of
+# `iterations` around a one-node body, then a chain of `chain` nodes
+# applied after the loop, the last one VIEWed; e.g.
+#   python scripts/benchloop.py > /tmp/bench.zsg
+#   zenorun /tmp/bench.zsg 1 /tmp/bench
+
+import sys
+import json
+import argparse
+
+
+def node(name, inputs, params, uipos, options=()):
+    inputs = dict(inputs)
+    inputs.update({'SRC': None, 'COND': None})
+    return {
+        'name': name,
+        'inputs': inputs,
+        'params': params,
+        'uipos': list(uipos),
+        'options': list(options),
+    }
+
+
+def make_graph(iterations, chain):
+    # only nodes and sockets that zeno had before loop lists and parallel
+    # loops, so that timings can be compared with older versions
+    nodes = {}
+    nodes['count'] = node('NumericInt', {}, {'value': iterations}, (-600, 0))
+    nodes['one'] = node('NumericInt', {}, {'value': 1}, (-600, 150))
+    nodes['for'] = node('BeginFor', {'count': ['count', 'value']},
+            {}, (-350, 0))
+    nodes['add'] = node('NumericOperator', {'lhs': ['for', 'index'],
+            'rhs': ['one', 'value']}, {'op_type': 'add'}, (-100, 50))
+    nodes['endfor'] = node('EndFor', {'FOR': ['for', 'FOR']}, {}, (150, 0))
+    nodes['endfor']['inputs']['SRC'] = ['add', 'DST']
+    last = ['one', 'value']
+    for i in range(chain):
+        ident = 'chain%04d' % i
+        options = ['VIEW'] if i == chain - 1 else []
+        uipos = (400 + 250 * (i % 40), 150 * (i // 40))
+        nodes[ident] = node('NumericOperator', {'lhs': last,
+                'rhs': ['one', 'value']}, {'op_type': 'add'}, uipos, options)
+        if i == 0:
+            nodes[ident]['inputs']['SRC'] = ['endfor', 'DST']
+        last = [ident, 'ret']
+    return {'graph': {'main': {'nodes': nodes}}}
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('-n', '--iterations', type=int, default=100000)
+    parser.add_argument('-c', '--chain', type=int, default=2000)
+    args = parser.parse_args()
+    json.dump(make_graph(args.iterations, args.chain), sys.stdout, indent=4)
+    sys.stdout.write('\n')
+
+
+if __name__ == '__main__':
+    main()
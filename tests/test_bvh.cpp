@@ -0,0 +1,151 @@
+#include <catch2/catch.hpp>
+#include <zeno/zeno.h>
+#include <zeno/types/BVHObject.h>
+#include <zeno/types/PrimitiveObject.h>
+#include <random>
+#include <cmath>
+
+// a closed cube of side 2 around the origin, n by n quads per face split
+// in triangles, outward facing
+static void make_cube(zeno::PrimitiveObject &prim, int n) {
+    auto &pos = prim.add_attr<zeno::vec3f>("pos");
+    for (int axis = 0; axis < 3; axis++) {
+        for (int side = -1; side <= 1; side += 2) {
+            int base = pos.size();
+            for (int j = 0; j <= n; j++) {
+                for (int i = 0; i <= n; i++) {
+                    zeno::vec3f p;
+                    p[axis] = side;
+                    p[(axis + 1) % 3] = -1 + 2.f * i / n;
+                    p[(axis + 2) % 3] = -1 + 2.f * j / n;
+                    pos.push_back(p);
+                }
+            }
+            for (int j = 0; j < n; j++) {
+                for (int i = 0; i < n; i++) {
+                    int a = base + j * (n + 1) + i, b = a + 1;
+                    int c = a + n + 1, d = c + 1;
+                    if (side > 0) {
+                        prim.tris.emplace_back(a, b, d);
+                        prim.tris.emplace_back(a, d, c);
+                    } else {
+                        prim.tris.emplace_back(a, d, b);
+                        prim.tris.emplace_back(a, c, d);
+                    }
+                }
+            }
+        }
+    }
+    prim.m_size = pos.size();
+}
+
+TEST_CASE("bvh queries match brute force", "[bvh]") {
+    zeno::PrimitiveObject mesh;
+    make_cube(mesh, 24);
+    zeno::BVHObject bvh;
+    bvh.build(&mesh, zeno::BVHObject::Tris);
+    REQUIRE(bvh.size() == mesh.tris.size());
+    REQUIRE(bvh.nodes.size() < 2 * mesh.tris.size());
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> uni(-2, 2);
+    for (int k = 0; k < 200; k++) {
+        zeno::vec3f p(uni(rng), uni(rng), uni(rng));
+
+        // the nearest point is on the cube's surface
+        auto res = bvh.nearest(p);
+        auto a = zeno::abs(p);
+        float inside = 1 - std::max({a[0], a[1], a[2]});
+        auto o = zeno::max(a - 1, zeno::vec3f(0));
+        float expect = inside > 0 ? inside : zeno::length(o);
+        REQUIRE(res.id >= 0);
+        REQUIRE(res.dist == Approx(expect).margin(1e-4));
+
+        // the far field approximation is off by a few percent near faces
+        float w = bvh.winding(p);
+        REQUIRE(w == Approx(inside > 0 ? 1 : 0).margin(0.05));
+        REQUIRE(bvh.winding(p, 1e9f) == Approx(inside > 0 ? 1 : 0).margin(1e-3));
+    }
+
+    // rays from inside all hit the far side at the expected distance
+    auto hit = bvh.intersect(zeno::vec3f(0.5f, 0.1f, 0.2f), zeno::vec3f(-1, 0, 0));
+    REQUIRE(hit.id >= 0);
+    REQUIRE(hit.t == Approx(1.5f));
+    auto miss = bvh.intersect(zeno::vec3f(0, 3, 0), zeno::vec3f(0, 1, 0));
+    REQUIRE(miss.id == -1);
+    REQUIRE(bvh.intersect(zeno::vec3f(0, 3, 0), zeno::vec3f(0, -1, 0), 1.5f).id == -1);
+
+    // refit follows the moved vertices, a new topology is refused
+    for (auto &p: mesh.attr<zeno::vec3f>("pos"))
+        p = p * 2.f + zeno::vec3f(10, 0, 0);
+    REQUIRE(bvh.refit(&mesh));
+    REQUIRE(bvh.nearest(zeno::vec3f(10, 0, 0)).dist == Approx(2));
+    REQUIRE(bvh.winding(zeno::vec3f(11, 1, 1)) == Approx(1).margin(0.05));
+    REQUIRE(bvh.winding(zeno::vec3f(0, 0, 0)) == Approx(0).margin(0.05));
+    mesh.tris.pop_back();
+    REQUIRE(!bvh.refit(&mesh));
+}
+
+TEST_CASE("bvh rays missing a leaf's triangles", "[bvh]") {
+    // through the triangle's box, but past its hypotenuse
+    zeno::PrimitiveObject tri;
+    tri.add_attr<zeno::vec3f>("pos") = {{0, 0, 0}, {1, 0, 0}, {0, 1, 0}};
+    tri.m_size = 3;
+    tri.tris.emplace_back(0, 1, 2);
+    zeno::BVHObject bvh;
+    bvh.build(&tri, zeno::BVHObject::Tris);
+    auto miss = bvh.intersect(zeno::vec3f(0.9f, 0.9f, 1), zeno::vec3f(0, 0, -1));
+    REQUIRE(miss.id == -1);
+    REQUIRE(std::isinf(miss.t));
+    auto hit = bvh.intersect(zeno::vec3f(0.2f, 0.2f, 1), zeno::vec3f(0, 0, -1));
+    REQUIRE(hit.id == 0);
+    REQUIRE(hit.t == Approx(1));
+}
+
+TEST_CASE("bvh over points", "[bvh]") {
+    zeno::PrimitiveObject cloud;
+    cloud.resize(20000);
+    auto &pos = cloud.add_attr<zeno::vec3f>("pos");
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> uni(0, 1);
+    for (auto &p: pos)
+        p = zeno::vec3f(uni(rng), uni(rng), uni(rng));
+    zeno::BVHObject bvh;
+    bvh.build(&cloud, zeno::BVHObject::Points);
+    REQUIRE(bvh.size() == pos.size());
+
+    for (int k = 0; k < 50; k++) {
+        zeno::vec3f q(uni(rng), uni(rng), uni(rng));
+        int best = 0, count = 0;
+        for (int i = 0; i < (int)pos.size(); i++) {
+            float d = zeno::length(pos[i] - q);
+            if (d < zeno::length(pos[best] - q))
+                best = i;
+            count += d < 0.05f;
+        }
+        REQUIRE(bvh.nearest(q).id == best);
+        REQUIRE(bvh.countWithin(q, 0.05f) == count);
+    }
+    REQUIRE(bvh.nearest(zeno::vec3f(5), 1).id == -1);
+}
+
+TEST_CASE("bvh nodes", "[bvh]") {
+    // distances from a 5^3 grid of points in the unit cube to the unit
+    // square at z = 0 are their heights
+    auto json = R"ZSL([["clearAllState"], ["switchGraph", "main"], ["addNode", "NumericInt", "n2"], ["setNodeParam", "n2", "value", 11], ["completeNode", "n2"], ["addNode", "NumericInt", "n3"], ["setNodeParam", "n3", "value", 5], ["completeNode", "n3"], ["addNode", "Make2DGridPrimitive", "grid"], ["bindNodeInput", "grid", "nx", "n2", "value"], ["setNodeParam", "grid", "isCentered", 0], ["setNodeParam", "grid", "hasFaces", 1], ["completeNode", "grid"], ["addNode", "Make3DGridPrimitive", "pts"], ["bindNodeInput", "pts", "nx", "n3", "value"], ["setNodeParam", "pts", "isCentered", 0], ["completeNode", "pts"], ["addNode", "PrimitiveBuildBVH", "bvh"], ["bindNodeInput", "bvh", "prim", "grid", "prim"], ["setNodeParam", "bvh", "type", "auto"], ["completeNode", "bvh"], ["addNode", "BVHNearestPoint", "near"], ["bindNodeInput", "near", "bvh", "bvh", "bvh"], ["bindNodeInput", "near", "prim", "pts", "prim"], ["setNodeParam", "near", "distAttr", "dist"], ["setNodeParam", "near", "posAttr", "nearestPos"], ["setNodeParam", "near", "idAttr", "nearestId"], ["completeNode", "near"], ["addNode", "SubOutput", "out"], ["bindNodeInput", "out", "port", "near", "prim"], ["setNodeParam", "out", "type", ""], ["setNodeParam", "out", "name", "output"], ["setNodeParam", "out", "defl", ""], ["completeNode", "out"]])ZSL";
+    auto scene = zeno::createScene();
+    scene->loadScene(json);
+    scene->switchGraph("main");
+    scene->getGraph().applyGraph();
+    auto prim = scene->getGraph().getGraphOutput<zeno::PrimitiveObject>("output");
+    REQUIRE(prim->size() == 125);
+    auto const &pos = prim->read_attr<zeno::vec3f>("pos");
+    auto const &dist = prim->read_attr<float>("dist");
+    auto const &near = prim->read_attr<zeno::vec3f>("nearestPos");
+    auto const &id = prim->read_attr<int>("nearestId");
+    for (size_t i = 0; i < pos.size(); i++) {
+        REQUIRE(dist[i] == Approx(pos[i][2]).margin(1e-5));
+        REQUIRE(near[i][2] == Approx(0).margin(1e-5));
+        REQUIRE(id[i] >= 0);
+    }
+}
@@ -0,0 +1,144 @@
+#include <catch2/catch.hpp>
+#include <zeno/zeno.h>
+#include <zeno/types/NumericObject.h>
+#include <zeno/types/PrimitiveObject.h>
+#include <zeno/extra/DiskCache.h>
+#include <zeno/utils/filesystem.h>
+
+namespace {
+
+int applies = 0;
+
+struct TestExpensivePrim : zeno::INode {
+    virtual void apply() override {
+        applies++;
+        int n = get_input<zeno::NumericObject>("n")->get<int>();
+        auto prim = std::make_shared<zeno::PrimitiveObject>();
+        prim->resize(n);
+        auto &pos = prim->add_attr<zeno::vec3f>("pos");
+        for (int i = 0; i < n; i++)
+            pos[i] = zeno::vec3f(i, 2 * i, 3 * i);
+        prim->tris.emplace_back(0, 1, 2);
+        set_output("prim", std::move(prim));
+    }
+};
+
+ZENDEFNODE(TestExpensivePrim, {
+    {"n"},
+    {"prim"},
+    {},
+    {"test"},
+});
+
+struct TestExpensiveSum : zeno::INode {
+    virtual void apply() override {
+        applies++;
+        auto prim = get_input<zeno::PrimitiveObject>("prim");
+        float sum = 0;
+        for (auto const &p: prim->read_attr<zeno::vec3f>("pos"))
+            sum += p[1];
+        set_output("sum", std::make_shared<zeno::NumericObject>(sum));
+    }
+};
+
+ZENDEFNODE(TestExpensiveSum, {
+    {"prim"},
+    {"sum"},
+    {},
+    {"test"},
+});
+
+}
+
+static std::shared_ptr<zeno::PrimitiveObject> runCached(int n) {
+    auto json = R"ZSL([["clearAllState"], ["switchGraph", "main"], ["addNode", "NumericInt", "n"], ["setNodeParam", "n", "value", 5], ["completeNode", "n"], ["addNode", "TestExpensivePrim", "prim"], ["bindNodeInput", "prim", "n", "n", "value"], ["setNodeOption", "prim", "CACHE"], ["completeNode", "prim"]])ZSL";
+    auto scene = zeno::createScene();  // as a new run would
+    scene->loadScene(json);
+    scene->switchGraph("main");
+    auto &graph = scene->getGraph();
+    graph.setNodeParam("n", "value", n);
+    graph.applyNodes({"prim"});
+    return zeno::safe_dynamic_cast<zeno::PrimitiveObject>(
+            graph.nodes.at("prim")->outputs.at("prim"));
+}
+
+TEST_CASE("disk cache across runs", "[cache]") {
+    auto &cache = zeno::getDiskCache();
+    auto dir = zeno::fs::temp_directory_path() / "zeno-test-cache";
+    zeno::fs::remove_all(dir);
+    cache.dir = dir.string();
+    applies = 0;
+
+    runCached(5);
+    REQUIRE(applies == 1);
+    auto prim = runCached(5);
+    REQUIRE(applies == 1);
+    REQUIRE(prim->size() == 5);
+    auto pos = prim->read_attr<zeno::vec3f>("pos")[4];
+    REQUIRE((pos[0] == 4 && pos[1] == 8 && pos[2] == 12));
+    REQUIRE(prim->tris.size() == 1);
+
+    runCached(6);  // input changed
+    REQUIRE(applies == 2);
+    runCached(5);
+    REQUIRE(applies == 2);
+
+    std::vector<size_t> sizes;
+    for (auto const &ent: zeno::fs::directory_iterator(dir))
+        sizes.push_back(ent.file_size());
+    REQUIRE(sizes.size() == 2);
+
+    // the entry of 6 is least recently used, and evicted to fit the other
+    auto budget = cache.budget;
+    cache.budget = std::min(sizes[0], sizes[1]);
+    cache.evict();
+    runCached(5);
+    REQUIRE(applies == 2);
+    runCached(6);
+    REQUIRE(applies == 3);
+    cache.budget = budget;
+    zeno::fs::remove_all(dir);
+}
+
+TEST_CASE("disk cache keys of large inputs", "[cache]") {
+    auto &cache = zeno::getDiskCache();
+    auto dir = zeno::fs::temp_directory_path() / "zeno-test-cache";
+    zeno::fs::remove_all(dir);
+    cache.dir = dir.string();
+    applies = 0;
+
+    // the input's pos is over the size whose digests are kept
+    auto json = R"ZSL([["clearAllState"], ["switchGraph", "main"], ["addNode", "NumericInt", "n"], ["setNodeParam", "n", "value", 10000], ["completeNode", "n"], ["addNode", "TestExpensivePrim", "prim"], ["bindNodeInput", "prim", "n", "n", "value"], ["completeNode", "prim"], ["addNode", "TestExpensiveSum", "sum"], ["bindNodeInput", "sum", "prim", "prim", "prim"], ["setNodeOption", "sum", "CACHE"], ["completeNode", "sum"]])ZSL";
+    auto scene = zeno::createScene();
+    scene->releaseOutputs = false;  // inputs kept for keying them below
+    scene->loadScene(json);
+    scene->switchGraph("main");
+    auto &graph = scene->getGraph();
+    auto run = [&] (int n) {
+        graph.setNodeParam("n", "value", n);
+        graph.applyNodes({"sum"});
+        return zeno::safe_dynamic_cast<zeno::NumericObject>(
+                graph.nodes.at("sum")->outputs.at("sum"))->get<float>();
+    };
+    float sum = run(10000);
+    REQUIRE(applies == 2);
+    REQUIRE(run(10000) == sum);
+    REQUIRE(applies == 3);  // the prim only
+    REQUIRE(run(10001) != sum);
+    REQUIRE(applies == 5);
+    REQUIRE(run(10000) == sum);
+    REQUIRE(applies == 6);
+
+    // digested storage isn't held, writing it in-place changes the key
+    auto prim = zeno::safe_dynamic_cast<zeno::PrimitiveObject>(
+            graph.nodes.at("prim")->outputs.at("prim"));
+    REQUIRE(!prim->m_attrs.at("pos").is_shared());
+    auto node = graph.nodes.at("sum").get();
+    auto key = cache.nodeKey(node);
+    REQUIRE(cache.nodeKey(node) == key);
+    auto data = prim->read_attr<zeno::vec3f>("pos").data();
+    prim->attr<zeno::vec3f>("pos")[5][1] += 1;
+    REQUIRE(prim->read_attr<zeno::vec3f>("pos").data() == data);
+    REQUIRE(cache.nodeKey(node) != key);
+    zeno::fs::remove_all(dir);
+}
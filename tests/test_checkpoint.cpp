@@ -0,0 +1,90 @@
+#include <catch2/catch.hpp>
+#include <zeno/zeno.h>
+#include <zeno/types/NumericObject.h>
+#include <zeno/types/PrimitiveObject.h>
+#include <zeno/extra/GlobalState.h>
+#include <zeno/extra/Checkpoint.h>
+#include <zeno/utils/filesystem.h>
+
+namespace {
+
+// advects the particles of a ONCE node in-place, as solvers do
+struct TestAdvect : zeno::INode {
+    virtual void apply() override {
+        auto prim = get_input<zeno::PrimitiveObject>("prim");
+        for (auto &p: prim->attr<zeno::vec3f>("pos"))
+            p[0] += 1;
+        set_output("prim", std::move(prim));
+    }
+};
+
+ZENDEFNODE(TestAdvect, {
+    {"prim"},
+    {"prim"},
+    {},
+    {"test"},
+});
+
+struct TestSeedPrim : zeno::INode {
+    virtual void apply() override {
+        auto prim = std::make_shared<zeno::PrimitiveObject>();
+        prim->resize(3);
+        prim->add_attr<zeno::vec3f>("pos");
+        set_output("prim", std::move(prim));
+    }
+};
+
+ZENDEFNODE(TestSeedPrim, {
+    {},
+    {"prim"},
+    {},
+    {"test"},
+});
+
+}
+
+static std::unique_ptr<zeno::Scene> loadSim() {
+    auto json = R"ZSL([["clearAllState"], ["switchGraph", "main"], ["addNode", "TestSeedPrim", "seed"], ["setNodeOption", "seed", "ONCE"], ["completeNode", "seed"], ["addNode", "TestAdvect", "adv"], ["bindNodeInput", "adv", "prim", "seed", "prim"], ["completeNode", "adv"], ["addNode", "PrimitiveTraceTrail", "trail"], ["bindNodeInput", "trail", "parsPrim", "adv", "prim"], ["completeNode", "trail"]])ZSL";
+    auto scene = zeno::createScene();
+    scene->loadScene(json);
+    scene->switchGraph("main");
+    return scene;
+}
+
+static void stepSim(zeno::Scene &scene) {
+    auto &state = *scene.globalState;
+    state.frameBegin();
+    while (state.substepBegin()) {
+        scene.getGraph().applyNodes({"trail"});
+        state.substepEnd();
+    }
+    state.frameEnd();
+}
+
+TEST_CASE("checkpoint and resume", "[checkpoint]") {
+    auto path = (zeno::fs::temp_directory_path() / "zeno-test.zckpt").string();
+    auto scene = loadSim();
+    for (int i = 0; i < 3; i++)
+        stepSim(*scene);
+    REQUIRE(zeno::saveCheckpoint(*scene, path));
+
+    auto resumed = loadSim();
+    zeno::loadCheckpoint(*resumed, path);
+    REQUIRE(resumed->globalState->frameid == 3);
+    REQUIRE(resumed->globalState->substepid == 3);
+    for (auto *s: {scene.get(), resumed.get()})
+        stepSim(*s);
+
+    auto result = [] (zeno::Scene &scene) {
+        return zeno::safe_dynamic_cast<zeno::PrimitiveObject>(
+                scene.getGraph().nodes.at("trail")->outputs.at("trailPrim"));
+    };
+    auto a = result(*scene), b = result(*resumed);
+    REQUIRE(b->size() == 12);
+    REQUIRE(b->lines.size() == a->lines.size());
+    auto &apos = a->attr<zeno::vec3f>("pos"), &bpos = b->attr<zeno::vec3f>("pos");
+    for (size_t i = 0; i < a->size(); i++)
+        REQUIRE(apos[i][0] == bpos[i][0]);
+    REQUIRE(bpos[11][0] == 4);  // advected 4 times, not restarted
+    zeno::fs::remove(path);
+}
@@ -0,0 +1,121 @@
+#include <catch2/catch.hpp>
+#include <zeno/zeno.h>
+#include <zeno/types/NumericObject.h>
+#include <zeno/types/ListObject.h>
+
+TEST_CASE("for loop", "[control]") {
+    // append the loop index to a list 5 times, then take its length;
+    // the list is created before the loop by binding it to BeginFor::SRC
+    auto json = R"ZSL([["clearAllState"], ["switchGraph", "main"], ["addNode", "NumericInt", "count"], ["setNodeParam", "count", "value", 5], ["completeNode", "count"], ["addNode", "EmptyList", "list"], ["completeNode", "list"], ["addNode", "BeginFor", "for"], ["bindNodeInput", "for", "count", "count", "value"], ["bindNodeInput", "for", "SRC", "list", "list"], ["completeNode", "for"], ["addNode", "AppendList", "append"], ["bindNodeInput", "append", "list", "list", "list"], ["bindNodeInput", "append", "object", "for", "index"], ["completeNode", "append"], ["addNode", "EndFor", "endfor"], ["bindNodeInput", "endfor", "FOR", "for", "FOR"], ["bindNodeInput", "endfor", "SRC", "append", "DST"], ["completeNode", "endfor"], ["addNode", "ListLength", "len"], ["bindNodeInput", "len", "list", "list", "list"], ["bindNodeInput", "len", "SRC", "endfor", "DST"], ["completeNode", "len"], ["addNode", "SubOutput", "out"], ["bindNodeInput", "out", "port", "len", "length"], ["setNodeParam", "out", "type", ""], ["setNodeParam", "out", "name", "output"], ["setNodeParam", "out", "defl", ""], ["completeNode", "out"]])ZSL";
+    auto scene = zeno::createScene();
+    scene->isIncremental = false;
+    scene->loadScene(json);
+    scene->switchGraph("main");
+    for (int frame = 0; frame < 2; frame++) {  // DST must survive releasing
+        scene->getGraph().applyGraph();
+        auto output = scene->getGraph().getGraphOutput<zeno::NumericObject>("output");
+        REQUIRE(output->get<int>() == 5);
+    }
+}
+
+TEST_CASE("parallel for loop", "[control]") {
+    // square each index concurrently, gathered into a list in order
+    auto json = R"ZSL([["clearAllState"], ["switchGraph", "main"], ["addNode", "NumericInt", "count"], ["setNodeParam", "count", "value", 64], ["completeNode", "count"], ["addNode", "BeginFor", "for"], ["bindNodeInput", "for", "count", "count", "value"], ["setNodeParam", "for", "parallel", 1], ["completeNode", "for"], ["addNode", "NumericOperator", "mul"], ["bindNodeInput", "mul", "lhs", "for", "index"], ["bindNodeInput", "mul", "rhs", "for", "index"], ["setNodeParam", "mul", "op_type", "mul"], ["completeNode", "mul"], ["addNode", "EndFor", "endfor"], ["bindNodeInput", "endfor", "FOR", "for", "FOR"], ["bindNodeInput", "endfor", "object", "mul", "ret"], ["completeNode", "endfor"], ["addNode", "SubOutput", "out"], ["bindNodeInput", "out", "port", "endfor", "list"], ["setNodeParam", "out", "type", ""], ["setNodeParam", "out", "name", "output"], ["setNodeParam", "out", "defl", ""], ["completeNode", "out"]])ZSL";
+    for (bool parallel: {false, true}) {
+        auto scene = zeno::createScene();
+        scene->isParallel = parallel;
+        scene->loadScene(json);
+        scene->switchGraph("main");
+        scene->getGraph().applyGraph();
+        auto list = scene->getGraph().getGraphOutput<zeno::ListObject>("output");
+        REQUIRE(list->arr.size() == 64);
+        for (int i = 0; i < 64; i++) {
+            auto num = zeno::safe_dynamic_cast<zeno::NumericObject>(list->arr[i]);
+            REQUIRE(num->get<int>() == i * i);
+        }
+    }
+}
+
+TEST_CASE("parallel for loop rejects shared writes", "[control]") {
+    // the serial `for loop` above, AppendList modifies the list in-place
+    auto json = R"ZSL([["clearAllState"], ["switchGraph", "main"], ["addNode", "NumericInt", "count"], ["setNodeParam", "count", "value", 5], ["completeNode", "count"], ["addNode", "EmptyList", "list"], ["completeNode", "list"], ["addNode", "BeginFor", "for"], ["bindNodeInput", "for", "count", "count", "value"], ["bindNodeInput", "for", "SRC", "list", "list"], ["setNodeParam", "for", "parallel", 1], ["completeNode", "for"], ["addNode", "AppendList", "append"], ["bindNodeInput", "append", "list", "list", "list"], ["bindNodeInput", "append", "object", "for", "index"], ["completeNode", "append"], ["addNode", "EndFor", "endfor"], ["bindNodeInput", "endfor", "FOR", "for", "FOR"], ["bindNodeInput", "endfor", "SRC", "append", "DST"], ["completeNode", "endfor"], ["addNode", "ListLength", "len"], ["bindNodeInput", "len", "list", "list", "list"], ["bindNodeInput", "len", "SRC", "endfor", "DST"], ["completeNode", "len"], ["addNode", "SubOutput", "out"], ["bindNodeInput", "out", "port", "len", "length"], ["setNodeParam", "out", "type", ""], ["setNodeParam", "out", "name", "output"], ["setNodeParam", "out", "defl", ""], ["completeNode", "out"]])ZSL";
+    auto scene = zeno::createScene();
+    scene->loadScene(json);
+    scene->switchGraph("main");
+    REQUIRE_THROWS_AS(scene->getGraph().applyGraph(), zeno::Exception);
+}
+
+namespace {
+
+// appends to its list in-place, but only outputs the new length
+struct TestAppendLength : zeno::INode {
+    virtual void apply() override {
+        auto list = get_input<zeno::ListObject>("list");
+        list->arr.push_back(get_input("object"));
+        set_output("length", std::make_shared<zeno::NumericObject>((int)list->arr.size()));
+    }
+};
+
+ZENDEFNODE(TestAppendLength, {
+    {"list", "object"},
+    {"length"},
+    {},
+    {"test"},
+});
+
+}
+
+TEST_CASE("parallel for loop copies outside inputs of non-pure nodes", "[control]") {
+    // each iteration appends to its own copy of the empty list
+    auto json = R"ZSL([["clearAllState"], ["switchGraph", "main"], ["addNode", "NumericInt", "count"], ["setNodeParam", "count", "value", 16], ["completeNode", "count"], ["addNode", "EmptyList", "list"], ["completeNode", "list"], ["addNode", "BeginFor", "for"], ["bindNodeInput", "for", "count", "count", "value"], ["setNodeParam", "for", "parallel", 1], ["completeNode", "for"], ["addNode", "TestAppendLength", "append"], ["bindNodeInput", "append", "list", "list", "list"], ["bindNodeInput", "append", "object", "for", "index"], ["completeNode", "append"], ["addNode", "EndFor", "endfor"], ["bindNodeInput", "endfor", "FOR", "for", "FOR"], ["bindNodeInput", "endfor", "object", "append", "length"], ["completeNode", "endfor"], ["addNode", "SubOutput", "out"], ["bindNodeInput", "out", "port", "endfor", "list"], ["setNodeParam", "out", "type", ""], ["setNodeParam", "out", "name", "output"], ["setNodeParam", "out", "defl", ""], ["completeNode", "out"]])ZSL";
+    auto scene = zeno::createScene();
+    scene->loadScene(json);
+    scene->switchGraph("main");
+    scene->getGraph().applyGraph();
+    auto list = scene->getGraph().getGraphOutput<zeno::ListObject>("output");
+    REQUIRE(list->arr.size() == 16);
+    for (auto const &obj: list->arr)
+        REQUIRE(zeno::safe_dynamic_cast<zeno::NumericObject>(obj)->get<int>() == 1);
+    auto outside = scene->getGraph().nodes.at("list")->outputs.at("list");
+    REQUIRE(zeno::safe_dynamic_cast<zeno::ListObject>(outside)->arr.empty());
+}
+
+TEST_CASE("nested for loops", "[control]") {
+    // the inner loop appends 4 times per outer iteration, 3 * 4 in total
+    auto json = R"ZSL([["clearAllState"], ["switchGraph", "main"], ["addNode", "NumericInt", "n3"], ["setNodeParam", "n3", "value", 3], ["completeNode", "n3"], ["addNode", "NumericInt", "n4"], ["setNodeParam", "n4", "value", 4], ["completeNode", "n4"], ["addNode", "EmptyList", "list"], ["completeNode", "list"], ["addNode", "BeginFor", "outer"], ["bindNodeInput", "outer", "count", "n3", "value"], ["bindNodeInput", "outer", "SRC", "list", "list"], ["completeNode", "outer"], ["addNode", "BeginFor", "inner"], ["bindNodeInput", "inner", "count", "n4", "value"], ["bindNodeInput", "inner", "SRC", "outer", "index"], ["completeNode", "inner"], ["addNode", "AppendList", "append"], ["bindNodeInput", "append", "list", "list", "list"], ["bindNodeInput", "append", "object", "inner", "index"], ["completeNode", "append"], ["addNode", "EndFor", "endinner"], ["bindNodeInput", "endinner", "FOR", "inner", "FOR"], ["bindNodeInput", "endinner", "SRC", "append", "DST"], ["completeNode", "endinner"], ["addNode", "EndFor", "endouter"], ["bindNodeInput", "endouter", "FOR", "outer", "FOR"], ["bindNodeInput", "endouter", "SRC", "endinner", "DST"], ["completeNode", "endouter"], ["addNode", "ListLength", "len"], ["bindNodeInput", "len", "list", "list", "list"], ["bindNodeInput", "len", "SRC", "endouter", "DST"], ["completeNode", "len"], ["addNode", "SubOutput", "out"], ["bindNodeInput", "out", "port", "len", "length"], ["setNodeParam", "out", "type", ""], ["setNodeParam", "out", "name", "output"], ["setNodeParam", "out", "defl", ""], ["completeNode", "out"]])ZSL";
+    auto scene = zeno::createScene();
+    scene->isIncremental = false;
+    scene->loadScene(json);
+    scene->switchGraph("main");
+    scene->getGraph().applyGraph();
+    auto output = scene->getGraph().getGraphOutput<zeno::NumericObject>("output");
+    REQUIRE(output->get<int>() == 12);
+}
+
+// x * x in subgraph `sq`, called by two Subgraph nodes and a parallel loop
+static const char *sub_json = R"ZSL([["clearAllState"], ["switchGraph", "sq"], ["addNode", "SubInput", "x"], ["setNodeParam", "x", "type", ""], ["setNodeParam", "x", "name", "x"], ["setNodeParam", "x", "defl", ""], ["completeNode", "x"], ["addNode", "NumericOperator", "mul"], ["bindNodeInput", "mul", "lhs", "x", "port"], ["bindNodeInput", "mul", "rhs", "x", "port"], ["setNodeParam", "mul", "op_type", "mul"], ["completeNode", "mul"], ["addNode", "SubOutput", "y"], ["bindNodeInput", "y", "port", "mul", "ret"], ["setNodeParam", "y", "type", ""], ["setNodeParam", "y", "name", "y"], ["setNodeParam", "y", "defl", ""], ["completeNode", "y"], ["switchGraph", "main"], ["addNode", "NumericInt", "a"], ["setNodeParam", "a", "value", 3], ["completeNode", "a"], ["addNode", "NumericInt", "b"], ["setNodeParam", "b", "value", 4], ["completeNode", "b"], ["addNode", "Subgraph", "sa"], ["setNodeParam", "sa", "name", "sq"], ["bindNodeInput", "sa", "x", "a", "value"], ["completeNode", "sa"], ["addNode", "Subgraph", "sb"], ["setNodeParam", "sb", "name", "sq"], ["bindNodeInput", "sb", "x", "b", "value"], ["completeNode", "sb"], ["addNode", "NumericOperator", "add"], ["bindNodeInput", "add", "lhs", "sa", "y"], ["bindNodeInput", "add", "rhs", "sb", "y"], ["setNodeParam", "add", "op_type", "add"], ["completeNode", "add"], ["addNode", "SubOutput", "out"], ["bindNodeInput", "out", "port", "add", "ret"], ["setNodeParam", "out", "type", ""], ["setNodeParam", "out", "name", "output"], ["setNodeParam", "out", "defl", ""], ["completeNode", "out"], ["addNode", "NumericInt", "count"], ["setNodeParam", "count", "value", 32], ["completeNode", "count"], ["addNode", "BeginFor", "for"], ["bindNodeInput", "for", "count", "count", "value"], ["setNodeParam", "for", "parallel", 1], ["completeNode", "for"], ["addNode", "Subgraph", "sf"], ["setNodeParam", "sf", "name", "sq"], ["bindNodeInput", "sf", "x", "for", "index"], ["completeNode", "sf"], ["addNode", "EndFor", "endfor"], ["bindNodeInput", "endfor", "FOR", "for", "FOR"], ["bindNodeInput", "endfor", "object", "sf", "y"], ["completeNode", "endfor"], ["addNode", "SubOutput", "outlist"], ["bindNodeInput", "outlist", "port", "endfor", "list"], ["setNodeParam", "outlist", "type", ""], ["setNodeParam", "outlist", "name", "list"], ["setNodeParam", "outlist", "defl", ""], ["completeNode", "outlist"]])ZSL";
+
+TEST_CASE("subgraph instances", "[control]") {
+    for (bool parallel: {false, true}) {
+        auto scene = zeno::createScene();
+        scene->isParallel = parallel;
+        scene->loadScene(sub_json);
+        scene->switchGraph("main");
+        auto &graph = scene->getGraph();
+        graph.applyGraph();
+        REQUIRE(graph.getGraphOutput<zeno::NumericObject>("output")->get<int>() == 25);
+        auto list = graph.getGraphOutput<zeno::ListObject>("list");
+        REQUIRE(list->arr.size() == 32);
+        for (int i = 0; i < 32; i++) {
+            auto num = zeno::safe_dynamic_cast<zeno::NumericObject>(list->arr[i]);
+            REQUIRE(num->get<int>() == i * i);
+        }
+        // the template has none of the callers' outputs
+        REQUIRE(!scene->getGraph("sq").nodes.at("mul")->outputs.count("ret"));
+
+        // x + x now, the callers pick up the edit
+        scene->getGraph("sq").setNodeParam("mul", "op_type", "add");
+        graph.applyGraph();
+        REQUIRE(graph.getGraphOutput<zeno::NumericObject>("output")->get<int>() == 14);
+    }
+}
@@ -0,0 +1,66 @@
+#ifdef ZENO_VISUALIZATION
+#include <catch2/catch.hpp>
+#include <zeno/zeno.h>
+#include <zeno/types/PrimitiveObject.h>
+#include <zeno/types/PrimitiveIO.h>
+#include <zeno/extra/Visualization.h>
+#include <zeno/extra/GlobalState.h>
+#include <zeno/core/Scene.h>
+#include <zeno/utils/filesystem.h>
+
+TEST_CASE("asynchronous export", "[visualization]") {
+    auto iopath = zeno::fs::temp_directory_path() / "zentest-export";
+    zeno::fs::remove_all(iopath);
+    zeno::fs::create_directories(iopath);
+    auto oldstate = zeno::state;
+    zeno::state = zeno::GlobalState();
+    zeno::state.setIOPath(iopath.string());
+
+    auto prim = std::make_shared<zeno::PrimitiveObject>();
+    prim->resize(1000);
+    prim->add_attr<float>("rad", 1.0f);
+    zeno::Visualization::exportObject(prim);
+    prim->attr<float>("rad")[0] = 2.0f;  // next frame modifies in-place
+    zeno::Visualization::endFrame();
+    zeno::Visualization::flushExports();
+
+    REQUIRE(zeno::fs::exists(iopath / "000000" / "done.lock"));
+    zeno::PrimitiveObject loaded;
+    zeno::readzpm(&loaded, (iopath / "000000" / "000000.zpm").string().c_str());
+    REQUIRE(loaded.size() == 1000);
+    REQUIRE(loaded.read_attr<float>("rad")[0] == 1.0f);
+
+    zeno::state = oldstate;
+    zeno::fs::remove_all(iopath);
+}
+
+TEST_CASE("VIEW objects are named after their nodes", "[visualization]") {
+    auto iopath = zeno::fs::temp_directory_path() / "zentest-export-names";
+    zeno::fs::remove_all(iopath);
+    zeno::fs::create_directories(iopath);
+
+    // applied concurrently, in whatever order
+    auto json = R"ZSL([["clearAllState"], ["switchGraph", "main"], ["addNode", "NumericInt", "n"], ["setNodeParam", "n", "value", 3], ["completeNode", "n"], ["addNode", "NumericInt", "m"], ["setNodeParam", "m", "value", 5], ["completeNode", "m"], ["addNode", "Make2DGridPrimitive", "a"], ["bindNodeInput", "a", "nx", "m", "value"], ["setNodeParam", "a", "isCentered", 0], ["setNodeParam", "a", "hasFaces", 0], ["setNodeOption", "a", "VIEW"], ["completeNode", "a"], ["addNode", "Make2DGridPrimitive", "b"], ["bindNodeInput", "b", "nx", "n", "value"], ["setNodeParam", "b", "isCentered", 0], ["setNodeParam", "b", "hasFaces", 0], ["setNodeOption", "b", "VIEW"], ["completeNode", "b"]])ZSL";
+    auto scene = zeno::createScene();
+    scene->loadScene(json);
+    scene->switchGraph("main");
+    auto &state = *scene->globalState;
+    state.setIOPath(iopath.string());
+    for (int i = 0; i < 2; i++)
+        scene->getGraph().applyNodes({"a", "b"});
+    zeno::Visualization::endFrame(state);
+    zeno::Visualization::flushExports();
+
+    auto dir = iopath / "000000";
+    auto size = [&] (std::string const &name) {
+        zeno::PrimitiveObject prim;
+        zeno::readzpm(&prim, (dir / name).string().c_str());
+        return prim.size();
+    };
+    REQUIRE(size("n000000.zpm") == 5 * 5);  // "a" compiles first
+    REQUIRE(size("n000000-1.zpm") == 5 * 5);
+    REQUIRE(size("n000001.zpm") == 3 * 3);
+    REQUIRE(size("n000001-1.zpm") == 3 * 3);
+    zeno::fs::remove_all(iopath);
+}
+#endif
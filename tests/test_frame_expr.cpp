@@ -0,0 +1,18 @@
+#include <catch2/catch.hpp>
+#include <zeno/extra/FrameExpr.h>
+
+TEST_CASE("frame expressions", "[frameexpr]") {
+    using zeno::evaluateFrameExpr;
+    REQUIRE(evaluateFrameExpr("out{frame:04d}.obj", 42) == "out0042.obj");
+    REQUIRE(evaluateFrameExpr("{frame * 2 + 1}", 3) == "7");
+    REQUIRE(evaluateFrameExpr("{frame / 2}", 3) == "1.5");
+    REQUIRE(evaluateFrameExpr("{frame // 4}", -1) == "-1");
+    REQUIRE(evaluateFrameExpr("{frame % 4}", -1) == "3");
+    REQUIRE(evaluateFrameExpr("{frame * 0.1:.2f}", 3) == "0.30");
+    REQUIRE(evaluateFrameExpr("{frame / 1}", 2) == "2.0");
+    REQUIRE(evaluateFrameExpr("{{frame}}", 2) == "{frame}");
+    REQUIRE(evaluateFrameExpr("{max(frame - 5, 0)}", 2) == "0");
+    // python-only expressions are passed through, like zenqt's evaluateExpr
+    REQUIRE(evaluateFrameExpr("{os.getcwd()}", 2) == "{os.getcwd()}");
+    REQUIRE(evaluateFrameExpr("{frame", 2) == "{frame");
+}
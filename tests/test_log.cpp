@@ -0,0 +1,57 @@
+#include <catch2/catch.hpp>
+#include <zeno/utils/zlog.h>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Counted {
+    int *count;
+};
+
+std::ostream &operator<<(std::ostream &os, Counted const &c) {
+    ++*c.count;
+    return os << "counted";
+}
+
+}
+
+TEST_CASE("leveled async log", "[log]") {
+    std::vector<std::pair<int, int>> got;
+    zlog::set_sink([&] (zlog::LogLevel level, const char *module, std::string const &msg) {
+        if (strcmp(module, "test"))
+            return;
+        int t, i;
+        sscanf(msg.c_str(), "%d %d", &t, &i);
+        got.emplace_back(t, i);
+    });
+    auto &mod = zlog::module("test");
+    REQUIRE(&mod == &zlog::module("test"));
+    zlog::set_level(zlog::LogLevel::info, "test");
+
+    int formatted = 0;
+    mod.debug("{}", Counted{&formatted});
+    REQUIRE(formatted == 0);
+
+    // more than the ring holds, so producers wait for the flusher too
+    const int nthreads = 4, nmsgs = 5000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nthreads; t++) {
+        threads.emplace_back([&mod, t] {
+            for (int i = 0; i < nmsgs; i++)
+                mod.info("{} {}", t, i);
+        });
+    }
+    for (auto &thr: threads)
+        thr.join();
+    zlog::flush();
+    zlog::set_sink(nullptr);
+
+    REQUIRE(got.size() == nthreads * nmsgs);
+    std::vector<int> next(nthreads);
+    bool ordered = true;
+    for (auto [t, i]: got)
+        ordered = ordered && i == next[t]++;
+    REQUIRE(ordered);
+}
@@ -0,0 +1,60 @@
+#include <catch2/catch.hpp>
+#include <zeno/utils/parallel.h>
+#include <stdexcept>
+#include <random>
+#include <mutex>
+
+TEST_CASE("parallel for", "[parallel]") {
+    std::vector<int> arr(100000);
+    zeno::parallel_for(arr.size(), [&] (size_t i) {
+        arr[i] += i;
+    });
+    size_t wrong = 0;
+    for (size_t i = 0; i < arr.size(); i++)
+        wrong += arr[i] != i;
+    REQUIRE(wrong == 0);
+
+    // nested in tasks and in itself, and under a lock held by the caller
+    std::mutex mtx;
+    std::vector<int> rows(64 * 1000);
+    zeno::TaskGroup group;
+    for (int t = 0; t < 4; t++) {
+        group.run([&, t] {
+            std::lock_guard lck(mtx);
+            zeno::parallel_for(t * 16, t * 16 + 16, [&] (size_t r) {
+                zeno::parallel_for(1000, [&] (size_t c) {
+                    rows[r * 1000 + c] = r;
+                }, 10);
+            }, 1);
+        });
+    }
+    group.wait();
+    for (size_t i = 0; i < rows.size(); i++)
+        wrong += rows[i] != i / 1000;
+    REQUIRE(wrong == 0);
+
+    REQUIRE_THROWS_AS(zeno::parallel_for(10000, [&] (size_t i) {
+        if (i == 5000)
+            throw std::runtime_error("oops");
+    }, 100), std::runtime_error);
+}
+
+TEST_CASE("parallel reduce and sort", "[parallel]") {
+    auto sum = zeno::parallel_reduce(0, 100001, (long long)0, [] (size_t i) {
+        return (long long)i;
+    }, std::plus<>{});
+    REQUIRE(sum == 100000ll * 100001 / 2);
+    auto big = zeno::parallel_reduce(0, 10, -1, [] (size_t i) {
+        return (int)i;
+    }, [] (int a, int b) { return std::max(a, b); });
+    REQUIRE(big == 9);
+
+    std::mt19937 rng(42);
+    std::vector<int> arr(123457);
+    for (auto &val: arr)
+        val = rng() % 1000;
+    auto ref = arr;
+    std::sort(ref.begin(), ref.end(), std::greater<>{});
+    zeno::parallel_sort(arr.begin(), arr.end(), std::greater<>{}, 1000);
+    REQUIRE(arr == ref);
+}
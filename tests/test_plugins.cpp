@@ -0,0 +1,47 @@
+#include <catch2/catch.hpp>
+#include <zeno/zeno.h>
+#include <zeno/types/NumericObject.h>
+#include <zeno/extra/Plugins.h>
+
+namespace {
+
+struct LazyAnswer : zeno::INode {
+    virtual void apply() override {
+        set_output("answer", std::make_shared<zeno::NumericObject>(42));
+    }
+};
+
+int loads = 0;
+
+}
+
+TEST_CASE("lazy node class", "[session]") {
+    // as registered by loadPluginManifest, the load here stands for
+    // dlopen running the library's ZENDEFNODE
+    auto &sess = zeno::getSession();
+    sess._defNodeClass("LazyAnswer", std::make_unique<zeno::LazyNodeClass>(
+                zeno::Descriptor({}, {"answer"}, {}, {"test"}), [&sess] {
+        loads++;
+        sess.defNodeClass(std::make_unique<LazyAnswer>, "LazyAnswer",
+                {{}, {"answer"}, {}, {"test"}, {"serial"}});
+    }));
+    auto stub = sess.nodeClasses.at("LazyAnswer").get();
+    REQUIRE(sess.dumpDescriptors().find("DESC@LazyAnswer@") != std::string::npos);
+    REQUIRE(loads == 0);
+
+    auto scene = zeno::createScene();
+    scene->switchGraph("main");
+    auto &graph = scene->getGraph();
+    graph.addNode("LazyAnswer", "a");
+    graph.completeNode("a");
+    graph.addNode("LazyAnswer", "b");
+    graph.completeNode("b");
+    REQUIRE(loads == 1);
+    REQUIRE(sess.nodeClasses.at("LazyAnswer").get() == stub);
+    REQUIRE(stub->desc->has_trait("serial"));
+
+    graph.applyNodes({"b"});
+    auto answer = zeno::safe_dynamic_cast<zeno::NumericObject>(
+            graph.nodes.at("b")->outputs.at("answer"));
+    REQUIRE(answer->get<int>() == 42);
+}
@@ -0,0 +1,44 @@
+#include <catch2/catch.hpp>
+#include <zeno/types/PrimitiveObject.h>
+
+TEST_CASE("pooled attribute storage", "[primitive]") {
+    zeno::trimAttributePool();
+    auto before = zeno::getAttributePoolStats();
+    const void *data;
+    {
+        zeno::PrimitiveObject prim;
+        prim.resize(100000);
+        auto &pos = prim.add_attr_uninit<zeno::vec3f>("pos");
+        pos[5] = zeno::vec3f(1, 2, 3);
+        data = pos.data();
+    }
+    REQUIRE(zeno::getAttributePoolStats().pooled >= 100000 * sizeof(zeno::vec3f));
+
+    // the next frame of about the same size reuses it, zeroed unless uninit
+    zeno::PrimitiveObject prim;
+    prim.resize(90000);
+    auto &pos = prim.add_attr<zeno::vec3f>("pos");
+    REQUIRE(pos.data() == data);
+    REQUIRE(pos[5][1] == 0);
+    auto after = zeno::getAttributePoolStats();
+    REQUIRE(after.hits == before.hits + 1);
+    REQUIRE(after.pooled == 0);
+
+    // growing keeps the values and zeroes the new ones, sharing copies
+    pos[7] = zeno::vec3f(7);
+    auto copy = prim.clone();
+    prim.resize(300000);
+    REQUIRE(prim.read_attr<zeno::vec3f>("pos")[7][2] == 7);
+    REQUIRE(prim.read_attr<zeno::vec3f>("pos")[299999][0] == 0);
+    auto other = static_cast<zeno::PrimitiveObject *>(copy.get());
+    REQUIRE(other->read_attr<zeno::vec3f>("pos").size() == 90000);
+    REQUIRE(other->read_attr<zeno::vec3f>("pos")[7][2] == 7);
+
+    // nor does the uninitialized resize touch the shared buffer
+    other->resize_uninit(300000);
+    REQUIRE(prim.read_attr<zeno::vec3f>("pos")[7][2] == 7);
+    REQUIRE(other->read_attr<zeno::vec3f>("pos").size() == 300000);
+
+    zeno::trimAttributePool();
+    REQUIRE(zeno::getAttributePoolStats().pooled == 0);
+}
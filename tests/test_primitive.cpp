@@ -0,0 +1,95 @@
+#include <catch2/catch.hpp>
+#include <zeno/types/PrimitiveObject.h>
+#include <zeno/types/PrimitiveIO.h>
+#include <zeno/extra/ObjectCodec.h>
+#include <zeno/utils/filesystem.h>
+#include <cmath>
+
+TEST_CASE("copy-on-write attributes", "[primitive]") {
+    zeno::PrimitiveObject prim;
+    prim.resize(4);
+    prim.add_attr<zeno::vec3f>("pos");
+    prim.add_attr<float>("rad", 1.0f);
+
+    auto copy = prim.clone();
+    auto other = static_cast<zeno::PrimitiveObject *>(copy.get());
+    REQUIRE(&other->read_attr<float>("rad") == &prim.read_attr<float>("rad"));
+
+    other->attr<float>("rad")[0] = 2.0f;  // unshares only `rad`
+    REQUIRE(prim.read_attr<float>("rad")[0] == 1.0f);
+    REQUIRE(other->read_attr<float>("rad")[0] == 2.0f);
+    REQUIRE(&other->read_attr<zeno::vec3f>("pos") == &prim.read_attr<zeno::vec3f>("pos"));
+    REQUIRE(!prim.m_attrs.at("rad").is_shared());
+}
+
+TEST_CASE("typed and quantized attributes", "[primitive]") {
+    REQUIRE((float)zeno::half(1.5f) == 1.5f);
+    REQUIRE((float)zeno::half(-65504.f) == -65504.f);
+    REQUIRE(std::isinf((float)zeno::half(65520.f)));
+    REQUIRE((float)zeno::half(1e-7f) == 1.0f / 16777216 * 2);  // subnormal
+    REQUIRE((float)zeno::half(1.0f + 1.0f / 4096) == 1.0f);  // tie to even
+    REQUIRE(zeno::unorm8(0.5f).bits == 128);
+    REQUIRE(zeno::unorm8(2.0f).bits == 255);
+    REQUIRE(zeno::unorm16(-1.0f).bits == 0);
+    for (int k = 0; k < 256; k++) {
+        zeno::unorm8 q;
+        q.bits = k;
+        REQUIRE(zeno::unorm8((float)q).bits == k);
+    }
+
+    zeno::PrimitiveObject prim;
+    prim.resize(3);
+    prim.add_attr<int>("id")[2] = (1 << 24) + 1;
+    prim.add_attr<zeno::vec4f>("clr", zeno::vec4f(1, 0.5f, 0.25f, 0.5f));
+    prim.add_attr<zeno::unorm8>("mask", 1.0f);
+    REQUIRE(prim.attr_is<int>("id"));
+    REQUIRE(prim.read_attr<int>("id")[2] == (1 << 24) + 1);
+    REQUIRE(prim.memoryUsage() >= 3 * (sizeof(int) + sizeof(zeno::vec4f) + 1));
+
+    auto clr = prim.attr_as<zeno::vec3f>("clr");
+    REQUIRE(zeno::all(clr[0] == zeno::vec3f(1, 0.5f, 0.25f)));
+    auto mask = prim.attr_as<zeno::vec3f>("mask");
+    REQUIRE(zeno::all(mask[1] == zeno::vec3f(1)));
+    auto pad = prim.attr_as<zeno::vec4i>("id");
+    REQUIRE(zeno::all(pad[2] == zeno::vec4i((1 << 24) + 1)));
+
+    prim.resize(5);
+    REQUIRE(prim.read_attr<zeno::unorm8>("mask").size() == 5);
+}
+
+TEST_CASE("typed attributes round trip", "[primitive]") {
+    zeno::PrimitiveObject prim;
+    prim.resize(2);
+    prim.add_attr<zeno::vec3f>("pos", zeno::vec3f(1, 2, 3));
+    prim.add_attr<int>("id")[1] = 123456789;
+    prim.add_attr<zeno::vec2f>("uv")[1] = zeno::vec2f(0.25f, 0.75f);
+    prim.add_attr<zeno::vec3i>("cell")[1] = zeno::vec3i(-1, 2, -3);
+    prim.add_attr<zeno::half>("w", 0.5f);
+    prim.add_attr<zeno::unorm16>("a", 1.0f);
+    prim.tris.emplace_back(0, 1, 0);
+
+    auto check = [] (zeno::PrimitiveObject const &got) {
+        REQUIRE(got.size() == 2);
+        REQUIRE(got.read_attr<int>("id")[1] == 123456789);
+        REQUIRE(zeno::all(got.read_attr<zeno::vec2f>("uv")[1] == zeno::vec2f(0.25f, 0.75f)));
+        REQUIRE(zeno::all(got.read_attr<zeno::vec3i>("cell")[1] == zeno::vec3i(-1, 2, -3)));
+        REQUIRE((float)got.read_attr<zeno::half>("w")[0] == 0.5f);
+        REQUIRE(got.read_attr<zeno::unorm16>("a")[1].bits == 65535);
+        REQUIRE(got.tris.size() == 1);
+    };
+
+    auto path = (zeno::fs::temp_directory_path() / "zentest-typed.zpm").string();
+    zeno::writezpm(&prim, path.c_str());
+    zeno::PrimitiveObject loaded;
+    zeno::readzpm(&loaded, path.c_str());
+    zeno::fs::remove(path);
+    check(loaded);
+
+    zeno::ObjectBuffer buf;
+    REQUIRE(zeno::encodeObject(buf, &prim));
+    zeno::ObjectReader in(buf.data.data(), buf.data.data() + buf.data.size());
+    auto decoded = std::dynamic_pointer_cast<zeno::PrimitiveObject>(
+            zeno::decodeObject(in));
+    REQUIRE(decoded);
+    check(*decoded);
+}
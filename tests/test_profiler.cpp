@@ -0,0 +1,164 @@
+#include <catch2/catch.hpp>
+#include <zeno/zeno.h>
+#include <zeno/types/PrimitiveObject.h>
+#include <zeno/extra/Profiler.h>
+#include <zeno/extra/MemoryReport.h>
+#include <zeno/utils/ThreadPool.h>
+#ifdef ZENO_GLOBALSTATE
+#include <zeno/extra/GlobalState.h>
+#endif
+#include <algorithm>
+
+TEST_CASE("node profiler", "[profiler]") {
+    auto json = R"ZSL([["clearAllState"], ["switchGraph", "main"], ["addNode", "NumericInt", "a"], ["setNodeParam", "a", "value", 2], ["completeNode", "a"], ["addNode", "NumericOperator", "neg"], ["bindNodeInput", "neg", "lhs", "a", "value"], ["setNodeParam", "neg", "op_type", "neg"], ["completeNode", "neg"], ["addNode", "SubOutput", "out"], ["bindNodeInput", "out", "port", "neg", "ret"], ["setNodeParam", "out", "type", ""], ["setNodeParam", "out", "name", "output"], ["setNodeParam", "out", "defl", ""], ["completeNode", "out"]])ZSL";
+    auto &prof = zeno::getProfiler();
+    bool was_enabled = prof.enabled;
+    prof.clear();
+    prof.enabled = true;
+    auto scene = zeno::createScene();
+    scene->isParallel = false;
+    scene->loadScene(json);
+    scene->switchGraph("main");
+    scene->getGraph().applyGraph();
+    prof.enabled = was_enabled;
+
+    auto events = prof.events();
+    REQUIRE(events.size() == 3);
+    auto out = std::find_if(events.begin(), events.end(),
+            [] (auto const &e) { return e.name == "out"; });
+    REQUIRE(out != events.end());
+    REQUIRE(out->depth == 0);
+    for (auto const &e: events) {  // inputs pulled by `out` nest inside it
+        REQUIRE(e.begin >= out->begin);
+        REQUIRE(e.duration <= out->duration);
+    }
+    REQUIRE(prof.summary().find("neg") != std::string::npos);
+    prof.clear();
+}
+
+TEST_CASE("profiler summaries per frame", "[profiler]") {
+    auto &prof = zeno::getProfiler();
+    bool was_enabled = prof.enabled;
+    prof.clear();
+    prof.enabled = true;
+    std::string outer = "outer", inner = "inner", other = "other";
+    {
+        zeno::ProfileScope scope(outer, 1);
+        // whoever runs it, even this thread helping, it's no child of outer
+        zeno::TaskGroup group;
+        group.run([&] { zeno::ProfileScope scope(inner, 1); });
+        group.wait();
+    }
+    {
+        zeno::ProfileScope scope(other, 2);
+    }
+    prof.enabled = was_enabled;
+
+    for (auto const &e: prof.events()) {
+        REQUIRE(e.depth == 0);
+        REQUIRE(e.children == 0);
+    }
+    auto frame1 = prof.summary(1);
+    REQUIRE(frame1.find("2 nodes") != std::string::npos);
+    REQUIRE(frame1.find("inner") != std::string::npos);
+    REQUIRE(frame1.find("other") == std::string::npos);
+    REQUIRE(prof.summary(2).find("1 nodes") != std::string::npos);
+    REQUIRE(prof.summary().find("3 nodes") != std::string::npos);
+    REQUIRE(prof.summary(3).find("0 nodes") != std::string::npos);
+    prof.clear();
+}
+
+namespace {
+
+struct TestMakePoints : zeno::INode {
+    virtual void apply() override {
+        auto prim = std::make_shared<zeno::PrimitiveObject>();
+        prim->add_attr<zeno::vec3f>("pos");
+        prim->resize(1000);
+        set_output("prim", std::move(prim));
+    }
+};
+
+ZENDEFNODE(TestMakePoints, {
+    {},
+    {"prim"},
+    {},
+    {"test"},
+});
+
+struct TestPassPoints : zeno::INode {
+    virtual void apply() override {
+        auto prim = get_input("prim");
+        set_output("prim", std::move(prim));
+    }
+};
+
+ZENDEFNODE(TestPassPoints, {
+    {"prim"},
+    {"prim"},
+    {},
+    {"test"},
+});
+
+struct TestCopyPoints : zeno::INode {
+    virtual void apply() override {
+        auto prim = get_input("prim")->clone();
+        set_output("prim", std::move(prim));
+    }
+};
+
+ZENDEFNODE(TestCopyPoints, {
+    {"prim"},
+    {"prim"},
+    {},
+    {"test"},
+});
+
+}
+
+TEST_CASE("memory report", "[profiler]") {
+    // the points passed through, then copied sharing their attributes
+    auto json = R"ZSL([["clearAllState"], ["switchGraph", "main"], ["addNode", "TestMakePoints", "make"], ["completeNode", "make"], ["addNode", "TestPassPoints", "pass"], ["bindNodeInput", "pass", "prim", "make", "prim"], ["completeNode", "pass"], ["addNode", "TestCopyPoints", "copy"], ["bindNodeInput", "copy", "prim", "pass", "prim"], ["completeNode", "copy"]])ZSL";
+    auto &report = zeno::getMemoryReport();
+    bool was_enabled = report.enabled;
+    for (bool release: {false, true}) {
+        report.clear();
+        report.enabled = true;
+        auto scene = zeno::createScene();
+        scene->releaseOutputs = release;
+        scene->loadScene(json);
+        scene->switchGraph("main");
+#ifdef ZENO_GLOBALSTATE
+        scene->globalState->frameid = 7;
+        int frameid = 7;
+#else
+        int frameid = 0;
+#endif
+        auto &graph = scene->getGraph();
+        graph.applyNodes({"copy"});
+        report.enabled = was_enabled;
+
+        auto frames = report.frames();
+        REQUIRE(frames.size() == 1);
+        auto const &f = frames[0];
+        REQUIRE(f.frameid == frameid);
+        auto copy = graph.nodes.at("copy")->outputs.at("prim");
+        int64_t points = copy->memoryUsage(), shell = sizeof(zeno::PrimitiveObject);
+        REQUIRE(points >= 1000 * sizeof(zeno::vec3f));
+        // the points counted once, for the producer unless it released
+        // them, the copy only for its own members
+        REQUIRE(f.peak == points + shell);
+        if (release) {
+            REQUIRE(f.resident == points);
+            REQUIRE(f.nodes.size() == 1);
+            REQUIRE(f.nodes.at("copy") == points);
+        } else {
+            REQUIRE(f.resident == points + shell);
+            REQUIRE(f.nodes.size() == 2);
+            REQUIRE(f.nodes.at("make") == points);
+            REQUIRE(f.nodes.at("copy") == shell);
+        }
+        REQUIRE(report.summary(frameid).find("frame " + std::to_string(frameid)) != std::string::npos);
+    }
+    report.clear();
+}
@@ -0,0 +1,87 @@
+#include <catch2/catch.hpp>
+#include <zeno/utils/reduction.h>
+#include <random>
+#include <cmath>
+
+TEST_CASE("array statistics match a serial pass", "[reduction]") {
+    // a few chunks and an odd tail
+    std::vector<zeno::vec3f> arr(100003);
+    std::mt19937 rng(5);
+    std::normal_distribution<float> gauss(3, 2);
+    for (auto &v: arr)
+        v = zeno::vec3f(gauss(rng), gauss(rng) * 10, gauss(rng) - 100);
+    arr[77777][1] = 1000;
+    arr[12][2] = -1000;
+    arr[50000][0] = NAN;  // left out of min and max
+
+    auto st = zeno::array_stats(arr);
+    REQUIRE(st.count == arr.size());
+    for (size_t c = 0; c < 3; c++) {
+        double sum = 0, sq = 0;
+        float mn = INFINITY, mx = -INFINITY;
+        int argmin = -1, argmax = -1;
+        size_t n = 0;
+        for (size_t i = 0; i < arr.size(); i++) {
+            float x = arr[i][c];
+            if (std::isnan(x))
+                continue;
+            sum += x;
+            sq += double(x) * x;
+            n++;
+            if (x < mn) mn = x, argmin = i;
+            if (x > mx) mx = x, argmax = i;
+        }
+        REQUIRE(st.min[c] == mn);
+        REQUIRE(st.max[c] == mx);
+        REQUIRE(st.argmin[c] == argmin);
+        REQUIRE(st.argmax[c] == argmax);
+        if (c) {
+            double mean = sum / n;
+            REQUIRE(st.mean(c) == Approx(mean));
+            REQUIRE(st.variance(c) == Approx(sq / n - mean * mean).epsilon(1e-6));
+        } else {
+            REQUIRE(std::isnan(st.sum[c]));
+        }
+    }
+    REQUIRE(st.argmax[1] == 77777);
+    REQUIRE(st.argmin[2] == 12);
+}
+
+TEST_CASE("array statistics of integers and histograms", "[reduction]") {
+    std::vector<int> arr(70000);
+    for (size_t i = 0; i < arr.size(); i++)
+        arr[i] = (int)(i % 1000) - 500;
+    // the first of equal extremes
+    arr[40000] = 16777217;
+    arr[60000] = 16777217;
+
+    zeno::ArrayHistogram hist;
+    hist.lo = -500;
+    hist.hi = 500;
+    hist.counts.resize(10);
+    auto st = zeno::array_stats(arr, &hist);
+    REQUIRE(st.max[0] == 16777217);
+    REQUIRE(st.argmax[0] == 40000);
+    REQUIRE(st.min[0] == -500);
+    REQUIRE(st.argmin[0] == 0);
+    size_t total = 0;
+    for (auto cnt: hist.counts)
+        total += cnt;
+    REQUIRE(total == arr.size() - 2);  // beyond hi
+    REQUIRE(hist.counts[0] == 70 * 100 - 2);  // two -500s replaced
+
+    // vectors are binned by length
+    std::vector<zeno::vec2f> vecs{{3, 4}, {0, 1}, {0, 0.5f}, {6, 8}};
+    zeno::ArrayHistogram lens;
+    lens.lo = 0;
+    lens.hi = 10;
+    lens.counts.resize(2);
+    zeno::array_histogram(vecs, lens);
+    REQUIRE(lens.counts[0] == 2);
+    REQUIRE(lens.counts[1] == 2);  // 5 opens the second, 10 closes it
+
+    zeno::ArrayStats<float, 1> empty = zeno::array_stats(std::vector<float>());
+    REQUIRE(empty.count == 0);
+    REQUIRE(empty.argmin[0] == -1);
+    REQUIRE(empty.mean(0) == 0);
+}
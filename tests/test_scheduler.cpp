@@ -0,0 +1,263 @@
+#include <catch2/catch.hpp>
+#include <zeno/zeno.h>
+#include <zeno/types/NumericObject.h>
+#include <zeno/types/ListObject.h>
+#ifdef ZENO_GLOBALSTATE
+#include <zeno/extra/GlobalState.h>
+#endif
+#include <thread>
+#include <chrono>
+#include <atomic>
+
+// ((a + b) * (a - b)) with a = 7, b = 3, via two independent branches
+static const char *json = R"ZSL([["clearAllState"], ["switchGraph", "main"], ["addNode", "NumericInt", "a"], ["setNodeParam", "a", "value", 7], ["completeNode", "a"], ["addNode", "NumericInt", "b"], ["setNodeParam", "b", "value", 3], ["completeNode", "b"], ["addNode", "NumericOperator", "add"], ["bindNodeInput", "add", "lhs", "a", "value"], ["bindNodeInput", "add", "rhs", "b", "value"], ["setNodeParam", "add", "op_type", "add"], ["completeNode", "add"], ["addNode", "NumericOperator", "sub"], ["bindNodeInput", "sub", "lhs", "a", "value"], ["bindNodeInput", "sub", "rhs", "b", "value"], ["setNodeParam", "sub", "op_type", "sub"], ["completeNode", "sub"], ["addNode", "NumericOperator", "mul"], ["bindNodeInput", "mul", "lhs", "add", "ret"], ["bindNodeInput", "mul", "rhs", "sub", "ret"], ["setNodeParam", "mul", "op_type", "mul"], ["completeNode", "mul"], ["addNode", "SubOutput", "out"], ["bindNodeInput", "out", "port", "mul", "ret"], ["setNodeParam", "out", "type", ""], ["setNodeParam", "out", "name", "output"], ["setNodeParam", "out", "defl", ""], ["completeNode", "out"]])ZSL";
+
+TEST_CASE("parallel scheduler", "[graph]") {
+    for (bool parallel: {false, true}) {
+        auto scene = zeno::createScene();
+        scene->isParallel = parallel;
+        scene->loadScene(json);
+        scene->switchGraph("main");
+        scene->getGraph().applyGraph();
+        auto output = scene->getGraph().getGraphOutput<zeno::NumericObject>("output");
+        REQUIRE(output->get<int>() == 40);
+    }
+}
+
+TEST_CASE("incremental evaluation", "[graph]") {
+    auto scene = zeno::createScene();
+    scene->loadScene(json);
+    scene->switchGraph("main");
+    auto &graph = scene->getGraph();
+    graph.applyGraph();
+    graph.applyGraph();
+    REQUIRE(graph.nodes.at("add")->applyVersion == 1);
+    REQUIRE(graph.nodes.at("mul")->applyVersion == 1);
+    REQUIRE(graph.getGraphOutput<zeno::NumericObject>("output")->get<int>() == 40);
+
+    graph.setNodeParam("b", "value", 3);  // unchanged, still clean
+    graph.setNodeParam("a", "value", 6);
+    graph.applyGraph();
+    REQUIRE(graph.nodes.at("b")->applyVersion == 1);
+    REQUIRE(graph.nodes.at("mul")->applyVersion == 2);
+    REQUIRE(graph.getGraphOutput<zeno::NumericObject>("output")->get<int>() == 27);
+}
+
+TEST_CASE("release consumed outputs", "[graph]") {
+    for (bool parallel: {false, true}) {
+        auto scene = zeno::createScene();
+        scene->isParallel = parallel;
+        scene->isIncremental = false;  // otherwise kept for reusing
+        scene->loadScene(json);
+        scene->switchGraph("main");
+        auto &graph = scene->getGraph();
+        graph.applyGraph();
+        REQUIRE(graph.getGraphOutput<zeno::NumericObject>("output")->get<int>() == 40);
+        REQUIRE(graph.nodes.at("add")->outputs.at("ret") == nullptr);
+        REQUIRE(graph.nodes.at("mul")->outputs.at("ret") == nullptr);
+        REQUIRE(graph.nodes.at("mul")->inputs.at("lhs") == nullptr);
+    }
+}
+
+TEST_CASE("patch scene in-place", "[graph]") {
+    auto scene = zeno::createScene();
+    scene->loadScene(json);
+    scene->switchGraph("main");
+    auto &graph = scene->getGraph();
+    graph.applyGraph();
+    auto a = graph.nodes.at("a").get();
+    auto add = graph.nodes.at("add").get();
+    auto intClass = a->nodeClass;
+
+    // (a + b) * (a + b), by rebinding instead of changing op_type of sub
+    scene->loadScene(R"ZSL([["switchGraph", "main"], ["removeNode", "sub"], ["unbindNodeInput", "mul", "rhs"], ["bindNodeInput", "mul", "rhs", "add", "ret"], ["completeNode", "mul"]])ZSL");
+    graph.applyGraph();
+    REQUIRE(graph.nodes.count("sub") == 0);
+    REQUIRE(graph.nodes.at("a").get() == a);
+    REQUIRE(graph.nodes.at("add").get() == add);
+    REQUIRE(add->applyVersion == 1);
+    REQUIRE(graph.getGraphOutput<zeno::NumericObject>("output")->get<int>() == 100);
+
+    // a class change can't keep the node, e.g. replacing an input constant
+    scene->loadScene(R"ZSL([["switchGraph", "main"], ["addNode", "NumericFloat", "a"], ["setNodeParam", "a", "value", 2.0], ["completeNode", "a"], ["addNode", "NumericFloat", "b"], ["setNodeParam", "b", "value", 3.0], ["completeNode", "b"]])ZSL");
+    graph.applyGraph();
+    REQUIRE(graph.nodes.at("a")->nodeClass != intClass);
+    REQUIRE(graph.getGraphOutput<zeno::NumericObject>("output")->get<float>() == 25.0f);
+}
+
+// two identical EmptyList, each appended to in-place by its own AppendList
+static const char *dup_json = R"ZSL([["clearAllState"], ["switchGraph", "main"], ["addNode", "EmptyList", "l1"], ["completeNode", "l1"], ["addNode", "EmptyList", "l2"], ["completeNode", "l2"], ["addNode", "NumericInt", "x1"], ["setNodeParam", "x1", "value", 1], ["completeNode", "x1"], ["addNode", "NumericInt", "x2"], ["setNodeParam", "x2", "value", 2], ["completeNode", "x2"], ["addNode", "AppendList", "ap1"], ["bindNodeInput", "ap1", "list", "l1", "list"], ["bindNodeInput", "ap1", "object", "x1", "value"], ["completeNode", "ap1"], ["addNode", "AppendList", "ap2"], ["bindNodeInput", "ap2", "list", "l2", "list"], ["bindNodeInput", "ap2", "object", "x2", "value"], ["completeNode", "ap2"], ["addNode", "ListLength", "len1"], ["bindNodeInput", "len1", "list", "ap1", "list"], ["completeNode", "len1"], ["addNode", "ListLength", "len2"], ["bindNodeInput", "len2", "list", "ap2", "list"], ["completeNode", "len2"], ["addNode", "NumericOperator", "sum"], ["bindNodeInput", "sum", "lhs", "len1", "length"], ["bindNodeInput", "sum", "rhs", "len2", "length"], ["setNodeParam", "sum", "op_type", "add"], ["completeNode", "sum"], ["addNode", "SubOutput", "out"], ["bindNodeInput", "out", "port", "sum", "ret"], ["setNodeParam", "out", "type", ""], ["setNodeParam", "out", "name", "output"], ["setNodeParam", "out", "defl", ""], ["completeNode", "out"]])ZSL";
+
+TEST_CASE("merge duplicate nodes", "[graph]") {
+    for (bool parallel: {false, true}) {
+        auto scene = zeno::createScene();
+        scene->isParallel = parallel;
+        scene->loadScene(json);
+        scene->switchGraph("main");
+        auto &graph = scene->getGraph();
+        graph.setNodeParam("b", "value", 7);  // (a + a) * (a - a) now
+        graph.applyGraph();
+        REQUIRE(graph.nodes.at("b")->cseSource == graph.nodes.at("a").get());
+        REQUIRE(graph.nodes.at("sub")->cseSource == nullptr);
+        REQUIRE(graph.getGraphOutput<zeno::NumericObject>("output")->get<int>() == 0);
+
+        graph.setNodeParam("b", "value", 3);
+        graph.applyGraph();
+        REQUIRE(graph.nodes.at("b")->cseSource == nullptr);
+        REQUIRE(graph.getGraphOutput<zeno::NumericObject>("output")->get<int>() == 40);
+    }
+}
+
+TEST_CASE("merged duplicates modified in-place", "[graph]") {
+    for (bool parallel: {false, true}) {
+        for (bool incremental: {false, true}) {
+            auto scene = zeno::createScene();
+            scene->isParallel = parallel;
+            scene->isIncremental = incremental;
+            scene->loadScene(dup_json);
+            scene->switchGraph("main");
+            auto &graph = scene->getGraph();
+            for (int i = 0; i < 3; i++) {
+                graph.applyGraph();
+                REQUIRE(graph.nodes.at("l2")->cseSource == graph.nodes.at("l1").get());
+                REQUIRE(graph.getGraphOutput<zeno::NumericObject>("output")->get<int>() == 2);
+            }
+        }
+    }
+}
+
+// a list extracted from a dict, appended to in-place
+static const char *extract_json = R"ZSL([["clearAllState"], ["switchGraph", "main"], ["addNode", "EmptyList", "l"], ["completeNode", "l"], ["addNode", "MakeDict", "d"], ["setNodeParam", "d", "_KEYS", "l"], ["bindNodeInput", "d", "l", "l", "list"], ["completeNode", "d"], ["addNode", "MakeString", "k"], ["setNodeParam", "k", "value", "l"], ["completeNode", "k"], ["addNode", "DictGetItem", "get"], ["bindNodeInput", "get", "dict", "d", "dict"], ["bindNodeInput", "get", "key", "k", "value"], ["completeNode", "get"], ["addNode", "NumericInt", "x"], ["setNodeParam", "x", "value", 1], ["completeNode", "x"], ["addNode", "AppendList", "ap"], ["bindNodeInput", "ap", "list", "get", "object"], ["bindNodeInput", "ap", "object", "x", "value"], ["completeNode", "ap"], ["addNode", "ListLength", "len"], ["bindNodeInput", "len", "list", "ap", "list"], ["completeNode", "len"], ["addNode", "SubOutput", "out"], ["bindNodeInput", "out", "port", "len", "length"], ["setNodeParam", "out", "type", ""], ["setNodeParam", "out", "name", "output"], ["setNodeParam", "out", "defl", ""], ["completeNode", "out"]])ZSL";
+
+TEST_CASE("extracted outputs modified in-place", "[graph]") {
+    for (bool incremental: {false, true}) {
+        auto scene = zeno::createScene();
+        scene->isIncremental = incremental;
+        scene->loadScene(extract_json);
+        scene->switchGraph("main");
+        auto &graph = scene->getGraph();
+        for (int i = 0; i < 4; i++) {
+            graph.applyGraph();
+            REQUIRE(graph.getGraphOutput<zeno::NumericObject>("output")->get<int>() == 1);
+        }
+    }
+}
+
+#ifdef ZENO_GLOBALSTATE
+static const char *frame_json = R"ZSL([["clearAllState"], ["switchGraph", "main"], ["addNode", "GetFrameNum", "frame"], ["completeNode", "frame"], ["addNode", "SubOutput", "out"], ["bindNodeInput", "out", "port", "frame", "FrameNum"], ["setNodeParam", "out", "type", ""], ["setNodeParam", "out", "name", "output"], ["setNodeParam", "out", "defl", ""], ["completeNode", "out"]])ZSL";
+
+TEST_CASE("concurrent scenes", "[graph]") {
+    auto run = [] (zeno::Scene *scene, int start, std::vector<int> *frames) {
+        auto &state = *scene->globalState;
+        state.frameid = start;
+        for (int i = 0; i < 50; i++) {
+            state.frameBegin();
+            while (state.substepBegin()) {
+                scene->getGraph().applyGraph();
+                state.substepEnd();
+            }
+            auto out = scene->getGraph().getGraphOutput<zeno::NumericObject>("output");
+            frames->push_back(out->get<int>());
+            state.frameEnd();
+        }
+    };
+
+    std::unique_ptr<zeno::Scene> scenes[2];
+    std::vector<int> frames[2];
+    for (auto &scene: scenes) {
+        scene = zeno::createScene();
+        scene->loadScene(frame_json);
+        scene->switchGraph("main");
+    }
+    REQUIRE(scenes[0]->globalState != scenes[1]->globalState);
+    std::thread thr(run, scenes[1].get(), 1000, &frames[1]);
+    run(scenes[0].get(), 0, &frames[0]);
+    thr.join();
+
+    for (int i = 0; i < 50; i++) {
+        REQUIRE(frames[0][i] == i);
+        REQUIRE(frames[1][i] == 1000 + i);
+    }
+}
+
+namespace {
+
+std::atomic<int> exclusiveActive{0}, exclusiveMost{0};
+
+// as defined by extensions built without ZENO_CONCURRENT_NODES
+struct TestExclusive : zeno::INode {
+    virtual void apply() override {
+        int active = ++exclusiveActive;
+        for (int most = exclusiveMost; most < active
+                && !exclusiveMost.compare_exchange_weak(most, active););
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        int value = 1;
+        for (auto key: {"a", "b"})
+            if (has_input(key))
+                value += get_input<zeno::NumericObject>(key)->get<int>();
+        --exclusiveActive;
+        set_output("value", std::make_shared<zeno::NumericObject>(value));
+    }
+};
+
+ZENDEFNODE(TestExclusive, {
+    {"a", "b"},
+    {"value"},
+    {},
+    {"test"},
+    {"exclusive"},
+});
+
+}
+
+TEST_CASE("exclusive nodes apply one at a time", "[graph]") {
+    auto json = R"ZSL([["clearAllState"], ["switchGraph", "main"], ["addNode", "TestExclusive", "x"], ["completeNode", "x"], ["addNode", "TestExclusive", "y"], ["completeNode", "y"], ["addNode", "TestExclusive", "z"], ["completeNode", "z"], ["addNode", "TestExclusive", "xy"], ["bindNodeInput", "xy", "a", "x", "value"], ["bindNodeInput", "xy", "b", "y", "value"], ["completeNode", "xy"], ["addNode", "TestExclusive", "xyz"], ["bindNodeInput", "xyz", "a", "xy", "value"], ["bindNodeInput", "xyz", "b", "z", "value"], ["completeNode", "xyz"], ["addNode", "SubOutput", "out"], ["bindNodeInput", "out", "port", "xyz", "value"], ["setNodeParam", "out", "type", ""], ["setNodeParam", "out", "name", "output"], ["setNodeParam", "out", "defl", ""], ["completeNode", "out"]])ZSL";
+    auto scene = zeno::createScene();
+    scene->isParallel = true;
+    scene->loadScene(json);
+    scene->switchGraph("main");
+    scene->getGraph().applyGraph();
+    REQUIRE(scene->getGraph().getGraphOutput<zeno::NumericObject>("output")->get<int>() == 5);
+    REQUIRE(exclusiveMost == 1);
+}
+
+TEST_CASE("subgraphs of exclusive nodes apply one at a time", "[graph]") {
+    // 1 + x in subgraph `ex`, called by two Subgraph nodes and a parallel loop
+    auto json = R"ZSL([["clearAllState"], ["switchGraph", "ex"], ["addNode", "SubInput", "x"], ["setNodeParam", "x", "type", ""], ["setNodeParam", "x", "name", "x"], ["setNodeParam", "x", "defl", ""], ["completeNode", "x"], ["addNode", "TestExclusive", "e"], ["bindNodeInput", "e", "a", "x", "port"], ["completeNode", "e"], ["addNode", "SubOutput", "y"], ["bindNodeInput", "y", "port", "e", "value"], ["setNodeParam", "y", "type", ""], ["setNodeParam", "y", "name", "y"], ["setNodeParam", "y", "defl", ""], ["completeNode", "y"], ["switchGraph", "main"], ["addNode", "NumericInt", "a"], ["setNodeParam", "a", "value", 3], ["completeNode", "a"], ["addNode", "NumericInt", "b"], ["setNodeParam", "b", "value", 4], ["completeNode", "b"], ["addNode", "Subgraph", "sa"], ["setNodeParam", "sa", "name", "ex"], ["bindNodeInput", "sa", "x", "a", "value"], ["completeNode", "sa"], ["addNode", "Subgraph", "sb"], ["setNodeParam", "sb", "name", "ex"], ["bindNodeInput", "sb", "x", "b", "value"], ["completeNode", "sb"], ["addNode", "NumericOperator", "add"], ["bindNodeInput", "add", "lhs", "sa", "y"], ["bindNodeInput", "add", "rhs", "sb", "y"], ["setNodeParam", "add", "op_type", "add"], ["completeNode", "add"], ["addNode", "SubOutput", "out"], ["bindNodeInput", "out", "port", "add", "ret"], ["setNodeParam", "out", "type", ""], ["setNodeParam", "out", "name", "output"], ["setNodeParam", "out", "defl", ""], ["completeNode", "out"], ["addNode", "NumericInt", "count"], ["setNodeParam", "count", "value", 4], ["completeNode", "count"], ["addNode", "BeginFor", "for"], ["bindNodeInput", "for", "count", "count", "value"], ["setNodeParam", "for", "parallel", 1], ["completeNode", "for"], ["addNode", "Subgraph", "sf"], ["setNodeParam", "sf", "name", "ex"], ["bindNodeInput", "sf", "x", "for", "index"], ["completeNode", "sf"], ["addNode", "EndFor", "endfor"], ["bindNodeInput", "endfor", "FOR", "for", "FOR"], ["bindNodeInput", "endfor", "object", "sf", "y"], ["completeNode", "endfor"], ["addNode", "SubOutput", "outlist"], ["bindNodeInput", "outlist", "port", "endfor", "list"], ["setNodeParam", "outlist", "type", ""], ["setNodeParam", "outlist", "name", "list"], ["setNodeParam", "outlist", "defl", ""], ["completeNode", "outlist"]])ZSL";
+    exclusiveMost = 0;
+    auto scene = zeno::createScene();
+    scene->isParallel = true;
+    scene->loadScene(json);
+    scene->switchGraph("main");
+    auto &graph = scene->getGraph();
+    graph.applyGraph();
+    REQUIRE(graph.getGraphOutput<zeno::NumericObject>("output")->get<int>() == 9);
+    auto list = graph.getGraphOutput<zeno::ListObject>("list");
+    REQUIRE(list->arr.size() == 4);
+    for (int i = 0; i < 4; i++)
+        REQUIRE(zeno::safe_dynamic_cast<zeno::NumericObject>(list->arr[i])->get<int>() == 1 + i);
+    REQUIRE(exclusiveMost == 1);
+}
+
+// a ONCE list appended to on each frame, as simulations advance particles
+static const char *once_json = R"ZSL([["clearAllState"], ["switchGraph", "main"], ["addNode", "EmptyList", "l"], ["setNodeOption", "l", "ONCE"], ["completeNode", "l"], ["addNode", "NumericInt", "x"], ["setNodeParam", "x", "value", 1], ["completeNode", "x"], ["addNode", "AppendList", "ap"], ["bindNodeInput", "ap", "list", "l", "list"], ["bindNodeInput", "ap", "object", "x", "value"], ["completeNode", "ap"], ["addNode", "ListLength", "len"], ["bindNodeInput", "len", "list", "ap", "list"], ["completeNode", "len"], ["addNode", "SubOutput", "out"], ["bindNodeInput", "out", "port", "len", "length"], ["setNodeParam", "out", "type", ""], ["setNodeParam", "out", "name", "output"], ["setNodeParam", "out", "defl", ""], ["completeNode", "out"]])ZSL";
+
+TEST_CASE("ONCE outputs modified in-place", "[graph]") {
+    for (bool incremental: {false, true}) {
+        auto scene = zeno::createScene();
+        scene->isIncremental = incremental;
+        scene->loadScene(once_json);
+        scene->switchGraph("main");
+        auto &state = *scene->globalState;
+        for (int i = 1; i <= 3; i++) {
+            state.frameBegin();
+            while (state.substepBegin()) {
+                scene->getGraph().applyGraph();
+                state.substepEnd();
+            }
+            state.frameEnd();
+            REQUIRE(scene->getGraph().getGraphOutput<zeno::NumericObject>("output")->get<int>() == i);
+        }
+    }
+}
+#endif
@@ -19,8 +19,10 @@ ZENO_API Descriptor::Descriptor(
   std::vector<SocketDescriptor> const &inputs,
   std::vector<SocketDescriptor> const &outputs,
   std::vector<ParamDescriptor> const &params,
-  std::vector<std::string> const &categories)
-  : inputs(inputs), outputs(outputs), params(params), categories(categories) {
+  std::vector<std::string> const &categories,
+  std::set<std::string> const &traits)
+  : inputs(inputs), outputs(outputs), params(params), categories(categories)
+  , traits(traits) {
     this->inputs.push_back("SRC");
     //this->inputs.push_back("COND");  // deprecated
     this->outputs.push_back("DST");
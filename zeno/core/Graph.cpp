@@ -3,20 +3,53 @@
 #include <zeno/core/INode.h>
 #include <zeno/core/IObject.h>
 #include <zeno/core/Session.h>
+#include <zeno/core/Descriptor.h>
+#include <zeno/extra/Profiler.h>
+#include <zeno/extra/MemoryReport.h>
+#include <zeno/extra/ObjectCodec.h>
+#ifdef ZENO_GLOBALSTATE
+#include <zeno/extra/GlobalState.h>
+#endif
+#include <zeno/utils/ThreadPool.h>
 #include <zeno/utils/safe_at.h>
+#include <zeno/utils/zlog.h>
+#include <functional>
+#include <atomic>
+#include <tuple>
+#include <unordered_map>
 
 namespace zeno {
 
-ZENO_API Context::Context() = default;
-ZENO_API Context::~Context() = default;
+ZENO_API Context::Context(size_t nnodes, int depth)
+    : marks(std::make_shared<Marks>())
+    , depth(depth)
+{
+    marks->nodes.resize(nnodes);
+    marks->chain.resize(depth + 1);
+    epoch = marks->nextEpoch++;
+    marks->chain[depth] = epoch;
+}
 
 ZENO_API Context::Context(Context const &other)
-    : visited(other.visited)
-{}
+    : marks(other.marks)
+    , depth(other.depth + 1)
+{
+    epoch = marks->nextEpoch++;
+    if (marks->chain.size() <= (size_t)depth)
+        marks->chain.resize(depth + 1);
+    marks->chain[depth] = epoch;
+}
+
+ZENO_API Context::~Context() = default;
 
 ZENO_API Graph::Graph() = default;
 ZENO_API Graph::~Graph() = default;
 
+static void mark_edited(Graph *graph) {
+    static std::atomic<unsigned> counter{0};
+    graph->editVersion = ++counter;
+}
+
 ZENO_API void Graph::setGraphInput(std::string const &id,
         std::shared_ptr<IObject> obj) {
     subInputs[id] = obj;
@@ -40,49 +73,571 @@ ZENO_API std::shared_ptr<IObject> const &Graph::getNodeOutput(
     auto node = safe_at(nodes, sn, "node");
     if (node->muted_output)
         return node->muted_output;
-    return safe_at(node->outputs, ss, "output", node->myname);
+    auto const &obj = safe_at(node->outputs, ss, "output", node->myname);
+    if (!obj)  // slot created by compile() but never set
+        throw Exception("invalid output name `" + ss + "` for `"
+                + node->myname + "`");
+    return obj;
 }
 
 ZENO_API void Graph::clearNodes() {
     nodes.clear();
+    nodesById.clear();
+    isCompiled = false;
+    mark_edited(this);
+}
+
+ZENO_API std::unique_ptr<Graph> Graph::instantiate() const {
+    auto inst = std::make_unique<Graph>();
+    inst->scene = scene;
+    for (auto const &[id, node]: nodes) {
+        auto cl = node->nodeClass;
+        auto copy = cl->new_instance();
+        copy->graph = inst.get();
+        copy->myname = id;
+        copy->nodeClass = cl;
+        copy->isPure = node->isPure;
+        copy->inputBounds = node->inputBounds;
+        copy->params = node->params;
+        copy->options = node->options;
+        inst->nodes[id] = std::move(copy);
+    }
+    for (auto const &[id, node]: inst->nodes) {
+        node->doComplete();
+    }
+    inst->editVersion = editVersion;
+    return inst;
+}
+
+ZENO_API bool Graph::saveState(ObjectSink &out) const {
+    out.put<uint64_t>(nodes.size());
+    for (auto const &[id, node]: nodes) {
+        out.putString(id);
+        out.putString(node->nodeClass->name);
+        if (!node->saveState(out)) {
+            zlog::warning("state of `{}` ({}) can't be saved",
+                    id, node->nodeClass->name);
+            return false;
+        }
+    }
+    return true;
+}
+
+ZENO_API void Graph::loadState(ObjectReader &in) {
+    auto n = in.get<uint64_t>();
+    for (uint64_t i = 0; i < n; i++) {
+        auto id = in.getString();
+        auto cls = in.getString();
+        auto it = nodes.find(id);
+        if (it == nodes.end() || it->second->nodeClass->name != cls)
+            throw Exception("saved state has a node `" + id + "` (" + cls
+                    + ") not in the graph, was the graph changed?");
+        it->second->loadState(in);
+    }
+    isCompiled = false;
+}
+
+ZENO_API void Graph::compile() {
+    nodesById.clear();
+    for (auto const &[id, node]: nodes) {
+        node->myid = nodesById.size();
+        nodesById.push_back(node.get());
+    }
+    for (auto node: nodesById) {
+        auto oldLinks = std::move(node->inputLinks);
+        node->inputLinks.clear();
+        for (auto const &[ds, bound]: node->inputBounds) {
+            auto const &[sn, ss] = bound;
+            INode::InputLink link;
+            link.ds = ds;
+            link.sn = sn;
+            link.ss = ss;
+            if (auto it = nodes.find(sn); it != nodes.end()) {
+                link.srcNode = it->second.get();
+                link.srcSlot = &link.srcNode->outputs[ss];
+            }
+            link.dstSlot = &node->inputs[ds];
+            for (auto const &old: oldLinks) {
+                if (old.ds == ds && old.sn == sn && old.ss == ss)
+                    link.srcVersion = old.srcVersion;
+            }
+            node->inputLinks.push_back(std::move(link));
+        }
+    }
+    for (auto node: nodesById) {
+        node->cseSource = nullptr;
+        node->cseCopies.clear();
+    }
+    if (scene && scene->mergeDuplicates)
+        mergeDuplicates();
+    isCompiled = true;
+}
+
+namespace {
+
+// a pure node, identified by its class, params and options, and by the
+// outputs its inputs are bound to, once their nodes are merged themselves;
+// refers to the node rather than copying them, hashed not to compare them
+// whole at every level of a tree
+struct DuplicateKey {
+    INode *node;
+    std::vector<INode *> sources;  // of node->inputLinks, merged
+
+    bool operator==(DuplicateKey const &other) const {
+        auto a = node, b = other.node;
+        if (a->nodeClass != b->nodeClass || sources != other.sources
+                || a->params != b->params || a->options != b->options)
+            return false;
+        for (size_t i = 0; i < sources.size(); i++) {
+            auto const &l = a->inputLinks[i], &r = b->inputLinks[i];
+            if (l.ds != r.ds || l.ss != r.ss)
+                return false;
+        }
+        return true;
+    }
+};
+
+struct DuplicateKeyHash {
+    template <class T>
+    static void combine(size_t &h, T const &val) {
+        h ^= std::hash<T>{}(val) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    }
+
+    size_t operator()(DuplicateKey const &key) const {
+        size_t h = 0;
+        combine(h, key.node->nodeClass);
+        for (auto src: key.sources)
+            combine(h, src);
+        for (auto const &[name, value]: key.node->params)
+            combine(h, value);
+        return h;
+    }
+};
+
+}
+
+ZENO_API void Graph::mergeDuplicates() {
+    // pure nodes of the same class, params and options, whose inputs are
+    // bound to the same outputs (after merging upstream) are identical
+    std::unordered_map<DuplicateKey, INode *, DuplicateKeyHash> uniques;
+    std::vector<char> done(nodesById.size());
+    std::function<INode *(INode *)> merge;
+    merge = [&] (INode *node) -> INode * {
+        if (done[node->myid])
+            return node->cseSource ? node->cseSource : node;
+        done[node->myid] = true;
+        auto desc = node->nodeClass->desc.get();
+        auto const &opts = node->options;
+        // ONCE and PREP outputs live across substeps, MUTE passes inputs
+        bool mergeable = node->isPure && !desc->has_trait("lazy")
+            && !desc->has_trait("serial") && !opts.count("ONCE")
+            && !opts.count("PREP") && !opts.count("MUTE");
+        DuplicateKey key{node};
+        for (auto const &link: node->inputLinks) {
+            if (!link.srcNode) {
+                mergeable = false;
+                continue;
+            }
+            key.sources.push_back(merge(link.srcNode));
+        }
+        if (!mergeable)
+            return node;
+        auto [it, inserted] = uniques.emplace(std::move(key), node);
+        if (inserted)
+            return node;
+        node->cseSource = it->second;
+        it->second->cseCopies.push_back(node);
+        return it->second;
+    };
+    int count = 0;
+    for (auto node: nodesById) {
+        merge(node);
+        count += node->cseSource != nullptr;
+    }
+    if (count)
+        zlog::debug("merged {} duplicate nodes", count);
 }
 
 ZENO_API void Graph::addNode(std::string const &cls, std::string const &id) {
-    if (nodes.find(id) != nodes.end())
-        return;  // no add twice, to prevent output object invalid
-    auto cl = safe_at(scene->sess->nodeClasses, cls, "node class");
+    INodeClass *cl;
+    {
+        std::lock_guard lck(scene->sess->nodeClassesMutex);
+        cl = safe_at(scene->sess->nodeClasses, cls, "node class");
+    }
+    if (auto it = nodes.find(id); it != nodes.end()) {
+        if (it->second->nodeClass == cl)
+            return;  // no add twice, to prevent output object invalid
+        removeNode(id);  // class changed by the editor, state can't be kept
+    }
     auto node = cl->new_instance();
     node->graph = this;
     node->myname = id;
     node->nodeClass = cl;
+    node->isPure = cl->desc->has_trait("pure");
     nodes[id] = std::move(node);
+    isCompiled = false;
+    mark_edited(this);
+}
+
+// drop what complete() registered, the name param might have changed
+static void unregister_node(Graph *graph, std::string const &id) {
+    for (auto *names: {&graph->subOutputNodes, &graph->portalIns}) {
+        for (auto it = names->begin(); it != names->end();) {
+            if (it->second == id)
+                it = names->erase(it);
+            else
+                ++it;
+        }
+    }
 }
 
 ZENO_API void Graph::completeNode(std::string const &id) {
-    safe_at(nodes, id, "node")->doComplete();
+    auto node = safe_at(nodes, id, "node");
+    unregister_node(this, id);
+    node->doComplete();
+    mark_edited(this);
 }
 
-ZENO_API void Graph::applyNode(std::string const &id) {
-    if (ctx->visited.find(id) != ctx->visited.end()) {
+ZENO_API void Graph::removeNode(std::string const &id) {
+    auto it = nodes.find(id);
+    if (it == nodes.end())
         return;
+    // nodes still bound to us fail to apply until rebound, like bindings
+    // to missing nodes do when loading; a node re-added under our name
+    // starts its versions over, so they can't tell it by version either
+    unregister_node(this, id);
+    nodes.erase(it);
+    for (auto const &[key, node]: nodes) {
+        for (auto const &[ds, bound]: node->inputBounds) {
+            if (bound.first == id)
+                node->isDirty = true;
+        }
     }
-    ctx->visited.insert(id);
-    auto node = safe_at(nodes, id, "node");
+    isCompiled = false;
+    mark_edited(this);
+}
+
+static void apply_node(INode *node, bool reuse) {
     try {
-        node->doApply();
+        if (auto scene = node->graph->scene; scene && scene->cancelRequested)
+            throw Exception("cancelled");
+        if (reuse) {
+            node->reuseApply();
+        } else if (node->cseSource) {
+            node->cseApply();
+        } else {
+#ifdef ZENO_GLOBALSTATE
+            auto const &state = node->getGlobalState();
+            ProfileScope scope(node->myname, state.frameid, state.substepid);
+#else
+            ProfileScope scope(node->myname);
+#endif
+            node->doApply();
+            node->updateVersion();
+            // copy now, before our consumers may modify outputs in-place
+            for (auto copy: node->cseCopies) {
+                copy->cseCopy();
+            }
+        }
+        auto graph = node->graph;
+        if (graph->isTracking && graph->ctx->depth == 0) {
+            graph->trackOutputs(node);
+            if (graph->isReleasing)
+                graph->releaseInputs(node);
+        }
     } catch (std::exception const &e) {
         throw zeno::Exception("During evaluation of `"
                 + node->myname + "`:\n" + e.what());
     }
 }
 
+ZENO_API void Graph::applyNode(std::string const &id) {
+    applyNode(safe_at(nodes, id, "node"));
+}
+
+ZENO_API void Graph::applyNode(INode *node) {
+    if (ctx->isVisited(node)) {
+        return;
+    }
+    ctx->setVisited(node);
+    if (node->cseSource) {
+        applyNode(node->cseSource);
+        apply_node(node, isIncremental() && node->isUpToDate());
+        return;
+    }
+    bool reuse = false;
+    if (node->isPure && isIncremental()) {
+        // evaluate inputs first to see if any of them has changed
+        for (auto const &link: node->inputLinks) {
+            if (link.srcNode)
+                applyNode(link.srcNode);
+        }
+        reuse = node->isUpToDate();
+    }
+    apply_node(node, reuse);
+}
+
+ZENO_API bool Graph::isIncremental() const {
+    // loop bodies see different inputs on each iteration, never reuse there
+    return scene && scene->isIncremental && ctx->depth == 0;
+}
+
+ZENO_API void Graph::computeLiveness(std::set<std::string> const &ids) {
+    for (auto node: nodesById) {
+        node->liveUses = 0;
+        node->isReleasable = false;
+    }
+    liveBytes = peakBytes = producedBytes = 0;
+    trackedStorage.clear();
+    isReleasing = scene && scene->releaseOutputs;
+    isTracking = isReleasing || getMemoryReport().enabled;
+    if (!isReleasing)
+        return;
+
+    // count consumers reachable from ids; those not applied this pass (e.g.
+    // untaken branches) just keep their sources alive, which is safe
+    std::vector<bool> reached(nodesById.size());
+    std::vector<INode *> stack;
+    for (auto const &id: ids) {
+        if (auto it = nodes.find(id); it != nodes.end())
+            stack.push_back(it->second.get());
+    }
+    while (stack.size()) {
+        auto node = stack.back();
+        stack.pop_back();
+        if (reached[node->myid])
+            continue;
+        reached[node->myid] = true;
+        for (auto const &link: node->inputLinks) {
+            if (!link.srcNode)
+                continue;
+            link.srcNode->liveUses++;
+            stack.push_back(link.srcNode);
+        }
+        if (auto src = node->cseSource) {
+            src->liveUses++;
+            stack.push_back(src);
+        }
+    }
+
+    for (auto node: nodesById) {
+        if (!reached[node->myid] || ids.count(node->myname))
+            continue;
+        // keep outputs reused by next apply (pure, ONCE, PREP), needed by
+        // the viewer, or owned by control, portal and subgraph nodes
+        if (node->isPure && scene->isIncremental)
+            continue;
+        auto const &opts = node->options;
+        if (opts.count("VIEW") || opts.count("ONCE") || opts.count("PREP"))
+            continue;
+        auto desc = node->nodeClass->desc.get();
+        if (desc->has_trait("lazy") || desc->has_trait("serial"))
+            continue;
+        node->isReleasable = true;
+    }
+}
+
+static void update_peak(std::atomic<int64_t> &peak, int64_t value) {
+    auto old = peak.load();
+    while (old < value && !peak.compare_exchange_weak(old, value));
+}
+
+ZENO_API int64_t Graph::residentBytes(
+        std::map<std::string, int64_t> *byNode) const {
+    // counted for the node producing an object, not for those passing it
+    // on after modifying it in-place or sharing its attributes in a copy;
+    // unless the producer released it: producers are visited first
+    std::map<void const *, size_t> counted;
+    std::set<INode *> visited;
+    int64_t total = 0;
+    std::function<void(INode *)> visit;
+    visit = [&] (INode *node) {
+        if (!visited.insert(node).second)
+            return;
+        for (auto const &[ds, bound]: node->inputBounds) {
+            if (auto it = nodes.find(bound.first); it != nodes.end())
+                visit(it->second.get());
+        }
+        int64_t bytes = 0;
+        for (auto const &[key, obj]: node->outputs) {
+            if (obj)
+                bytes += obj->countMemoryUsage(counted);
+        }
+        if (auto const &obj = node->muted_output)
+            bytes += obj->countMemoryUsage(counted);
+        if (byNode && bytes)
+            (*byNode)[node->myname] += bytes;
+        total += bytes;
+    };
+    for (auto const &[id, node]: nodes)
+        visit(node.get());
+    return total;
+}
+
+ZENO_API void Graph::trackOutputs(INode *node) {
+    // as in residentBytes, inputs passed through after modifying them
+    // in-place, or attributes shared with a copy, were counted already
+    int64_t bytes = 0;
+    {
+        std::lock_guard lck(trackMtx);
+        for (auto const &[key, obj]: node->outputs) {
+            if (obj)
+                bytes += obj->countMemoryUsage(trackedStorage);
+        }
+    }
+    producedBytes += bytes;
+    update_peak(peakBytes, liveBytes += bytes);
+}
+
+static void release_use(Graph *graph, INode *src) {
+    if (!src || !src->isReleasable)
+        return;
+    if (src->liveUses.fetch_sub(1) != 1 || src->muted_output)
+        return;
+    // only freed if not held elsewhere, e.g. passed through by a consumer
+    std::map<void const *, size_t> freed;
+    for (auto &[key, obj]: src->outputs) {
+        if (key == "DST")  // set once by doComplete, not by apply
+            continue;
+        if (obj && obj.use_count() == 1)
+            obj->countMemoryUsage(freed);
+        obj = nullptr;
+    }
+    std::lock_guard lck(graph->trackMtx);
+    for (auto const &[ptr, size]: freed) {
+        if (graph->trackedStorage.erase(ptr))
+            graph->liveBytes -= size;
+    }
+}
+
+ZENO_API void Graph::releaseInputs(INode *node) {
+    // we won't be applied again in this pass, so the inputs are only needed
+    // by lazy nodes that pull them again later on (e.g. FuncBegin)
+    bool lazy = node->nodeClass->desc->has_trait("lazy");
+    for (auto const &link: node->inputLinks) {
+        if (!lazy)
+            *link.dstSlot = nullptr;
+        release_use(this, link.srcNode);
+    }
+    release_use(this, node->cseSource);
+}
+
+namespace {
+
+struct ScheduleTask {
+    INode *node = nullptr;
+    bool eligible = false;
+    std::atomic<int> pending{0};
+    std::vector<ScheduleTask *> consumers;
+};
+
+}
+
+ZENO_API void Graph::scheduleNodes(std::set<std::string> const &ids) {
+    // build the dependency DAG from inputBounds; only nodes whose whole
+    // upstream can be evaluated ahead of time are included, the rest
+    // (loops, branches, portals...) are left to the serial applyNode
+    std::vector<std::unique_ptr<ScheduleTask>> tasks(nodesById.size());
+    std::function<ScheduleTask *(INode *)> visit;
+    visit = [&] (INode *node) -> ScheduleTask * {
+        if (auto const &task = tasks[node->myid]; task)
+            return task.get();
+        auto task = (tasks[node->myid] = std::make_unique<ScheduleTask>()).get();
+        task->node = node;
+        if (ctx->isVisited(node))
+            return task;
+        auto desc = node->nodeClass->desc.get();
+        if (desc->has_trait("lazy"))
+            return task;
+        bool eligible = !desc->has_trait("serial") && !node->isExclusive();
+        std::set<ScheduleTask *> deps;
+        for (auto const &link: node->inputLinks) {
+            auto dep = link.srcNode ? visit(link.srcNode) : nullptr;
+            if (!dep || !dep->eligible)
+                eligible = false;
+            else
+                deps.insert(dep);
+        }
+        if (node->cseSource) {  // outputs copied when it's applied
+            auto dep = visit(node->cseSource);
+            if (!dep->eligible)
+                eligible = false;
+            else
+                deps.insert(dep);
+        }
+        if (eligible) {
+            task->eligible = true;
+            task->pending = deps.size();
+            for (auto dep: deps)
+                dep->consumers.push_back(task);
+        }
+        return task;
+    };
+    for (auto const &id: ids) {
+        if (auto it = nodes.find(id); it != nodes.end())
+            visit(it->second.get());
+    }
+
+    std::vector<ScheduleTask *> ready;
+    int count = 0;
+    for (auto const &task: tasks) {
+        if (!task || !task->eligible)
+            continue;
+        count++;
+        if (!task->pending)
+            ready.push_back(task.get());
+    }
+    if (count < 2)  // nothing to overlap
+        return;
+
+    // marked up front, so that requireInput from other workers only reads
+    for (auto const &task: tasks) {
+        if (task && task->eligible)
+            ctx->setVisited(task->node);
+    }
+
+    bool incremental = isIncremental();
+    TaskGroup group;
+    std::function<void(ScheduleTask *)> launch;
+    launch = [&] (ScheduleTask *task) {
+        group.run([&, task] {
+            if (group.has_error())
+                return;
+            auto node = task->node;
+            apply_node(node, node->isPure && incremental
+                    && node->isUpToDate());
+            for (auto consumer: task->consumers) {
+                if (consumer->pending.fetch_sub(1) == 1)
+                    launch(consumer);
+            }
+        });
+    };
+    for (auto task: ready) {
+        launch(task);
+    }
+    group.wait();
+}
+
 ZENO_API void Graph::applyNodes(std::set<std::string> const &ids) {
     try {
-        ctx = std::make_unique<Context>();
+        if (!isCompiled)
+            compile();
+        auto &report = getMemoryReport();
+        int64_t base = report.enabled ? residentBytes() : 0;
+        ctx = std::make_unique<Context>(nodesById.size());
+        computeLiveness(ids);
+        if (scene && scene->isParallel)
+            scheduleNodes(ids);
         for (auto const &id: ids) {
             applyNode(id);
         }
         ctx = nullptr;
+        if (report.enabled)
+            report.record(*this, base);
+        if (isReleasing && peakBytes < producedBytes) {
+            zlog::debug("released outputs: peak {} MB instead of {} MB",
+                    peakBytes / 1048576.0, producedBytes / 1048576.0);
+        }
     } catch (std::exception const &e) {
         ctx = nullptr;
         throw zeno::Exception(
@@ -93,17 +648,57 @@ ZENO_API void Graph::applyNodes(std::set<std::string> const &ids) {
 
 ZENO_API void Graph::bindNodeInput(std::string const &dn, std::string const &ds,
         std::string const &sn, std::string const &ss) {
-    safe_at(nodes, dn, "node")->inputBounds[ds] = std::pair(sn, ss);
+    auto node = safe_at(nodes, dn, "node");
+    node->inputBounds[ds] = std::pair(sn, ss);
+    node->isDirty = true;
+    isCompiled = false;
+    mark_edited(this);
+}
+
+ZENO_API void Graph::unbindNodeInput(std::string const &dn,
+        std::string const &ds) {
+    auto node = safe_at(nodes, dn, "node");
+    if (!node->inputBounds.erase(ds))
+        return;
+    node->inputs.erase(ds);
+    node->isDirty = true;
+    isCompiled = false;
+    mark_edited(this);
 }
 
 ZENO_API void Graph::setNodeParam(std::string const &id, std::string const &par,
         IValue const &val) {
-    safe_at(nodes, id, "node")->params[par] = val;
+    auto node = safe_at(nodes, id, "node");
+    auto it = node->params.find(par);
+    if (it != node->params.end() && it->second == val)
+        return;  // re-set by editor every frame, unchanged
+    node->params[par] = val;
+    node->isDirty = true;
+    if (node->isPure)  // may become or stop being a duplicate
+        isCompiled = false;
+    mark_edited(this);
 }
 
 ZENO_API void Graph::setNodeOption(std::string const &id,
         std::string const &name) {
-    safe_at(nodes, id, "node")->options.insert(name);
+    auto node = safe_at(nodes, id, "node");
+    if (node->options.insert(name).second) {
+        node->isDirty = true;
+        if (node->isPure)
+            isCompiled = false;
+        mark_edited(this);
+    }
+}
+
+ZENO_API void Graph::unsetNodeOption(std::string const &id,
+        std::string const &name) {
+    auto node = safe_at(nodes, id, "node");
+    if (node->options.erase(name)) {
+        node->isDirty = true;
+        if (node->isPure)
+            isCompiled = false;
+        mark_edited(this);
+    }
 }
 
 }
@@ -2,7 +2,12 @@
 #include <zeno/core/Graph.h>
 #include <zeno/core/Descriptor.h>
 #include <zeno/core/Session.h>
+#include <zeno/core/Scene.h>
 #include <zeno/types/ConditionObject.h>
+#include <zeno/types/ListObject.h>
+#include <zeno/types/DictObject.h>
+#include <zeno/extra/DiskCache.h>
+#include <zeno/extra/ObjectCodec.h>
 #ifdef ZENO_VISUALIZATION  // TODO: can we decouple vis from zeno core?
 #include <zeno/extra/Visualization.h>
 #endif
@@ -10,6 +15,8 @@
 #include <zeno/extra/GlobalState.h>
 #endif
 #include <zeno/utils/safe_at.h>
+#include <cstdio>
+#include <set>
 
 namespace zeno {
 
@@ -32,12 +39,12 @@ ZENO_API bool INode::checkApplyCondition() {
 
 #ifdef ZENO_GLOBALSTATE
     if (has_option("ONCE")) {  // TODO: frame control should be editor work
-        if (!zeno::state.isFirstSubstep())
+        if (!getGlobalState().isFirstSubstep())
             return false;
     }
 
     if (has_option("PREP")) {
-        if (!zeno::state.isOneSubstep())
+        if (!getGlobalState().isOneSubstep())
             return false;
     }
 #endif
@@ -60,28 +67,72 @@ ZENO_API bool INode::checkApplyCondition() {
 }
 
 ZENO_API void INode::doApply() {
-    for (auto const &[ds, bound]: inputBounds) {
-        requireInput(ds);
+    for (auto const &link: inputLinks) {
+        requireInput(link);
     }
 
     coreApply();
 }
 
 ZENO_API void INode::requireInput(std::string const &ds) {
-    auto [sn, ss] = inputBounds.at(ds);
-    graph->applyNode(sn);
-    auto ref = graph->getNodeOutput(sn, ss);
-    inputs[ds] = ref;
+    for (auto const &link: inputLinks) {
+        if (link.ds == ds)
+            return requireInput(link);
+    }
+    throw Exception("invalid input name `" + ds + "` for `" + myname + "`");
+}
+
+ZENO_API void INode::requireInput(InputLink const &link) {
+    if (!link.srcNode)
+        throw Exception("invalid node name `" + link.sn + "`");
+    graph->applyNode(link.srcNode);
+    auto const &ref = link.srcNode->muted_output
+        ? link.srcNode->muted_output : *link.srcSlot;
+    if (!ref)
+        throw Exception("invalid output name `" + link.ss + "` for `"
+                + link.srcNode->myname + "`");
+    auto src = link.srcNode;
+    // outputs of ONCE and PREP nodes are state meant to be modified in-place
+    // across frames, e.g. particles advected, never copied
+    bool keep = src->has_option("ONCE") || src->has_option("PREP");
+    if (mutatesInputs && src->isPure && !keep && graph->isIncremental()) {
+        // we modified inputs in-place last time, so give us a copy and
+        // keep the output of the pure node intact for reusing next time
+        if (auto obj = ref->clone()) {
+            *link.dstSlot = std::move(obj);
+            return;
+        }
+    }
+    *link.dstSlot = ref;
 }
 
 ZENO_API void INode::coreApply() {
     if (checkApplyCondition()) {
-        apply();
+        if (has_option("CACHE"))
+            cacheApply();
+        else
+            apply();
     }
 
+    dumpView();
+}
+
+ZENO_API void INode::cacheApply() {
+    auto &cache = getDiskCache();
+    // keyed before applying, apply may modify inputs in-place
+    auto key = cache.nodeKey(this);
+    if (key.size() && cache.load(key, outputs))
+        return;
+    apply();
+    if (key.size())
+        cache.store(key, outputs);
+}
+
+ZENO_API void INode::dumpView() {
 #ifdef ZENO_VISUALIZATION
     if (has_option("VIEW")) {
         graph->hasAnyView = true;
+        auto &state = getGlobalState();
         if (!state.isOneSubstep())  // no duplicate view when multi-substep used
             return;
         if (!graph->isViewed)  // VIEW subnodes only if subgraph is VIEW'ed
@@ -89,12 +140,163 @@ ZENO_API void INode::coreApply() {
         auto desc = nodeClass->desc.get();
         auto obj = muted_output ? muted_output
             : safe_at(outputs, desc->outputs[0].name, "output");
-        auto path = Visualization::exportPath();
-        obj->dumpfile(path);
+        if (!obj)
+            throw Exception("invalid output name `"
+                    + desc->outputs[0].name + "` for `" + myname + "`");
+        Visualization::exportObject(obj, state, viewKey());
     }
 #endif
 }
 
+ZENO_API bool INode::isUpToDate() const {
+    if (!isPure || isDirty || !applyVersion)
+        return false;
+    if (cseSource)
+        return cseVersion == cseSource->applyVersion;
+    for (auto const &link: inputLinks) {
+        if (!link.srcNode || link.srcNode->applyVersion != link.srcVersion)
+            return false;
+    }
+    return true;
+}
+
+ZENO_API void INode::reuseApply() {
+    dumpView();
+}
+
+static bool holds_object(IObject const *out, IObject const *obj) {
+    if (out == obj)
+        return true;
+    if (auto list = dynamic_cast<ListObject const *>(out)) {
+        for (auto const &elm: list->arr)
+            if (holds_object(elm.get(), obj))
+                return true;
+    } else if (auto dict = dynamic_cast<DictObject const *>(out)) {
+        for (auto const &[key, elm]: dict->lut)
+            if (holds_object(elm.get(), obj))
+                return true;
+    }
+    return false;
+}
+
+// pure nodes keeping obj in their outputs, as is or in a list or dict, e.g.
+// MakeDict upstream of DictGetItem, can't reuse them any more; stops at the
+// nodes which passed it through themselves, their updateVersion did the rest
+static void invalidate_holders(INode *node, IObject const *obj,
+        std::set<INode *> &visited) {
+    if (!visited.insert(node).second)
+        return;
+    bool held = false, passed = false;
+    for (auto const &[key, out]: node->outputs) {
+        held = held || holds_object(out.get(), obj);
+        passed = passed || (node->mutatesInputs && out.get() == obj);
+    }
+    if (!held)
+        return;
+    if (node->isPure)
+        node->isDirty = true;
+    if (passed)
+        return;
+    for (auto const &link: node->inputLinks) {
+        if (link.srcNode)
+            invalidate_holders(link.srcNode, obj, visited);
+    }
+}
+
+ZENO_API void INode::updateVersion() {
+    for (auto &link: inputLinks) {
+        if (!link.srcNode)
+            continue;
+        link.srcVersion = link.srcNode->applyVersion;
+        auto const &obj = *link.dstSlot;
+        if (!obj)  // not required by lazy nodes
+            continue;
+        for (auto const &[key, out]: outputs) {
+            if (out != obj)
+                continue;
+            // an input passed through as output was most likely modified
+            // in-place, the pure node owning it can't reuse it any more
+            mutatesInputs = true;
+            if (obj == *link.srcSlot) {  // not a copy, see requireInput
+                std::set<INode *> visited;
+                invalidate_holders(link.srcNode, obj.get(), visited);
+            }
+        }
+    }
+    applyVersion++;
+    isDirty = false;
+}
+
+ZENO_API void INode::cseApply() {
+    // usually copied already when cseSource was applied, see apply_node
+    if (isDirty || !applyVersion || cseVersion != cseSource->applyVersion)
+        cseCopy();
+    dumpView();
+}
+
+ZENO_API void INode::cseCopy() {
+    for (auto const &[key, obj]: cseSource->outputs) {
+        if (key == "DST")  // ours, set by doComplete
+            continue;
+        auto copy = obj ? obj->clone() : nullptr;
+        outputs[key] = copy ? std::move(copy) : obj;
+    }
+    for (auto const &link: inputLinks) {
+        *link.dstSlot = nullptr;  // never required, maybe left from before
+    }
+    cseVersion = cseSource->applyVersion;
+    updateVersion();
+}
+
+ZENO_API bool INode::saveState(ObjectSink &out) const {
+    // ONCE nodes only apply on the first substep of a run, later ones
+    // usually modify their outputs in-place, e.g. particles advected
+    bool once = has_option("ONCE");
+    out.put(once);
+    return !once || saveOutputs(out);
+}
+
+ZENO_API void INode::loadState(ObjectReader &in) {
+    if (in.get<bool>())
+        loadOutputs(in);
+}
+
+ZENO_API bool INode::saveOutputs(ObjectSink &out) const {
+    out.put<uint64_t>(outputs.size());
+    for (auto const &[key, obj]: outputs) {
+        out.putString(key);
+        if (!encodeObject(out, obj.get()))
+            return false;
+    }
+    return true;
+}
+
+ZENO_API void INode::loadOutputs(ObjectReader &in) {
+    auto n = in.get<uint64_t>();
+    for (uint64_t i = 0; i < n; i++) {
+        auto key = in.getString();
+        outputs[key] = decodeObject(in);
+    }
+}
+
+ZENO_API bool INode::isExclusive() {
+    return nodeClass->desc->has_trait("exclusive");
+}
+
+#ifdef ZENO_GLOBALSTATE
+ZENO_API std::string INode::viewKey() const {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%06d", myid);
+    return graph->viewPrefix + buf;
+}
+
+ZENO_API GlobalState &INode::getGlobalState() const {
+    if (graph && graph->scene)
+        return *graph->scene->globalState;
+    return state;
+}
+#endif
+
 ZENO_API bool INode::has_option(std::string const &id) const {
     return options.find(id) != options.end();
 }
@@ -104,7 +306,10 @@ ZENO_API bool INode::has_input(std::string const &id) const {
 }
 
 ZENO_API std::shared_ptr<IObject> INode::get_input(std::string const &id) const {
-    return safe_at(inputs, id, "input", myname);
+    auto const &obj = safe_at(inputs, id, "input", myname);
+    if (!obj)  // slot created by Graph::compile but not required yet
+        throw Exception("invalid input name `" + id + "` for `" + myname + "`");
+    return obj;
 }
 
 ZENO_API IValue INode::get_param(std::string const &id) const {
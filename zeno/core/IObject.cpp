@@ -16,4 +16,15 @@ ZENO_API bool IObject::assign(IObject *other) {
 ZENO_API void IObject::dumpfile(std::string const &path) {
 }
 
+ZENO_API size_t IObject::memoryUsage() const {
+    return 0;
+}
+
+ZENO_API size_t IObject::countMemoryUsage(
+        std::map<void const *, size_t> &counted) const {
+    if (counted.count(this))
+        return 0;
+    return counted[this] = memoryUsage();
+}
+
 }
@@ -1,10 +1,25 @@
 #include <zeno/core/Scene.h>
 #include <zeno/core/Graph.h>
+#include <zeno/extra/GlobalState.h>
 #include <zeno/utils/safe_at.h>
+#include <cstdlib>
 
 namespace zeno {
 
-ZENO_API Scene::Scene() = default;
+ZENO_API Scene::Scene()
+    : m_globalState(std::make_unique<GlobalState>())
+{
+    globalState = m_globalState.get();
+    if (getenv("ZEN_SERIAL"))
+        isParallel = false;
+    if (getenv("ZEN_FULLEVAL"))
+        isIncremental = false;
+    if (getenv("ZEN_KEEPOUTPUTS"))
+        releaseOutputs = false;
+    if (getenv("ZEN_KEEPDUPLICATES"))
+        mergeDuplicates = false;
+}
+
 ZENO_API Scene::~Scene() = default;
 
 ZENO_API void Scene::clearAllState() {
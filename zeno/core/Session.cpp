@@ -1,5 +1,9 @@
 #include <zeno/core/Session.h>
 #include <zeno/core/Scene.h>
+#include <zeno/extra/Plugins.h>
+#ifdef ZENO_GLOBALSTATE
+#include <zeno/extra/GlobalState.h>
+#endif
 
 namespace zeno {
 
@@ -7,7 +11,16 @@ ZENO_API Session::Session() = default;
 ZENO_API Session::~Session() = default;
 
 ZENO_API void Session::_defNodeClass(std::string const &id, std::unique_ptr<INodeClass> &&cls) {
-    nodeClasses[id] = std::move(cls);
+    std::lock_guard lck(nodeClassesMutex);
+    cls->name = id;
+    auto &slot = nodeClasses[id];
+    // nodes already created from a manifest stub keep pointing to it
+    if (auto lazy = dynamic_cast<LazyNodeClass *>(slot.get()); lazy && !lazy->impl) {
+        *lazy->desc = *cls->desc;
+        lazy->impl = std::move(cls);
+        return;
+    }
+    slot = std::move(cls);
 }
 
 ZENO_API INodeClass::INodeClass(Descriptor const &desc)
@@ -23,12 +36,17 @@ ZENO_API std::unique_ptr<Scene> Session::createScene() {
 }
 
 ZENO_API Scene &Session::getDefaultScene() {
-    if (!defaultScene)
+    if (!defaultScene) {
         defaultScene = createScene();
+#ifdef ZENO_GLOBALSTATE
+        defaultScene->globalState = &state;
+#endif
+    }
     return *defaultScene;
 }
 
 ZENO_API std::string Session::dumpDescriptors() const {
+  std::lock_guard lck(nodeClassesMutex);
   std::string res = "";
   for (auto const &[key, cls] : nodeClasses) {
     res += "DESC@" + key + "@" + cls->desc->serialize() + "\n";
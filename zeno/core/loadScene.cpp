@@ -9,10 +9,12 @@ using namespace rapidjson;
 static zeno::IValue generic_get(Value const &x) {
     if (x.IsString()) {
         return x.GetString();
+    } else if (x.IsBool()) {
+        return (int)x.GetBool();
     } else if (x.IsInt()) {
         return x.GetInt();
-    } else if (x.IsFloat()) {
-        return x.GetFloat();
+    } else if (x.IsNumber()) {  // IsFloat() is false for e.g. 0.1
+        return (float)x.GetDouble();
     } else {
         return 0;
     }
@@ -29,14 +31,20 @@ ZENO_API void Scene::loadScene(const char *json) {
             if (0) {
             } else if (cmd == "addNode") {
                 getGraph().addNode(di[1].GetString(), di[2].GetString());
+            } else if (cmd == "removeNode") {
+                getGraph().removeNode(di[1].GetString());
             } else if (cmd == "completeNode") {
                 getGraph().completeNode(di[1].GetString());
             } else if (cmd == "setNodeParam") {
                 getGraph().setNodeParam(di[1].GetString(), di[2].GetString(), generic_get(di[3]));
             } else if (cmd == "setNodeOption") {
                 getGraph().setNodeOption(di[1].GetString(), di[2].GetString());
+            } else if (cmd == "unsetNodeOption") {
+                getGraph().unsetNodeOption(di[1].GetString(), di[2].GetString());
             } else if (cmd == "bindNodeInput") {
                 getGraph().bindNodeInput(di[1].GetString(), di[2].GetString(), di[3].GetString(), di[4].GetString());
+            } else if (cmd == "unbindNodeInput") {
+                getGraph().unbindNodeInput(di[1].GetString(), di[2].GetString());
             } else if (cmd == "switchGraph") {
                 this->switchGraph(di[1].GetString());
             } else if (cmd == "clearAllState") {
@@ -0,0 +1,159 @@
+#include <zeno/types/PrimitiveObject.h>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+#include <deque>
+#include <map>
+
+namespace zeno {
+
+namespace {
+
+// smaller arrays are left to malloc, which reuses them well already
+constexpr size_t kMinPooled = 64 << 10;
+
+struct Entry {
+    AttributeArray arr;
+    size_t bytes;
+    uint64_t stamp;
+};
+
+int log2floor(size_t n) {
+    int k = 0;
+    while (n >>= 1)
+        k++;
+    return k;
+}
+
+size_t capacityBytes(AttributeArray const &arr) {
+    return std::visit([] (auto const &vec) {
+        return vec.capacity() * sizeof(vec[0]);
+    }, arr);
+}
+
+size_t elementBytes(size_t index) {
+    return std::visit([] (auto const &vec) {
+        return sizeof(vec[0]);
+    }, makeAttributeArray(index, 0));
+}
+
+struct Pool {
+    std::mutex mtx;
+    // by alternative and log2 of the capacity in bytes, a class holding
+    // capacities in [2^k, 2^(k+1)); newest at the back
+    std::map<std::pair<size_t, int>, std::deque<Entry>> classes;
+    uint64_t clock = 0;
+    size_t budget;
+    AttributePoolStats stats;
+
+    Pool() {
+        auto env = getenv("ZEN_POOL_BUDGET");
+        budget = (size_t)std::max(0, env ? atoi(env) : 512) << 20;
+    }
+
+    static Pool &instance() {
+        // never destroyed, primitives held by statics are freed after it
+        static Pool *pool = new Pool;
+        return *pool;
+    }
+
+    bool take(size_t index, int k, size_t size, AttributeArray &res) {
+        auto it = classes.find({index, k});
+        if (it == classes.end())
+            return false;
+        auto &list = it->second;
+        for (auto e = list.rbegin(); e != list.rend(); ++e) {
+            bool fits = std::visit([&] (auto const &vec) {
+                return vec.capacity() >= size;
+            }, e->arr);
+            if (fits) {
+                res = std::move(e->arr);
+                stats.pooled -= e->bytes;
+                list.erase(std::next(e).base());
+                if (list.empty())
+                    classes.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // returns the arrays dropped, to be freed out of the lock
+    std::vector<AttributeArray> evict() {
+        std::vector<AttributeArray> dropped;
+        while (stats.pooled > budget) {
+            auto oldest = classes.begin();
+            for (auto it = classes.begin(); it != classes.end(); ++it)
+                if (it->second.front().stamp < oldest->second.front().stamp)
+                    oldest = it;
+            stats.pooled -= oldest->second.front().bytes;
+            dropped.push_back(std::move(oldest->second.front().arr));
+            oldest->second.pop_front();
+            if (oldest->second.empty())
+                classes.erase(oldest);
+        }
+        return dropped;
+    }
+};
+
+}
+
+ZENO_API AttributeArray acquireAttributeArray(size_t index, size_t size, bool zero) {
+    size_t bytes = size * elementBytes(index);
+    if (bytes < kMinPooled)
+        return makeAttributeArray(index, size);
+
+    auto &pool = Pool::instance();
+    AttributeArray arr;
+    bool hit;
+    {
+        std::lock_guard lck(pool.mtx);
+        int k = log2floor(bytes);
+        // a class above always fits, two above wastes too much
+        hit = pool.take(index, k, size, arr) || pool.take(index, k + 1, size, arr);
+        (hit ? pool.stats.hits : pool.stats.misses)++;
+    }
+    if (!hit)
+        return makeAttributeArray(index, size);
+
+    std::visit([&] (auto &vec) {
+        // shrinking leaves the old contents, growing zeroes the new part
+        vec.resize(size);
+        if (zero)
+            std::fill(vec.begin(), vec.end(), typename std::decay_t<decltype(vec)>::value_type{});
+    }, arr);
+    return arr;
+}
+
+ZENO_API void recycleAttributeArray(AttributeArray &&arr) {
+    size_t bytes = capacityBytes(arr);
+    if (bytes < kMinPooled)
+        return;
+    auto &pool = Pool::instance();
+    std::vector<AttributeArray> dropped;
+    std::lock_guard lck(pool.mtx);
+    if (bytes > pool.budget)
+        return;
+    auto &list = pool.classes[{arr.index(), log2floor(bytes)}];
+    list.push_back({std::move(arr), bytes, pool.clock++});
+    pool.stats.pooled += bytes;
+    dropped = pool.evict();
+}
+
+ZENO_API AttributePoolStats getAttributePoolStats() {
+    auto &pool = Pool::instance();
+    std::lock_guard lck(pool.mtx);
+    return pool.stats;
+}
+
+ZENO_API void trimAttributePool() {
+    auto &pool = Pool::instance();
+    decltype(pool.classes) classes;
+    {
+        std::lock_guard lck(pool.mtx);
+        std::swap(classes, pool.classes);
+        pool.stats.pooled = 0;
+    }
+}
+
+}
@@ -0,0 +1,630 @@
+#include <zeno/types/BVHObject.h>
+#include <zeno/types/PrimitiveObject.h>
+#include <zeno/utils/parallel.h>
+#include <algorithm>
+#include <numeric>
+#include <atomic>
+#include <cmath>
+
+namespace zeno {
+
+namespace {
+
+constexpr float inf = BVHObject::inf;
+constexpr int kBins = 16;
+// leaves have up to kMinLeaf elements, or up to kMaxLeaf by SAH
+constexpr size_t kMinLeaf = 2;
+constexpr size_t kMaxLeaf = 8;
+// below that, splits are object medians, bounding the depth for the stacks
+constexpr int kMaxSahDepth = 48;
+constexpr int kStackSize = 128;
+// larger nodes have their subtrees built and their bins filled in parallel
+constexpr size_t kForkSize = 4096;
+constexpr size_t kChunk = 16384;
+
+struct Box {
+    vec3f bmin{inf}, bmax{-inf};
+
+    void grow(vec3f const &p) {
+        for (int k = 0; k < 3; k++) {
+            bmin[k] = std::min(bmin[k], p[k]);
+            bmax[k] = std::max(bmax[k], p[k]);
+        }
+    }
+
+    void grow(Box const &b) {
+        for (int k = 0; k < 3; k++) {
+            bmin[k] = std::min(bmin[k], b.bmin[k]);
+            bmax[k] = std::max(bmax[k], b.bmax[k]);
+        }
+    }
+
+    float area() const {
+        auto d = bmax - bmin;
+        return d[0] < 0 ? 0 : d[0] * d[1] + d[1] * d[2] + d[2] * d[0];
+    }
+};
+
+Box elementBox(BVHObject const &bvh, int id) {
+    Box box;
+    switch (bvh.kind) {
+    case BVHObject::Tris:
+        for (int k = 0; k < 3; k++)
+            box.grow(bvh.pos[bvh.tris[id][k]]);
+        break;
+    case BVHObject::Lines:
+        for (int k = 0; k < 2; k++)
+            box.grow(bvh.pos[bvh.lines[id][k]]);
+        break;
+    case BVHObject::Points:
+        box.grow(bvh.pos[bvh.points[id]]);
+        break;
+    }
+    return box;
+}
+
+vec3f closestOnSegment(vec3f const &p, vec3f const &a, vec3f const &b) {
+    auto ab = b - a;
+    float len2 = dot(ab, ab);
+    if (!(len2 > 0))
+        return a;
+    float t = std::clamp(dot(p - a, ab) / len2, 0.f, 1.f);
+    return a + t * ab;
+}
+
+// from Ericson, Real-Time Collision Detection, 5.1.5
+vec3f closestOnTriangle(vec3f const &p, vec3f const &a, vec3f const &b, vec3f const &c) {
+    auto ab = b - a, ac = c - a, ap = p - a;
+    float d1 = dot(ab, ap), d2 = dot(ac, ap);
+    if (d1 <= 0 && d2 <= 0)
+        return a;
+    auto bp = p - b;
+    float d3 = dot(ab, bp), d4 = dot(ac, bp);
+    if (d3 >= 0 && d4 <= d3)
+        return b;
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0 && d1 >= 0 && d3 <= 0)
+        return a + d1 / (d1 - d3) * ab;
+    auto cp = p - c;
+    float d5 = dot(ab, cp), d6 = dot(ac, cp);
+    if (d6 >= 0 && d5 <= d6)
+        return c;
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0 && d2 >= 0 && d6 <= 0)
+        return a + d2 / (d2 - d6) * ac;
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0)
+        return b + (d4 - d3) / ((d4 - d3) + (d5 - d6)) * (c - b);
+    float sum = va + vb + vc;
+    if (!(sum > 0)) {
+        // degenerate, the closest of its edges
+        vec3f best = closestOnSegment(p, a, b);
+        for (auto q: {closestOnSegment(p, b, c), closestOnSegment(p, c, a)})
+            if (dot(q - p, q - p) < dot(best - p, best - p))
+                best = q;
+        return best;
+    }
+    return a + vb / sum * ab + vc / sum * ac;
+}
+
+vec3f closestOn(BVHObject const &bvh, int id, vec3f const &p) {
+    auto const &pos = bvh.pos;
+    switch (bvh.kind) {
+    case BVHObject::Tris: {
+        auto const &t = bvh.tris[id];
+        return closestOnTriangle(p, pos[t[0]], pos[t[1]], pos[t[2]]);
+    }
+    case BVHObject::Lines: {
+        auto const &l = bvh.lines[id];
+        return closestOnSegment(p, pos[l[0]], pos[l[1]]);
+    }
+    default:
+        return pos[bvh.points[id]];
+    }
+}
+
+float boxDist2(BVHObject::Node const &node, vec3f const &p) {
+    float res = 0;
+    for (int k = 0; k < 3; k++) {
+        float d = std::max({node.bmin[k] - p[k], p[k] - node.bmax[k], 0.f});
+        res += d * d;
+    }
+    return res;
+}
+
+// entry distance of the ray into the box, inf on a miss
+float rayBox(BVHObject::Node const &node, vec3f const &org, vec3f const &inv, float tmax) {
+    float t0 = 0, t1 = tmax;
+    for (int k = 0; k < 3; k++) {
+        float a = (node.bmin[k] - org[k]) * inv[k];
+        float b = (node.bmax[k] - org[k]) * inv[k];
+        // with t0 and t1 first, they stay as they were on the NaNs of rays
+        // in the plane of a slab
+        t0 = std::max(t0, std::min(a, b));
+        t1 = std::min(t1, std::max(a, b));
+    }
+    return t0 <= t1 ? t0 : inf;
+}
+
+// Moller-Trumbore, t or inf on a miss
+float rayTriangle(vec3f const &org, vec3f const &dir,
+        vec3f const &a, vec3f const &b, vec3f const &c) {
+    auto e1 = b - a, e2 = c - a;
+    auto pv = cross(dir, e2);
+    float det = dot(e1, pv);
+    if (det == 0)
+        return inf;
+    float inv = 1 / det;
+    auto tv = org - a;
+    float u = dot(tv, pv) * inv;
+    if (u < 0 || u > 1)
+        return inf;
+    auto qv = cross(tv, e1);
+    float v = dot(dir, qv) * inv;
+    if (v < 0 || u + v > 1)
+        return inf;
+    float t = dot(e2, qv) * inv;
+    return t >= 0 ? t : inf;
+}
+
+// solid angle of the triangle seen from the origin, Van Oosterom and Strackee
+float solidAngle(vec3f const &a, vec3f const &b, vec3f const &c) {
+    float la = length(a), lb = length(b), lc = length(c);
+    float num = dot(a, cross(b, c));
+    float den = la * lb * lc + dot(a, b) * lc + dot(b, c) * la + dot(c, a) * lb;
+    return 2 * std::atan2(num, den);
+}
+
+struct Builder {
+    // partitioned in place of the ids, so that passes over a node are
+    // sequential rather than scattered over the elements
+    struct Ref {
+        Box box;
+        vec3f cent;
+        int id;
+    };
+
+    BVHObject &bvh;
+    std::vector<Ref> refs;
+    std::atomic<int> next{1};
+
+    // per axis, fewer of them for small nodes, where initializing all of
+    // them would cost more than binning
+    struct Bins {
+        int nbins;
+        vec3f bmin[3][kBins], bmax[3][kBins];
+        size_t count[3][kBins];
+
+        explicit Bins(int nbins) : nbins(nbins) {
+            for (int a = 0; a < 3; a++) {
+                std::fill_n(bmin[a], nbins, vec3f(inf));
+                std::fill_n(bmax[a], nbins, vec3f(-inf));
+                std::fill_n(count[a], nbins, 0);
+            }
+        }
+
+        Box box(int a, int k) const {
+            return {bmin[a][k], bmax[a][k]};
+        }
+
+        void grow(int a, int k, Box const &box) {
+            for (int c = 0; c < 3; c++) {
+                bmin[a][k][c] = std::min(bmin[a][k][c], box.bmin[c]);
+                bmax[a][k][c] = std::max(bmax[a][k][c], box.bmax[c]);
+            }
+        }
+
+        void merge(Bins const &other) {
+            for (int a = 0; a < 3; a++) {
+                for (int k = 0; k < nbins; k++) {
+                    grow(a, k, other.box(a, k));
+                    count[a][k] += other.count[a][k];
+                }
+            }
+        }
+    };
+
+    explicit Builder(BVHObject &bvh) : bvh(bvh) {
+        size_t n = bvh.size();
+        refs.resize(n);
+        parallel_for(n, [&] (size_t i) {
+            auto box = elementBox(bvh, i);
+            refs[i] = {box, (box.bmin + box.bmax) * 0.5f, (int)i};
+        });
+        // at most n leaves of a full binary tree
+        bvh.nodes.resize(2 * n - 1);
+        build(0, 0, n, 0);
+        bvh.nodes.resize(next);
+        parallel_for(n, [&] (size_t i) {
+            bvh.order[i] = refs[i].id;
+        });
+    }
+
+    void bound(size_t b, size_t e, Box &box, Box &cbox) const {
+        for (size_t i = b; i < e; i++) {
+            box.grow(refs[i].box);
+            cbox.grow(refs[i].cent);
+        }
+    }
+
+    void bin(size_t b, size_t e, Box const &cbox, vec3f const &scale, Bins &bins) const {
+        for (size_t i = b; i < e; i++) {
+            for (int a = 0; a < 3; a++) {
+                int k = binOf(refs[i], a, cbox, scale, bins.nbins);
+                bins.grow(a, k, refs[i].box);
+                bins.count[a][k]++;
+            }
+        }
+    }
+
+    static int binOf(Ref const &ref, int a, Box const &cbox, vec3f const &scale, int nbins) {
+        return std::clamp(int((ref.cent[a] - cbox.bmin[a]) * scale[a]), 0, nbins - 1);
+    }
+
+    // runs f on kChunk sized pieces of [b, e) in parallel, then merges
+    template <class T, class F, class Merge>
+    void chunked(size_t b, size_t e, T &res, F const &f, Merge const &merge) const {
+        if (e - b <= kChunk) {
+            f(b, e, res);
+            return;
+        }
+        size_t nchunks = (e - b + kChunk - 1) / kChunk;
+        std::vector<T> partial(nchunks, res);
+        parallel_for(nchunks, [&] (size_t c) {
+            f(b + c * kChunk, std::min(e, b + (c + 1) * kChunk), partial[c]);
+        }, 1);
+        for (auto const &val: partial)
+            merge(res, val);
+    }
+
+    size_t median(size_t b, size_t e, int axis) {
+        auto first = refs.begin();
+        std::nth_element(first + b, first + (b + e) / 2, first + e,
+            [&] (Ref const &r, Ref const &s) { return r.cent[axis] < s.cent[axis]; });
+        return (b + e) / 2;
+    }
+
+    // where to split refs[b, e), or b for a leaf
+    size_t split(Box const &box, Box const &cbox, size_t b, size_t e, int depth) {
+        size_t n = e - b;
+        if (n <= kMinLeaf)
+            return b;
+        auto ext = cbox.bmax - cbox.bmin;
+        int axis = ext[0] > ext[1] ? (ext[0] > ext[2] ? 0 : 2) : (ext[1] > ext[2] ? 1 : 2);
+        if (!(ext[axis] > 0))  // coincident centroids, nothing to sort by
+            return n <= kMaxLeaf ? b : (b + e) / 2;
+        if (depth >= kMaxSahDepth)
+            return median(b, e, axis);
+
+        int nbins = (int)std::min<size_t>(kBins, n);
+        vec3f scale;
+        for (int a = 0; a < 3; a++)
+            scale[a] = ext[a] > 0 ? nbins / ext[a] : 0;
+        Bins bins(nbins);
+        chunked(b, e, bins, [&] (size_t b, size_t e, Bins &bins) {
+            bin(b, e, cbox, scale, bins);
+        }, [] (Bins &res, Bins const &bins) {
+            res.merge(bins);
+        });
+
+        // SAH with unit costs for traversal and elements, times node area
+        float bestCost = inf;
+        int bestAxis = -1, bestBin = 0;
+        for (int a = 0; a < 3; a++) {
+            if (!(ext[a] > 0))
+                continue;
+            float rightCost[kBins];
+            Box acc;
+            size_t cnt = 0;
+            for (int k = nbins - 1; k > 0; k--) {
+                acc.grow(bins.box(a, k));
+                cnt += bins.count[a][k];
+                rightCost[k] = acc.area() * cnt;
+            }
+            acc = Box();
+            cnt = 0;
+            for (int k = 0; k < nbins - 1; k++) {
+                acc.grow(bins.box(a, k));
+                cnt += bins.count[a][k];
+                if (!cnt || cnt == n)
+                    continue;
+                float cost = acc.area() * cnt + rightCost[k + 1];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = a;
+                    bestBin = k;
+                }
+            }
+        }
+        if (n <= kMaxLeaf && box.area() + bestCost >= box.area() * n)
+            return b;
+        if (bestAxis < 0)
+            return median(b, e, axis);
+
+        auto first = refs.begin();
+        size_t mid = std::partition(first + b, first + e, [&] (Ref const &ref) {
+            return binOf(ref, bestAxis, cbox, scale, nbins) <= bestBin;
+        }) - first;
+        if (mid == b || mid == e)
+            return median(b, e, axis);
+        return mid;
+    }
+
+    void build(int ni, size_t b, size_t e, int depth) {
+        Box box, cbox;
+        using Bounds = std::pair<Box, Box>;
+        Bounds bounds;
+        chunked(b, e, bounds, [&] (size_t b, size_t e, Bounds &res) {
+            bound(b, e, res.first, res.second);
+        }, [] (Bounds &res, Bounds const &val) {
+            res.first.grow(val.first);
+            res.second.grow(val.second);
+        });
+        std::tie(box, cbox) = bounds;
+
+        auto &node = bvh.nodes[ni];
+        node.bmin = box.bmin;
+        node.bmax = box.bmax;
+        size_t mid = split(box, cbox, b, e, depth);
+        if (mid == b) {
+            node.start = b;
+            node.count = e - b;
+            return;
+        }
+        int c = next.fetch_add(2);
+        node.start = c;
+        node.count = 0;
+        auto child = [&] (size_t k) {
+            if (k)
+                build(c + 1, mid, e, depth + 1);
+            else
+                build(c, b, mid, depth + 1);
+        };
+        if (e - b > kForkSize) {
+            parallel_for(2, child, 1);
+        } else {
+            child(0);
+            child(1);
+        }
+    }
+};
+
+// bounds and winding number data of leaves from positions, then of inner
+// nodes from their children, which come after them
+void updateNodes(BVHObject &bvh) {
+    auto &nodes = bvh.nodes;
+    parallel_for(nodes.size(), [&] (size_t ni) {
+        auto &node = nodes[ni];
+        if (!node.count)
+            return;
+        Box box;
+        vec3f area_n(0), center(0);
+        float area = 0;
+        for (int i = node.start; i < node.start + node.count; i++) {
+            int id = bvh.order[i];
+            box.grow(elementBox(bvh, id));
+            if (bvh.kind == BVHObject::Tris) {
+                auto const &t = bvh.tris[id];
+                auto a = bvh.pos[t[0]], b = bvh.pos[t[1]], c = bvh.pos[t[2]];
+                auto an = 0.5f * cross(b - a, c - a);
+                float w = length(an);
+                area_n += an;
+                center += w * (a + b + c) / 3.f;
+                area += w;
+            }
+        }
+        node.bmin = box.bmin;
+        node.bmax = box.bmax;
+        node.area_n = area_n;
+        node.area = area;
+        node.center = area > 0 ? center / area : (box.bmin + box.bmax) * 0.5f;
+        node.radius = length(box.bmax - box.bmin);
+        if (bvh.kind == BVHObject::Tris) {
+            float r = 0;
+            for (int i = node.start; i < node.start + node.count; i++)
+                for (int k = 0; k < 3; k++)
+                    r = std::max(r, length(bvh.pos[bvh.tris[bvh.order[i]][k]] - node.center));
+            node.radius = r;
+        }
+    }, 1024);
+    for (size_t ni = nodes.size(); ni-- > 0;) {
+        auto &node = nodes[ni];
+        if (node.count)
+            continue;
+        auto const &l = nodes[node.start], &r = nodes[node.start + 1];
+        node.bmin = zeno::min(l.bmin, r.bmin);
+        node.bmax = zeno::max(l.bmax, r.bmax);
+        node.area_n = l.area_n + r.area_n;
+        node.area = l.area + r.area;
+        node.center = node.area > 0
+            ? (l.area * l.center + r.area * r.center) / node.area
+            : (l.center + r.center) * 0.5f;
+        node.radius = std::max(length(l.center - node.center) + l.radius,
+                               length(r.center - node.center) + r.radius);
+    }
+}
+
+// vec == compares per component
+template <class T>
+bool sameElements(std::vector<T> const &a, std::vector<T> const &b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+        [] (T const &x, T const &y) { return zeno::all(x == y); });
+}
+
+std::vector<vec3f> positions(PrimitiveObject const *prim) {
+    if (!prim->has_attr("pos"))
+        return std::vector<vec3f>(prim->size());
+    if (prim->attr_is<vec3f>("pos"))
+        return prim->read_attr<vec3f>("pos");
+    return prim->attr_as<vec3f>("pos");
+}
+
+}
+
+ZENO_API void BVHObject::build(PrimitiveObject const *prim, Kind kind) {
+    this->kind = kind;
+    pos = positions(prim);
+    tris.clear();
+    lines.clear();
+    points.clear();
+    size_t n;
+    switch (kind) {
+    case Tris: tris = prim->tris; n = tris.size(); break;
+    case Lines: lines = prim->lines; n = lines.size(); break;
+    default:
+        // every vertex when it has no points
+        points = prim->points;
+        if (points.empty()) {
+            points.resize(pos.size());
+            std::iota(points.begin(), points.end(), 0);
+        }
+        n = points.size();
+        break;
+    }
+    order.resize(n);
+    std::iota(order.begin(), order.end(), 0);
+    nodes.clear();
+    if (n) {
+        Builder builder(*this);
+        updateNodes(*this);
+    }
+}
+
+ZENO_API bool BVHObject::refit(PrimitiveObject const *prim) {
+    if (prim->size() != pos.size())
+        return false;
+    switch (kind) {
+    case Tris: if (!sameElements(prim->tris, tris)) return false; break;
+    case Lines: if (!sameElements(prim->lines, lines)) return false; break;
+    default:
+        if (prim->points.empty() ? points.size() != pos.size() : prim->points != points)
+            return false;
+        break;
+    }
+    pos = positions(prim);
+    updateNodes(*this);
+    return true;
+}
+
+ZENO_API BVHObject::Nearest BVHObject::nearest(vec3f const &p, float maxDist) const {
+    Nearest res;
+    if (nodes.empty())
+        return res;
+    float best = maxDist * maxDist;
+    int stack[kStackSize], top = 0;
+    stack[top++] = 0;
+    while (top) {
+        auto const &node = nodes[stack[--top]];
+        if (boxDist2(node, p) > best)
+            continue;
+        if (node.count) {
+            for (int i = node.start; i < node.start + node.count; i++) {
+                auto q = closestOn(*this, order[i], p);
+                float d2 = dot(q - p, q - p);
+                if (d2 <= best) {
+                    best = d2;
+                    res.id = order[i];
+                    res.pos = q;
+                }
+            }
+            continue;
+        }
+        // nearer child on top
+        float dl = boxDist2(nodes[node.start], p);
+        float dr = boxDist2(nodes[node.start + 1], p);
+        bool nearLeft = dl <= dr;
+        stack[top++] = node.start + nearLeft;
+        stack[top++] = node.start + !nearLeft;
+    }
+    if (res.id >= 0)
+        res.dist = std::sqrt(best);
+    return res;
+}
+
+ZENO_API BVHObject::Hit BVHObject::intersect(vec3f const &org, vec3f const &dir, float tmax) const {
+    Hit res;
+    if (nodes.empty() || kind != Tris)
+        return res;
+    res.t = tmax;
+    vec3f inv(1 / dir[0], 1 / dir[1], 1 / dir[2]);
+    int stack[kStackSize], top = 0;
+    stack[top++] = 0;
+    while (top) {
+        auto const &node = nodes[stack[--top]];
+        if (rayBox(node, org, inv, res.t) == inf)
+            continue;
+        if (node.count) {
+            for (int i = node.start; i < node.start + node.count; i++) {
+                auto const &t = tris[order[i]];
+                float th = rayTriangle(org, dir, pos[t[0]], pos[t[1]], pos[t[2]]);
+                if (th < res.t) {
+                    res.t = th;
+                    res.id = order[i];
+                }
+            }
+            continue;
+        }
+        float tl = rayBox(nodes[node.start], org, inv, res.t);
+        float tr = rayBox(nodes[node.start + 1], org, inv, res.t);
+        bool nearLeft = tl <= tr;
+        stack[top++] = node.start + nearLeft;
+        stack[top++] = node.start + !nearLeft;
+    }
+    if (res.id < 0)
+        res.t = inf;
+    return res;
+}
+
+ZENO_API int BVHObject::countWithin(vec3f const &p, float radius) const {
+    int res = 0;
+    if (nodes.empty())
+        return res;
+    float r2 = radius * radius;
+    int stack[kStackSize], top = 0;
+    stack[top++] = 0;
+    while (top) {
+        auto const &node = nodes[stack[--top]];
+        if (boxDist2(node, p) >= r2)
+            continue;
+        if (node.count) {
+            for (int i = node.start; i < node.start + node.count; i++) {
+                auto q = closestOn(*this, order[i], p);
+                res += dot(q - p, q - p) < r2;
+            }
+            continue;
+        }
+        stack[top++] = node.start;
+        stack[top++] = node.start + 1;
+    }
+    return res;
+}
+
+ZENO_API float BVHObject::winding(vec3f const &p, float beta) const {
+    if (nodes.empty() || kind != Tris)
+        return 0;
+    float res = 0;
+    int stack[kStackSize], top = 0;
+    stack[top++] = 0;
+    while (top) {
+        auto const &node = nodes[stack[--top]];
+        auto d = node.center - p;
+        float r = length(d);
+        if (r > beta * node.radius) {
+            // far away the triangles below act as one dipole
+            res += dot(d, node.area_n) / (r * r * r);
+            continue;
+        }
+        if (node.count) {
+            for (int i = node.start; i < node.start + node.count; i++) {
+                auto const &t = tris[order[i]];
+                res += solidAngle(pos[t[0]] - p, pos[t[1]] - p, pos[t[2]] - p);
+            }
+            continue;
+        }
+        stack[top++] = node.start;
+        stack[top++] = node.start + 1;
+    }
+    return res / (4 * 3.14159265f);
+}
+
+}
@@ -0,0 +1,153 @@
+#ifdef ZENO_GLOBALSTATE
+#include <zeno/extra/Checkpoint.h>
+#include <zeno/extra/ObjectCodec.h>
+#include <zeno/extra/GlobalState.h>
+#include <zeno/core/Scene.h>
+#include <zeno/core/Graph.h>
+#include <zeno/utils/Exception.h>
+#include <zeno/utils/filesystem.h>
+#include <zeno/utils/zlog.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+
+namespace zeno {
+
+static const char magic[8] = {'\x7f', 'Z', 'C', 'K', 'v', '0', '0', '1'};
+
+ZENO_API bool saveCheckpoint(Scene &scene, std::string const &path) {
+    auto const &state = *scene.globalState;
+    ObjectBuffer out;
+    out.write(magic, sizeof(magic));
+    out.put(state.frameid);
+    out.put(state.substepid);
+    out.put(state.frame_time);
+    out.put(state.frame_time_elapsed);
+    out.put(state.has_frame_completed);
+    out.put(state.has_substep_executed);
+    out.put(state.time_step_integrated);
+
+    out.put<uint64_t>(scene.graphs.size());
+    for (auto const &[name, graph]: scene.graphs) {
+        out.putString(name);
+        if (!graph->saveState(out)) {
+            zlog::warning("no checkpoint at frame {}", state.frameid);
+            return false;
+        }
+    }
+
+    // a crash while writing must not lose the previous checkpoint
+    auto tmp = path + ".tmp";
+    {
+        std::ofstream fout(tmp, std::ios::binary);
+        fout.write(out.data.data(), out.data.size());
+        if (!fout)
+            throw Exception("cannot write checkpoint " + tmp);
+    }
+    fs::rename(tmp, path);
+    return true;
+}
+
+ZENO_API void loadCheckpoint(Scene &scene, std::string const &path) {
+    std::ifstream fin(path, std::ios::binary);
+    if (!fin)
+        throw Exception("cannot open checkpoint " + path);
+    std::stringstream ss;
+    ss << fin.rdbuf();
+    auto data = ss.str();
+
+    auto &state = *scene.globalState;
+    try {
+        ObjectReader in(data.data(), data.data() + data.size());
+        char sig[sizeof(magic)];
+        in.read(sig, sizeof(sig));
+        if (memcmp(sig, magic, sizeof(magic)))
+            throw ObjectReader::BadData{};
+        state.frameid = in.get<int>();
+        state.substepid = in.get<int>();
+        state.frame_time = in.get<float>();
+        state.frame_time_elapsed = in.get<float>();
+        state.has_frame_completed = in.get<bool>();
+        state.has_substep_executed = in.get<bool>();
+        state.time_step_integrated = in.get<bool>();
+        state.objid = 0;
+        state.exported.clear();
+
+        auto ngraphs = in.get<uint64_t>();
+        for (uint64_t i = 0; i < ngraphs; i++) {
+            auto name = in.getString();
+            auto it = scene.graphs.find(name);
+            if (it == scene.graphs.end())
+                throw Exception("checkpoint has a graph `" + name
+                        + "` not loaded, was it renamed?");
+            it->second->loadState(in);
+        }
+    } catch (ObjectReader::BadData const &) {
+        throw Exception("checkpoint " + path + " is corrupted");
+    }
+}
+
+static int env_int(const char *name, int defl) {
+    auto val = getenv(name);
+    return val ? atoi(val) : defl;
+}
+
+ZENO_API std::string checkpointPath(Scene &scene, int frameid) {
+    char buf[100];
+    sprintf(buf, "%06d.zckpt", frameid);
+    return (fs::path(scene.globalState->iopath) / "checkpoints" / buf).string();
+}
+
+static std::vector<fs::path> listCheckpoints(Scene &scene) {
+    std::vector<fs::path> res;
+    std::error_code ec;
+    auto dir = fs::path(scene.globalState->iopath) / "checkpoints";
+    for (auto const &ent: fs::directory_iterator(dir, ec)) {
+        if (ent.path().extension() == ".zckpt")
+            res.push_back(ent.path());
+    }
+    std::sort(res.begin(), res.end());  // zero-padded frame numbers
+    return res;
+}
+
+ZENO_API void checkpointFrame(Scene &scene) {
+    int every = env_int("ZEN_CHECKPOINT", 0);
+    int frameid = scene.globalState->frameid;  // the next one
+    if (every <= 0 || frameid % every != 0)
+        return;
+    auto path = checkpointPath(scene, frameid);
+    fs::create_directories(fs::path(path).parent_path());
+    if (!saveCheckpoint(scene, path))
+        return;
+    auto paths = listCheckpoints(scene);
+    int keep = std::max(1, env_int("ZEN_CHECKPOINT_KEEP", 2));
+    for (int i = 0; i + keep < (int)paths.size(); i++) {
+        std::error_code ec;
+        fs::remove(paths[i], ec);
+    }
+}
+
+ZENO_API int resumeFrame(Scene &scene) {
+    auto resume = getenv("ZEN_RESUME");
+    if (!resume || !*resume)
+        return 0;
+    std::string path;
+    if (!strcmp(resume, "latest")) {
+        auto paths = listCheckpoints(scene);
+        if (paths.empty())
+            throw Exception("no checkpoint to resume from in "
+                    + scene.globalState->iopath);
+        path = paths.back().string();
+    } else {
+        path = checkpointPath(scene, atoi(resume));
+    }
+    loadCheckpoint(scene, path);
+    zlog::info("resuming from {}", path);
+    return scene.globalState->frameid;
+}
+
+}
+#endif
@@ -0,0 +1,355 @@
+#include <zeno/extra/DiskCache.h>
+#include <zeno/core/INode.h>
+#include <zeno/core/Session.h>
+#include <zeno/extra/ObjectCodec.h>
+#include <zeno/types/PrimitiveObject.h>
+#include <zeno/utils/filesystem.h>
+#include <zeno/utils/zlog.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <array>
+#include <vector>
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace zeno {
+
+namespace {
+
+// bump when the layout below, or ObjectCodec's, changes; old entries then
+// just miss
+const char magic[8] = {'\x7f', 'Z', 'C', 'A', 'v', '0', '0', '2'};
+
+// 128-bit streaming hash, two multiply-rotate lanes with a murmur3
+// finalizer; not cryptographic, but wide enough for content addressing
+struct Hasher : ObjectSink {
+    uint64_t h1 = 0x9e3779b97f4a7c15ull;
+    uint64_t h2 = 0xc2b2ae3d27d4eb4full;
+    uint64_t len = 0;
+    unsigned char tail[8];
+    size_t ntail = 0;
+
+    static uint64_t rotl(uint64_t x, int r) {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    static uint64_t fmix(uint64_t k) {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdull;
+        k ^= k >> 33;
+        k *= 0xc4ceb9fe1a85ec53ull;
+        k ^= k >> 33;
+        return k;
+    }
+
+    void word(uint64_t w) {
+        h1 = rotl(h1 ^ (w * 0x87c37b91114253d5ull), 31) * 0x4cf5ad432745937full;
+        h2 = rotl(h2 ^ (w * 0x4cf5ad432745937full), 27) * 0x87c37b91114253d5ull + h1;
+    }
+
+    virtual void write(const void *data, size_t n) override {
+        auto p = (const unsigned char *)data;
+        len += n;
+        if (ntail) {
+            size_t m = std::min(n, 8 - ntail);
+            memcpy(tail + ntail, p, m);
+            ntail += m;
+            p += m;
+            n -= m;
+            if (ntail < 8)
+                return;
+            uint64_t w;
+            memcpy(&w, tail, 8);
+            word(w);
+            ntail = 0;
+        }
+        for (; n >= 8; p += 8, n -= 8) {
+            uint64_t w;
+            memcpy(&w, p, 8);
+            word(w);
+        }
+        memcpy(tail + ntail, p, n);
+        ntail += n;
+    }
+
+    virtual void putAttribute(AttributeBuffer const &buf) override;
+
+    std::array<uint64_t, 2> digest() {
+        uint64_t w = 0;
+        memcpy(&w, tail, ntail);
+        word(w ^ len);
+        return {fmix(h1 ^ h2), fmix(h2 + h1)};
+    }
+
+    std::string hex() {
+        auto res = digest();
+        char buf[33];
+        snprintf(buf, sizeof(buf), "%016llx%016llx",
+                (unsigned long long)res[0], (unsigned long long)res[1]);
+        return buf;
+    }
+};
+
+// digests of large attribute buffers, so that inputs unchanged since the
+// last key aren't hashed again: valid while the storage lives and its
+// version is the same, writers bump it; the storage isn't held, so its
+// owners still write in-place and free or recycle it as usual
+constexpr size_t kMinDigested = 64 << 10;
+
+struct DigestCache {
+    struct Entry {
+        std::weak_ptr<AttributeArray> storage;
+        uint64_t version = 0;
+        std::array<uint64_t, 2> digest{};
+    };
+
+    std::mutex mtx;
+    std::map<AttributeArray const *, Entry> digests;
+
+    static DigestCache &instance() {
+        static DigestCache cache;
+        return cache;
+    }
+
+    std::array<uint64_t, 2> get(AttributeBuffer const &buf) {
+        {
+            std::lock_guard lck(mtx);
+            for (auto it = digests.begin(); it != digests.end();) {
+                if (it->second.storage.expired())
+                    it = digests.erase(it);
+                else
+                    ++it;
+            }
+            if (auto it = digests.find(buf.m_ptr.get()); it != digests.end()
+                    && it->second.version == buf.m_version)
+                return it->second.digest;
+        }
+        Hasher h;
+        h.ObjectSink::putAttribute(buf);
+        auto res = h.digest();
+        std::lock_guard lck(mtx);
+        digests[buf.m_ptr.get()] = Entry{buf.m_ptr, buf.m_version, res};
+        return res;
+    }
+};
+
+void Hasher::putAttribute(AttributeBuffer const &buf) {
+    auto bytes = std::visit([] (auto const &arr) {
+        return arr.size() * sizeof(arr[0]);
+    }, buf.read());
+    if (bytes < kMinDigested)
+        return ObjectSink::putAttribute(buf);
+    put<uint8_t>(buf.read().index());
+    put(DigestCache::instance().get(buf));
+}
+
+int envInt(const char *name, int defl) {
+    auto val = getenv(name);
+    return val ? atoi(val) : defl;
+}
+
+}
+
+ZENO_API DiskCache::DiskCache() {
+    if (auto path = getenv("ZEN_CACHEDIR")) {
+        dir = path;
+    } else {
+        std::error_code ec;
+        dir = (fs::temp_directory_path(ec) / "zeno-cache").string();
+    }
+    budget = (size_t)std::max(0, envInt("ZEN_CACHE_BUDGET", 4096)) << 20;
+}
+
+ZENO_API std::string DiskCache::nodeKey(INode const *node) const {
+    auto cls = node->nodeClass;
+    // lazy nodes don't get all inputs, serial ones touch global state
+    if (cls->desc->has_trait("lazy") || cls->desc->has_trait("serial")) {
+        zlog::warning("`{}` ({}) can't be cached", node->myname, cls->name);
+        return {};
+    }
+    Hasher h;
+    h.write(magic, sizeof(magic));
+    h.putString(cls->name);
+    for (auto const &[key, val]: node->params) {
+        h.putString(key);
+        h.put<uint8_t>(val.index());
+        std::visit([&] (auto const &val) {
+            if constexpr (std::is_same_v<std::decay_t<decltype(val)>, std::string>)
+                h.putString(val);
+            else
+                h.put(val);
+        }, val);
+    }
+    for (auto const &[key, obj]: node->inputs) {
+        h.putString(key);
+        if (!encodeObject(h, obj.get())) {
+            zlog::warning("`{}` can't be cached, its input `{}` can't be hashed",
+                    node->myname, key);
+            return {};
+        }
+    }
+    return h.hex();
+}
+
+ZENO_API bool DiskCache::load(std::string const &key, Outputs &outputs) {
+    auto path = fs::path(dir) / (key + ".zcache");
+    std::ifstream fin(path, std::ios::binary);
+    if (!fin)
+        return false;
+    std::stringstream ss;
+    ss << fin.rdbuf();
+    fin.close();
+    auto data = ss.str();
+
+    Outputs res;
+    try {
+        ObjectReader in(data.data(), data.data() + data.size());
+        char sig[sizeof(magic)];
+        in.read(sig, sizeof(sig));
+        if (memcmp(sig, magic, sizeof(magic)))
+            throw ObjectReader::BadData{};
+        auto n = in.get<uint64_t>();
+        for (uint64_t i = 0; i < n; i++) {
+            auto name = in.getString();
+            res[name] = decodeObject(in);
+        }
+    } catch (ObjectReader::BadData const &) {
+        zlog::warning("removing corrupted cache entry {}", path.string());
+        std::error_code ec;
+        fs::remove(path, ec);
+        std::lock_guard lck(m_mtx);
+        touchLocked(key, 0);
+        return false;
+    }
+    for (auto &[name, obj]: res)
+        outputs[name] = std::move(obj);
+
+    std::error_code ec;  // most recently used, for the next listing
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    std::lock_guard lck(m_mtx);
+    touchLocked(key, data.size());
+    return true;
+}
+
+ZENO_API void DiskCache::store(std::string const &key, Outputs const &outputs) {
+    ObjectBuffer buf;
+    buf.write(magic, sizeof(magic));
+    uint64_t n = 0;
+    for (auto const &[name, obj]: outputs)
+        n += obj && name != "DST";  // ours, set by doComplete
+    buf.put(n);
+    for (auto const &[name, obj]: outputs) {
+        if (!obj || name == "DST")
+            continue;
+        buf.putString(name);
+        if (!encodeObject(buf, obj.get())) {
+            zlog::warning("output `{}` can't be cached", name);
+            return;
+        }
+    }
+    if (buf.data.size() > budget)
+        return;
+
+    // written aside then renamed, so that other processes sharing the
+    // directory never see partial entries
+    static std::atomic<int> counter{0};
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    auto path = fs::path(dir) / (key + ".zcache");
+    auto tmp = fs::path(dir) / (key + "." + std::to_string(getpid())
+            + "." + std::to_string(counter++) + ".tmp");
+    {
+        std::ofstream fout(tmp, std::ios::binary);
+        fout.write(buf.data.data(), buf.data.size());
+        if (!fout) {
+            zlog::warning("cannot write cache entry {}", tmp.string());
+            fout.close();
+            fs::remove(tmp, ec);
+            return;
+        }
+    }
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        fs::remove(tmp, ec);
+        return;
+    }
+    std::lock_guard lck(m_mtx);
+    touchLocked(key, buf.data.size());
+    evictLocked();
+}
+
+ZENO_API void DiskCache::evict() {
+    std::lock_guard lck(m_mtx);
+    scanLocked();
+    evictLocked();
+}
+
+void DiskCache::scanLocked() {
+    if (m_scanned == dir)
+        return;
+    struct Listed {
+        fs::file_time_type mtime;
+        size_t size;
+        std::string key;
+    };
+    std::vector<Listed> listed;
+    std::error_code ec;
+    for (auto const &ent: fs::directory_iterator(dir, ec)) {
+        if (ent.path().extension() != ".zcache")
+            continue;
+        std::error_code ec;
+        auto size = ent.file_size(ec);
+        auto mtime = ent.last_write_time(ec);
+        if (ec)
+            continue;  // evicted by another process
+        listed.push_back({mtime, size, ent.path().stem().string()});
+    }
+    std::sort(listed.begin(), listed.end(), [] (auto const &a, auto const &b) {
+        return a.mtime < b.mtime;
+    });
+    m_scanned = dir;
+    m_entries.clear();
+    m_lru.clear();
+    m_total = 0;
+    for (auto const &ent: listed)
+        touchLocked(ent.key, ent.size);
+}
+
+// most recently used now, or gone if size is 0
+void DiskCache::touchLocked(std::string const &key, size_t size) {
+    scanLocked();
+    if (auto it = m_entries.find(key); it != m_entries.end()) {
+        m_total -= it->second.size;
+        m_lru.erase(it->second.lru);
+        m_entries.erase(it);
+    }
+    if (!size)
+        return;
+    m_entries.emplace(key, Entry{size, m_lru.insert(m_lru.end(), key)});
+    m_total += size;
+}
+
+void DiskCache::evictLocked() {
+    while (m_total > budget && !m_lru.empty()) {
+        auto key = m_lru.front();
+        std::error_code ec;
+        fs::remove(fs::path(dir) / (key + ".zcache"), ec);
+        touchLocked(key, 0);
+    }
+}
+
+ZENO_API DiskCache &getDiskCache() {
+    static DiskCache cache;
+    return cache;
+}
+
+}
@@ -0,0 +1,342 @@
+#include <zeno/extra/FrameExpr.h>
+#include <charconv>
+#include <cstdlib>
+#include <cstdio>
+#include <cctype>
+#include <cmath>
+#include <vector>
+
+namespace zeno {
+
+namespace {
+
+struct BadExpr {};
+
+struct Value {
+    bool isint = true;
+    long long i = 0;
+    double f = 0;
+
+    double real() const {
+        return isint ? (double)i : f;
+    }
+
+    static Value of(long long i) {
+        Value v;
+        v.i = i;
+        return v;
+    }
+
+    static Value of(double f) {
+        Value v;
+        v.isint = false;
+        v.f = f;
+        return v;
+    }
+};
+
+// recursive descent over the python expression subset we support:
+//   sum := term (('+' | '-') term)*
+//   term := unary (('*' | '/' | '//' | '%') unary)*
+//   unary := ('+' | '-') unary | power
+//   power := atom ('**' unary)?
+//   atom := number | 'frame' | func '(' sum (',' sum)* ')' | '(' sum ')'
+struct Parser {
+    const char *p;
+    int frame;
+
+    void skip() {
+        while (*p == ' ' || *p == '\t')
+            p++;
+    }
+
+    bool eat(const char *tok) {
+        skip();
+        const char *q = p;
+        for (const char *t = tok; *t; t++, q++) {
+            if (*q != *t)
+                return false;
+        }
+        p = q;
+        return true;
+    }
+
+    Value sum() {
+        Value lhs = term();
+        while (true) {
+            if (eat("+")) {
+                Value rhs = term();
+                lhs = lhs.isint && rhs.isint ? Value::of(lhs.i + rhs.i)
+                    : Value::of(lhs.real() + rhs.real());
+            } else if (eat("-")) {
+                Value rhs = term();
+                lhs = lhs.isint && rhs.isint ? Value::of(lhs.i - rhs.i)
+                    : Value::of(lhs.real() - rhs.real());
+            } else {
+                return lhs;
+            }
+        }
+    }
+
+    Value term() {
+        Value lhs = unary();
+        while (true) {
+            skip();
+            if (p[0] == '*' && p[1] != '*') {
+                p++;
+                Value rhs = unary();
+                lhs = lhs.isint && rhs.isint ? Value::of(lhs.i * rhs.i)
+                    : Value::of(lhs.real() * rhs.real());
+            } else if (eat("//")) {
+                Value rhs = unary();
+                if (rhs.real() == 0)
+                    throw BadExpr{};
+                if (lhs.isint && rhs.isint) {
+                    long long q = lhs.i / rhs.i;
+                    if ((lhs.i % rhs.i != 0) && ((lhs.i < 0) != (rhs.i < 0)))
+                        q--;
+                    lhs = Value::of(q);
+                } else {
+                    lhs = Value::of(std::floor(lhs.real() / rhs.real()));
+                }
+            } else if (eat("/")) {
+                Value rhs = unary();
+                if (rhs.real() == 0)
+                    throw BadExpr{};
+                lhs = Value::of(lhs.real() / rhs.real());
+            } else if (eat("%")) {
+                Value rhs = unary();
+                if (rhs.real() == 0)
+                    throw BadExpr{};
+                if (lhs.isint && rhs.isint) {
+                    long long r = lhs.i % rhs.i;
+                    if (r != 0 && ((r < 0) != (rhs.i < 0)))
+                        r += rhs.i;
+                    lhs = Value::of(r);
+                } else {
+                    double r = std::fmod(lhs.real(), rhs.real());
+                    if (r != 0 && ((r < 0) != (rhs.real() < 0)))
+                        r += rhs.real();
+                    lhs = Value::of(r);
+                }
+            } else {
+                return lhs;
+            }
+        }
+    }
+
+    Value unary() {
+        if (eat("-")) {
+            Value v = unary();
+            return v.isint ? Value::of(-v.i) : Value::of(-v.f);
+        } else if (eat("+")) {
+            return unary();
+        }
+        return power();
+    }
+
+    Value power() {
+        Value lhs = atom();
+        if (eat("**")) {
+            Value rhs = unary();
+            if (lhs.isint && rhs.isint && rhs.i >= 0) {
+                long long res = 1;
+                for (long long k = 0; k < rhs.i; k++)
+                    res *= lhs.i;
+                return Value::of(res);
+            }
+            return Value::of(std::pow(lhs.real(), rhs.real()));
+        }
+        return lhs;
+    }
+
+    Value call(std::string const &name) {
+        std::vector<Value> args;
+        if (!eat(")")) {
+            do {
+                args.push_back(sum());
+            } while (eat(","));
+            if (!eat(")"))
+                throw BadExpr{};
+        }
+        if (name == "abs" && args.size() == 1) {
+            auto v = args[0];
+            return v.isint ? Value::of(std::llabs(v.i)) : Value::of(std::fabs(v.f));
+        } else if (name == "int" && args.size() == 1) {
+            return Value::of((long long)std::trunc(args[0].real()));
+        } else if (name == "float" && args.size() == 1) {
+            return Value::of(args[0].real());
+        } else if ((name == "min" || name == "max") && args.size() >= 1) {
+            Value res = args[0];
+            for (auto const &v: args) {
+                if (name == "min" ? v.real() < res.real() : v.real() > res.real())
+                    res = v;
+            }
+            return res;
+        }
+        throw BadExpr{};
+    }
+
+    Value atom() {
+        skip();
+        if (eat("(")) {
+            Value v = sum();
+            if (!eat(")"))
+                throw BadExpr{};
+            return v;
+        }
+        if (std::isalpha(*p) || *p == '_') {
+            std::string name;
+            while (std::isalnum(*p) || *p == '_')
+                name += *p++;
+            if (eat("("))
+                return call(name);
+            if (name == "frame")
+                return Value::of((long long)frame);
+            throw BadExpr{};
+        }
+        if (std::isdigit(*p) || *p == '.') {
+            char *end;
+            const char *q = p;
+            while (std::isdigit(*q))
+                q++;
+            if (*q == '.' || *q == 'e' || *q == 'E') {
+                double f = std::strtod(p, &end);
+                if (end == p)
+                    throw BadExpr{};
+                p = end;
+                return Value::of(f);
+            }
+            long long i = std::strtoll(p, &end, 10);
+            p = end;
+            return Value::of(i);
+        }
+        throw BadExpr{};
+    }
+};
+
+// python's repr() for floats: shortest round-trip digits, always with
+// a decimal point, scientific notation outside of [1e-4, 1e16)
+std::string repr_float(double f) {
+    if (std::isnan(f))
+        return "nan";
+    if (std::isinf(f))
+        return f < 0 ? "-inf" : "inf";
+    char buf[64];
+    double a = std::fabs(f);
+    auto fmt = a != 0 && (a < 1e-4 || a >= 1e16)
+        ? std::chars_format::scientific : std::chars_format::fixed;
+    auto res = std::to_chars(buf, buf + sizeof(buf), f, fmt);
+    std::string s(buf, res.ptr);
+    if (fmt == std::chars_format::fixed && s.find('.') == std::string::npos)
+        s += ".0";
+    return s;
+}
+
+std::string format_value(Value const &v, std::string const &spec) {
+    if (spec.empty())
+        return v.isint ? std::to_string(v.i) : repr_float(v.f);
+
+    // [[fill]align][sign][0][width][.precision][type], with fill a space
+    const char *s = spec.c_str();
+    std::string flags;
+    if ((s[0] == '<' || s[0] == '>') || (s[0] == ' ' && (s[1] == '<' || s[1] == '>'))) {
+        if (s[0] == ' ')
+            s++;
+        if (*s++ == '<')
+            flags += '-';
+    }
+    if (*s == '+' || *s == ' ') {
+        flags += *s++;
+    } else if (*s == '-') {
+        s++;
+    }
+    if (*s == '0')
+        flags += *s++;
+    std::string width, prec;
+    while (std::isdigit(*s))
+        width += *s++;
+    if (*s == '.') {
+        s++;
+        while (std::isdigit(*s))
+            prec += *s++;
+        if (prec.empty())
+            throw BadExpr{};
+    }
+    char type = *s ? *s++ : 0;
+    if (*s)
+        throw BadExpr{};
+
+    char buf[256];
+    std::string fmt = "%" + flags + width;
+    if (type == 'd' || (!type && v.isint && prec.empty())) {
+        if (!v.isint || prec.size())
+            throw BadExpr{};
+        fmt += "lld";
+        snprintf(buf, sizeof(buf), fmt.c_str(), v.i);
+    } else if (type == 'f' || type == 'e' || type == 'g' || type == 'F'
+            || type == 'E' || type == 'G') {
+        fmt += "." + (prec.empty() ? std::string("6") : prec) + type;
+        snprintf(buf, sizeof(buf), fmt.c_str(), v.real());
+    } else if (!type) {
+        if (prec.empty()) {  // width only, right aligned repr
+            fmt += "s";
+            snprintf(buf, sizeof(buf), fmt.c_str(), repr_float(v.f).c_str());
+        } else {
+            fmt += "." + prec + "g";
+            snprintf(buf, sizeof(buf), fmt.c_str(), v.real());
+        }
+    } else {
+        throw BadExpr{};
+    }
+    return buf;
+}
+
+}
+
+ZENO_API std::string evaluateFrameExpr(std::string const &expr, int frame) {
+    std::string res;
+    try {
+        for (size_t i = 0; i < expr.size(); i++) {
+            char c = expr[i];
+            if (c == '}') {
+                if (i + 1 < expr.size() && expr[i + 1] == '}') {
+                    res += '}';
+                    i++;
+                    continue;
+                }
+                throw BadExpr{};  // single '}' is not allowed in f-string
+            }
+            if (c != '{') {
+                res += c;
+                continue;
+            }
+            if (i + 1 < expr.size() && expr[i + 1] == '{') {
+                res += '{';
+                i++;
+                continue;
+            }
+            auto end = expr.find('}', i);
+            if (end == std::string::npos)
+                throw BadExpr{};
+            auto field = expr.substr(i + 1, end - i - 1);
+            std::string spec;
+            if (auto colon = field.find(':'); colon != std::string::npos) {
+                spec = field.substr(colon + 1);
+                field = field.substr(0, colon);
+            }
+            Parser parser{field.c_str(), frame};
+            Value val = parser.sum();
+            parser.skip();
+            if (*parser.p)
+                throw BadExpr{};
+            res += format_value(val, spec);
+            i = end;
+        }
+    } catch (BadExpr const &) {
+        return expr;
+    }
+    return res;
+}
+
+}
@@ -1,5 +1,7 @@
 #ifdef ZENO_GLOBALSTATE
 #include <zeno/extra/GlobalState.h>
+#include <zeno/extra/Profiler.h>
+#include <zeno/utils/zlog.h>
 
 namespace zeno {
 
@@ -32,6 +34,8 @@ ZENO_API void GlobalState::frameBegin() {
 }
 
 ZENO_API void GlobalState::frameEnd() {
+    if (auto &prof = getProfiler(); prof.enabled)
+        zlog::info("{}", prof.summary(frameid));
     frameid++;
 }
 
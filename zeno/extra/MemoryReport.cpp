@@ -0,0 +1,133 @@
+#include <zeno/extra/MemoryReport.h>
+#include <zeno/core/Graph.h>
+#include <zeno/core/Scene.h>
+#ifdef ZENO_GLOBALSTATE
+#include <zeno/extra/GlobalState.h>
+#endif
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cstdio>
+
+namespace zeno {
+
+ZENO_API MemoryReport::MemoryReport() {
+    if (auto path = getenv("ZEN_MEMREPORT")) {
+        reportPath = path;
+        enabled = true;
+    }
+}
+
+ZENO_API MemoryReport::~MemoryReport() {
+    if (reportPath.size()) {
+        std::ofstream fout(reportPath);
+        fout << summary();
+    }
+}
+
+ZENO_API void MemoryReport::record(Graph const &graph, int64_t base) {
+    // only graphs of the scene, subgraph instances and loop bodies are
+    // inside the outputs of the nodes calling them
+    if (!graph.scene)
+        return;
+    std::string name;
+    for (auto const &[key, g]: graph.scene->graphs) {
+        if (g.get() == &graph)
+            name = key;
+    }
+    if (name.empty())
+        return;
+#ifdef ZENO_GLOBALSTATE
+    int frameid = graph.scene->globalState->frameid;
+#else
+    int frameid = 0;
+#endif
+
+    Frame sample;
+    sample.frameid = frameid;
+    sample.resident = graph.residentBytes(&sample.nodes);
+    sample.peak = std::max(base + graph.peakBytes, sample.resident);
+
+    std::lock_guard lck(m_mtx);
+    auto &frame = m_frames[frameid][name];
+    sample.peak = std::max(sample.peak, frame.peak);
+    frame = std::move(sample);
+}
+
+ZENO_API void MemoryReport::clear() {
+    std::lock_guard lck(m_mtx);
+    m_frames.clear();
+}
+
+ZENO_API std::vector<MemoryReport::Frame> MemoryReport::frames() {
+    std::lock_guard lck(m_mtx);
+    std::vector<Frame> res;
+    for (auto const &[frameid, graphs]: m_frames) {
+        Frame frame;
+        frame.frameid = frameid;
+        for (auto const &[name, g]: graphs) {
+            frame.resident += g.resident;
+            for (auto const &[id, bytes]: g.nodes) {
+                frame.nodes[name == "main" ? id : name + "/" + id] += bytes;
+            }
+        }
+        // graphs are applied one after another, the others only hold
+        // their resident outputs meanwhile
+        for (auto const &[name, g]: graphs) {
+            frame.peak = std::max(frame.peak,
+                    frame.resident - g.resident + g.peak);
+        }
+        res.push_back(std::move(frame));
+    }
+    return res;
+}
+
+ZENO_API std::string MemoryReport::summary(int frameid) {
+    std::ostringstream ss;
+    char buf[256];
+    auto all = frames();
+    if (frameid == -1) {
+        // one line per frame, then the frame end of the highest peak
+        Frame const *worst = nullptr;
+        ss << "  frame  resident MB    peak MB\n";
+        for (auto const &f: all) {
+            sprintf(buf, "%7d %12.3f %10.3f\n", f.frameid,
+                    f.resident / 1048576.0, f.peak / 1048576.0);
+            ss << buf;
+            if (!worst || f.peak > worst->peak)
+                worst = &f;
+        }
+        if (!worst)
+            return ss.str();
+        frameid = worst->frameid;
+        ss << "highest peak at ";
+    }
+    auto it = std::find_if(all.begin(), all.end(), [&] (Frame const &f) {
+        return f.frameid == frameid;
+    });
+    if (it == all.end())
+        return ss.str();
+
+    std::vector<std::pair<std::string, int64_t>> sorted(
+            it->nodes.begin(), it->nodes.end());
+    std::sort(sorted.begin(), sorted.end(), [] (auto const &a, auto const &b) {
+        return a.second > b.second;
+    });
+    sprintf(buf, "frame %d: resident %.3f MB, peak %.3f MB\n", frameid,
+            it->resident / 1048576.0, it->peak / 1048576.0);
+    ss << buf;
+    ss << "    resident MB  node\n";
+    for (auto const &[name, bytes]: sorted) {
+        sprintf(buf, "%15.3f  ", bytes / 1048576.0);
+        ss << buf << name << "\n";
+    }
+    return ss.str();
+}
+
+ZENO_API MemoryReport &getMemoryReport() {
+    static MemoryReport report;
+    return report;
+}
+
+}
@@ -0,0 +1,217 @@
+#include <zeno/extra/ObjectCodec.h>
+#include <zeno/types/PrimitiveObject.h>
+#include <zeno/types/NumericObject.h>
+#include <zeno/types/StringObject.h>
+#include <zeno/types/ConditionObject.h>
+#include <zeno/types/ListObject.h>
+#include <zeno/types/DictObject.h>
+#include <mutex>
+
+namespace zeno {
+
+namespace {
+
+// the mutex as extensions may be loaded lazily, while the scheduler runs
+struct CodecRegistry {
+    std::mutex mtx;
+    std::map<std::type_index, ObjectCodec> byType;
+    std::map<std::string, ObjectCodec const *> byTag;
+};
+
+CodecRegistry &getRegistry() {
+    static CodecRegistry reg;
+    return reg;
+}
+
+enum : uint8_t {
+    kNull = 0,
+    kRef = 1,  // to an object written before
+    kNew = 2,
+};
+
+// the alternative of a variant chosen at runtime, as written by index()
+template <class V, size_t I = 0>
+void emplaceIndex(V &var, size_t index) {
+    if constexpr (I < std::variant_size_v<V>) {
+        if (index == I)
+            var.template emplace<I>();
+        else
+            emplaceIndex<V, I + 1>(var, index);
+    } else {
+        throw ObjectReader::BadData{};
+    }
+}
+
+}
+
+ZENO_API void _defObjectCodec(std::type_index type, ObjectCodec &&codec) {
+    auto &reg = getRegistry();
+    std::lock_guard lck(reg.mtx);
+    auto tag = codec.tag;
+    auto &slot = reg.byType.insert_or_assign(type, std::move(codec)).first->second;
+    reg.byTag[tag] = &slot;
+}
+
+ZENO_API void ObjectSink::putAttribute(AttributeBuffer const &buf) {
+    put<uint8_t>(buf.read().index());
+    std::visit([&] (auto const &arr) { putVector(arr); }, buf.read());
+}
+
+ZENO_API bool encodeObject(ObjectSink &out, IObject const *obj) {
+    if (!obj) {
+        out.put(kNull);
+        return true;
+    }
+    if (auto it = out.ids.find(obj); it != out.ids.end()) {
+        out.put(kRef);
+        out.put(it->second);
+        return true;
+    }
+    ObjectCodec const *codec;
+    {
+        auto &reg = getRegistry();
+        std::lock_guard lck(reg.mtx);
+        auto it = reg.byType.find(typeid(*obj));
+        if (it == reg.byType.end())
+            return false;
+        codec = &it->second;
+    }
+    uint64_t id = out.ids.size();
+    out.ids.emplace(obj, id);
+    out.put(kNew);
+    out.putString(codec->tag);
+    return codec->encode(out, obj);
+}
+
+ZENO_API std::shared_ptr<IObject> decodeObject(ObjectReader &in) {
+    auto kind = in.get<uint8_t>();
+    if (kind == kNull)
+        return nullptr;
+    if (kind == kRef) {
+        auto id = in.get<uint64_t>();
+        if (id >= in.objs.size() || !in.objs[id])
+            throw ObjectReader::BadData{};
+        return in.objs[id];
+    }
+    if (kind != kNew)
+        throw ObjectReader::BadData{};
+    auto tag = in.getString();
+    ObjectCodec const *codec;
+    {
+        auto &reg = getRegistry();
+        std::lock_guard lck(reg.mtx);
+        auto it = reg.byTag.find(tag);
+        if (it == reg.byTag.end())
+            throw ObjectReader::BadData{};
+        codec = it->second;
+    }
+    auto id = in.objs.size();
+    in.objs.emplace_back();  // ids are given before the objects inside
+    auto obj = codec->decode(in);
+    in.objs[id] = obj;
+    return obj;
+}
+
+static int defNumericObject = defObjectCodec<NumericObject>("num",
+    [] (ObjectSink &out, NumericObject const &num) {
+        out.put<uint8_t>(num.value.index());
+        std::visit([&] (auto const &val) { out.put(val); }, num.value);
+        return true;
+    }, [] (ObjectReader &in) {
+        auto num = std::make_shared<NumericObject>();
+        emplaceIndex(num->value, in.get<uint8_t>());
+        std::visit([&] (auto &val) { in.read(&val, sizeof(val)); }, num->value);
+        return num;
+    });
+
+static int defStringObject = defObjectCodec<StringObject>("str",
+    [] (ObjectSink &out, StringObject const &str) {
+        out.putString(str.value);
+        return true;
+    }, [] (ObjectReader &in) {
+        auto str = std::make_shared<StringObject>();
+        str->value = in.getString();
+        return str;
+    });
+
+static int defConditionObject = defObjectCodec<ConditionObject>("cond",
+    [] (ObjectSink &out, ConditionObject const &cond) {
+        out.put(cond.value);
+        return true;
+    }, [] (ObjectReader &in) {
+        return std::make_shared<ConditionObject>(in.get<bool>());
+    });
+
+static int defListObject = defObjectCodec<ListObject>("list",
+    [] (ObjectSink &out, ListObject const &list) {
+        out.put<uint64_t>(list.arr.size());
+        for (auto const &elm: list.arr) {
+            if (!encodeObject(out, elm.get()))
+                return false;
+        }
+        return true;
+    }, [] (ObjectReader &in) {
+        auto list = std::make_shared<ListObject>();
+        auto n = in.get<uint64_t>();
+        for (uint64_t i = 0; i < n; i++)
+            list->arr.push_back(decodeObject(in));
+        return list;
+    });
+
+static int defDictObject = defObjectCodec<DictObject>("dict",
+    [] (ObjectSink &out, DictObject const &dict) {
+        out.put<uint64_t>(dict.lut.size());
+        for (auto const &[key, elm]: dict.lut) {
+            out.putString(key);
+            if (!encodeObject(out, elm.get()))
+                return false;
+        }
+        return true;
+    }, [] (ObjectReader &in) {
+        auto dict = std::make_shared<DictObject>();
+        auto n = in.get<uint64_t>();
+        for (uint64_t i = 0; i < n; i++) {
+            auto key = in.getString();
+            dict->lut[key] = decodeObject(in);
+        }
+        return dict;
+    });
+
+static int defPrimitiveObject = defObjectCodec<PrimitiveObject>("prim",
+    [] (ObjectSink &out, PrimitiveObject const &prim) {
+        out.put<uint64_t>(prim.size());
+        out.put<uint64_t>(prim.m_attrs.size());
+        for (auto const &[key, buf]: prim.m_attrs) {
+            out.putString(key);
+            out.putAttribute(buf);
+        }
+        out.putVector(prim.points);
+        out.putVector(prim.lines);
+        out.putVector(prim.tris);
+        out.putVector(prim.quads);
+        return true;
+    }, [] (ObjectReader &in) {
+        auto prim = std::make_shared<PrimitiveObject>();
+        prim->m_size = in.get<uint64_t>();
+        auto nattrs = in.get<uint64_t>();
+        for (uint64_t i = 0; i < nattrs; i++) {
+            auto key = in.getString();
+            auto index = in.get<uint8_t>();
+            if (index >= std::variant_size_v<AttributeArray>
+                    || in.get<uint64_t>() != prim->m_size)
+                throw ObjectReader::BadData{};
+            // read over pooled storage, as loads repeat every frame
+            auto arr = acquireAttributeArray(index, prim->m_size, false);
+            std::visit([&] (auto &vec) {
+                in.read(vec.data(), vec.size() * sizeof(vec[0]));
+            }, arr);
+            prim->m_attrs[key] = AttributeBuffer(std::move(arr));
+        }
+        in.getVector(prim->points);
+        in.getVector(prim->lines);
+        in.getVector(prim->tris);
+        in.getVector(prim->quads);
+        return prim;
+    });
+
+}
@@ -0,0 +1,360 @@
+#include <zeno/extra/Plugins.h>
+#include <zeno/core/INode.h>
+#include <zeno/utils/Exception.h>
+#include <zeno/utils/filesystem.h>
+#include <zeno/utils/zlog.h>
+#include <rapidjson/document.h>
+#include <rapidjson/writer.h>
+#include <rapidjson/stringbuffer.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cstdio>
+#include <map>
+#include <set>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+#ifdef __linux__
+#include <link.h>
+#endif
+
+namespace zeno {
+
+using namespace rapidjson;
+
+static const char manifestName[] = "zeno_manifest.json";
+
+ZENO_API LazyNodeClass::LazyNodeClass(Descriptor const &desc, std::function<void()> load)
+    : INodeClass(desc), load(std::move(load)) {}
+
+ZENO_API LazyNodeClass::~LazyNodeClass() = default;
+
+ZENO_API std::unique_ptr<INode> LazyNodeClass::new_instance() const {
+    {
+        // its ZENDEFNODEs modify the registry, see dumpDescriptors
+        std::lock_guard lck(getSession().nodeClassesMutex);
+        std::call_once(loaded, load);
+    }
+    if (!impl)
+        throw Exception("node class not defined by its library, "
+                "the plugin manifest may be out of date");
+    return impl->new_instance();
+}
+
+static bool isLibrary(fs::path const &path) {
+#if defined(_WIN32)
+    return path.extension() == ".dll";
+#elif defined(__APPLE__)
+    return path.extension() == ".dylib";
+#else
+    // same as dll.py: 'so' in name.split('.'), to include libfoo.so.1
+    auto name = "." + path.filename().string() + ".";
+    return name.find(".so.") != std::string::npos;
+#endif
+}
+
+ZENO_API std::vector<std::string> findLibraries(std::string const &libdir) {
+    std::vector<std::string> res;
+    std::error_code ec;
+    for (auto const &entry: fs::directory_iterator(libdir, ec)) {
+        if (entry.is_symlink() || !isLibrary(entry.path()))
+            continue;
+        res.push_back(entry.path().string());
+    }
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
+ZENO_API bool loadLibrary(std::string const &path) {
+#ifdef _WIN32
+    return LoadLibraryW(fs::path(path).c_str()) != nullptr;
+#else
+    return dlopen(path.c_str(), RTLD_NOW | RTLD_GLOBAL) != nullptr;
+#endif
+}
+
+static std::string loadError() {
+#ifdef _WIN32
+    return "error " + std::to_string(GetLastError());
+#else
+    auto err = dlerror();
+    return err ? err : "unknown error";
+#endif
+}
+
+namespace {
+
+struct LibraryStat {
+    int64_t size = 0;
+    int64_t mtime = 0;
+
+    static LibraryStat of(fs::path const &path) {
+        LibraryStat st;
+        std::error_code ec;
+        st.size = fs::file_size(path, ec);
+        st.mtime = fs::last_write_time(path, ec).time_since_epoch().count();
+        return st;
+    }
+};
+
+// one per library of the manifest, shared by the stubs of its node classes
+struct LazyLibrary {
+    std::string path;
+    std::vector<std::shared_ptr<LazyLibrary>> deps;
+    std::mutex mtx;
+    bool loaded = false;
+
+    void load() {
+        std::lock_guard lck(mtx);
+        if (loaded)
+            return;
+        for (auto const &dep: deps)
+            dep->load();
+        zlog::info("loading {}", path);
+        if (!loadLibrary(path))
+            throw Exception("cannot load " + path + ": " + loadError());
+        loaded = true;
+    }
+};
+
+}
+
+#if defined(__linux__)
+// file names in the DT_NEEDED entries of a loaded library
+static std::vector<std::string> neededLibraries(std::string const &path) {
+    std::vector<std::string> res;
+    void *handle = dlopen(path.c_str(), RTLD_NOW | RTLD_NOLOAD);
+    if (!handle)
+        return res;
+    link_map *lm = nullptr;
+    if (dlinfo(handle, RTLD_DI_LINKMAP, &lm) == 0 && lm && lm->l_ld) {
+        ElfW(Addr) strtab = 0;
+        for (auto dyn = lm->l_ld; dyn->d_tag != DT_NULL; dyn++) {
+            if (dyn->d_tag == DT_STRTAB)
+                strtab = dyn->d_un.d_ptr;
+        }
+        if (strtab && strtab < lm->l_addr)  // not relocated on some arches
+            strtab += lm->l_addr;
+        for (auto dyn = lm->l_ld; strtab && dyn->d_tag != DT_NULL; dyn++) {
+            if (dyn->d_tag == DT_NEEDED)
+                res.emplace_back((const char *)strtab + dyn->d_un.d_val);
+        }
+    }
+    dlclose(handle);
+    return res;
+}
+
+// the library an ImplNodeClass<F> was instantiated in, i.e. the one whose
+// ZENDEFNODE defined it, found from the address of its vtable
+static std::string definingLibrary(INodeClass const *cls) {
+    Dl_info info;
+    if (!dladdr(*(void *const *)cls, &info) || !info.dli_fname)
+        return {};
+    std::error_code ec;
+    auto path = fs::canonical(info.dli_fname, ec);
+    return ec ? std::string() : path.string();
+}
+#endif
+
+static void writeSockets(Writer<StringBuffer> &w, const char *key,
+        std::vector<SocketDescriptor> const &socks) {
+    w.Key(key);
+    w.StartArray();
+    for (auto const &s: socks) {
+        w.StartArray();
+        w.String(s.type.c_str());
+        w.String(s.name.c_str());
+        w.String(s.defl.c_str());
+        w.EndArray();
+    }
+    w.EndArray();
+}
+
+ZENO_API void writePluginManifest(std::string const &libdir) {
+#if defined(__linux__)
+    auto &sess = getSession();
+    auto paths = findLibraries(libdir);
+    std::map<std::string, std::string> names;  // canonical path -> file name
+    for (auto const &path: paths)
+        names[fs::canonical(path).string()] = fs::path(path).filename().string();
+    // libzeno's own node classes are always there
+    Dl_info self;
+    if (dladdr((void *)&writePluginManifest, &self) && self.dli_fname)
+        names.erase(fs::canonical(self.dli_fname).string());
+
+    // same retries as the eager loaders; libraries that only loaded once
+    // others were, without naming them in DT_NEEDED, depend on all of those
+    std::map<std::string, std::set<std::string>> deps;
+    std::vector<std::string> loaded;
+    std::map<std::string, int> retries;
+    int max_retries = paths.size() + 2;
+    while (paths.size()) {
+        for (auto it = paths.begin(); it != paths.end();) {
+            auto name = fs::path(*it).filename().string();
+            if (loadLibrary(*it)) {
+                auto &dep = deps[name];
+                for (auto const &needed: neededLibraries(*it)) {
+                    if (fs::exists(fs::path(libdir) / needed))
+                        dep.insert(needed);
+                }
+                if (retries[*it])
+                    dep.insert(loaded.begin(), loaded.end());
+                loaded.push_back(name);
+                it = paths.erase(it);
+            } else if (retries[*it]++ > max_retries) {
+                throw Exception("cannot load " + *it + ": " + loadError());
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    std::map<std::string, std::map<std::string, INodeClass const *>> classes;
+    for (auto const &[id, cls]: sess.nodeClasses) {
+        auto it = names.find(definingLibrary(cls.get()));
+        if (it != names.end())
+            classes[it->second][id] = cls.get();
+    }
+
+    StringBuffer buf;
+    Writer<StringBuffer> w(buf);
+    w.StartObject();
+    w.Key("libraries");
+    w.StartArray();
+    // libraries without node classes are left out, so that they are still
+    // loaded eagerly, in case they register something else
+    for (auto const &[name, nodes]: classes) {
+        auto st = LibraryStat::of(fs::path(libdir) / name);
+        w.StartObject();
+        w.Key("file");
+        w.String(name.c_str());
+        w.Key("size");
+        w.Int64(st.size);
+        w.Key("mtime");
+        w.Int64(st.mtime);
+        w.Key("deps");
+        w.StartArray();
+        for (auto const &dep: deps[name]) {
+            if (dep != name && classes.count(dep))
+                w.String(dep.c_str());
+        }
+        w.EndArray();
+        w.Key("nodes");
+        w.StartObject();
+        for (auto const &[id, cls]: nodes) {
+            auto const &desc = *cls->desc;
+            w.Key(id.c_str());
+            w.StartObject();
+            writeSockets(w, "inputs", desc.inputs);
+            writeSockets(w, "outputs", desc.outputs);
+            w.Key("params");
+            w.StartArray();
+            for (auto const &p: desc.params) {
+                w.StartArray();
+                w.String(p.type.c_str());
+                w.String(p.name.c_str());
+                w.String(p.defl.c_str());
+                w.EndArray();
+            }
+            w.EndArray();
+            w.Key("categories");
+            w.StartArray();
+            for (auto const &c: desc.categories)
+                w.String(c.c_str());
+            w.EndArray();
+            w.Key("traits");
+            w.StartArray();
+            for (auto const &t: desc.traits)
+                w.String(t.c_str());
+            w.EndArray();
+            w.EndObject();
+        }
+        w.EndObject();
+        w.EndObject();
+    }
+    w.EndArray();
+    w.EndObject();
+
+    auto path = fs::path(libdir) / manifestName;
+    std::ofstream fout(path);
+    fout << buf.GetString() << "\n";
+    if (!fout)
+        throw Exception("cannot write " + path.string());
+#else
+    throw Exception("plugin manifests are only supported on linux yet");
+#endif
+}
+
+static std::vector<SocketDescriptor> readSockets(Value const &arr) {
+    std::vector<SocketDescriptor> res;
+    for (auto const &s: arr.GetArray())
+        res.emplace_back(s[0].GetString(), s[1].GetString(), s[2].GetString());
+    return res;
+}
+
+// not through Descriptor's constructor, the manifest already has SRC/DST
+static Descriptor readDescriptor(Value const &v) {
+    Descriptor desc;
+    desc.inputs = readSockets(v["inputs"]);
+    desc.outputs = readSockets(v["outputs"]);
+    for (auto const &p: v["params"].GetArray())
+        desc.params.emplace_back(p[0].GetString(), p[1].GetString(), p[2].GetString());
+    for (auto const &c: v["categories"].GetArray())
+        desc.categories.emplace_back(c.GetString());
+    for (auto const &t: v["traits"].GetArray())
+        desc.traits.emplace(t.GetString());
+    return desc;
+}
+
+ZENO_API std::vector<std::string> loadPluginManifest(std::string const &libdir) {
+    std::vector<std::string> res;
+    if (getenv("ZEN_EAGERLOAD"))
+        return res;
+    std::ifstream fin(fs::path(libdir) / manifestName);
+    if (!fin)
+        return res;
+    std::stringstream ss;
+    ss << fin.rdbuf();
+    Document doc;
+    doc.Parse(ss.str().c_str());
+    if (doc.HasParseError() || !doc.IsObject() || !doc.HasMember("libraries"))
+        return res;
+
+    std::map<std::string, std::shared_ptr<LazyLibrary>> libs;
+    for (auto const &lib: doc["libraries"].GetArray()) {
+        auto path = fs::path(libdir) / lib["file"].GetString();
+        auto st = LibraryStat::of(path);
+        if (st.size != lib["size"].GetInt64() || st.mtime != lib["mtime"].GetInt64())
+            continue;  // rebuilt since, maybe with other node classes
+        auto &ptr = libs[lib["file"].GetString()];
+        ptr = std::make_shared<LazyLibrary>();
+        ptr->path = path.string();
+    }
+
+    auto &sess = getSession();
+    for (auto const &lib: doc["libraries"].GetArray()) {
+        auto it = libs.find(lib["file"].GetString());
+        if (it == libs.end())
+            continue;
+        auto ptr = it->second;
+        for (auto const &dep: lib["deps"].GetArray()) {
+            // the others are loaded eagerly by the caller
+            if (auto d = libs.find(dep.GetString()); d != libs.end())
+                ptr->deps.push_back(d->second);
+        }
+        for (auto const &[id, desc]: lib["nodes"].GetObject()) {
+            if (sess.nodeClasses.count(id.GetString()))
+                continue;
+            sess._defNodeClass(id.GetString(), std::make_unique<LazyNodeClass>(
+                        readDescriptor(desc), [ptr] { ptr->load(); }));
+        }
+        res.push_back(it->first);
+    }
+    return res;
+}
+
+}
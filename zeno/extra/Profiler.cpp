@@ -0,0 +1,227 @@
+#include <zeno/extra/Profiler.h>
+#include <zeno/utils/ThreadPool.h>
+#include <zeno/utils/zlog.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cstdio>
+
+namespace zeno {
+
+static thread_local Profiler::ThreadLog *t_log = nullptr;
+static thread_local ProfileScope *t_current = nullptr;
+
+ZENO_API Profiler::Profiler()
+    : m_epoch(std::chrono::steady_clock::now())
+{
+    if (auto path = getenv("ZEN_PROFILE")) {
+        tracePath = path;
+        enabled = true;
+    }
+}
+
+ZENO_API Profiler::~Profiler() {
+    if (tracePath.size()) {
+        dumpChromeTrace(tracePath);
+    }
+}
+
+ZENO_API Profiler::ThreadLog &Profiler::threadLog() {
+    if (!t_log) {
+        std::lock_guard lck(m_mtx);
+        auto log = std::make_unique<ThreadLog>();
+        log->tid = m_logs.size();
+        t_log = log.get();
+        m_logs.push_back(std::move(log));
+    }
+    return *t_log;
+}
+
+ZENO_API void Profiler::record(ThreadLog &log, Event &&e) {
+    std::lock_guard lck(log.mtx);
+    auto add = [&] (Stats &stats) {
+        auto &st = stats[e.name];
+        st.calls++;
+        st.total += e.duration;
+        st.self += e.duration - e.children;
+        st.max = std::max(st.max, e.duration);
+    };
+    add(log.total);
+    add(log.frames[e.frameid]);
+    if (log.frames.size() > maxFrames)
+        log.frames.erase(log.frames.begin());
+    if (log.events.size() < maxEvents) {
+        log.events.push_back(std::move(e));
+    } else {
+        log.events[log.head] = std::move(e);
+        log.head = (log.head + 1) % maxEvents;
+        log.dropped++;
+    }
+}
+
+ZENO_API int64_t Profiler::now() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - m_epoch).count();
+}
+
+ZENO_API void Profiler::clear() {
+    std::lock_guard lck(m_mtx);
+    for (auto const &log: m_logs) {
+        std::lock_guard lck(log->mtx);
+        log->events.clear();
+        log->head = 0;
+        log->dropped = 0;
+        log->frames.clear();
+        log->total.clear();
+    }
+}
+
+ZENO_API std::vector<Profiler::Event> Profiler::events() {
+    std::vector<Event> res;
+    {
+        std::lock_guard lck(m_mtx);
+        for (auto const &log: m_logs) {
+            std::lock_guard lck(log->mtx);
+            res.insert(res.end(), log->events.begin(), log->events.end());
+        }
+    }
+    std::sort(res.begin(), res.end(), [] (Event const &a, Event const &b) {
+        return a.begin < b.begin;
+    });
+    return res;
+}
+
+static std::string json_escape(std::string const &str) {
+    std::string res;
+    for (char c: str) {
+        if (c == '"' || c == '\\') {
+            res += '\\';
+            res += c;
+        } else if ((unsigned char)c < 0x20) {
+            char buf[8];
+            sprintf(buf, "\\u%04x", c);
+            res += buf;
+        } else {
+            res += c;
+        }
+    }
+    return res;
+}
+
+ZENO_API void Profiler::dumpChromeTrace(std::string const &path) {
+    size_t dropped = 0;
+    {
+        std::lock_guard lck(m_mtx);
+        for (auto const &log: m_logs) {
+            std::lock_guard lck(log->mtx);
+            dropped += log->dropped;
+        }
+    }
+    if (dropped)
+        zlog::warning("{} oldest profiler events dropped from {}", dropped, path);
+    std::ofstream fout(path);
+    fout << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    bool first = true;
+    for (auto const &e: events()) {
+        if (!first)
+            fout << ",";
+        first = false;
+        fout << "\n{\"name\": \"" << json_escape(e.name)
+             << "\", \"cat\": \"node\", \"ph\": \"X\", \"pid\": 0"
+             << ", \"tid\": " << e.tid
+             << ", \"ts\": " << e.begin
+             << ", \"dur\": " << e.duration
+             << ", \"args\": {\"frame\": " << e.frameid
+             << ", \"substep\": " << e.substepid << "}}";
+    }
+    fout << "\n]}\n";
+}
+
+ZENO_API std::string Profiler::summary(int frameid) {
+    Stats stats;
+    {
+        std::lock_guard lck(m_mtx);
+        for (auto const &log: m_logs) {
+            std::lock_guard lck(log->mtx);
+            Stats const *src = &log->total;
+            if (frameid != -1) {
+                auto it = log->frames.find(frameid);
+                if (it == log->frames.end())
+                    continue;
+                src = &it->second;
+            }
+            for (auto const &[name, other]: *src) {
+                auto &st = stats[name];
+                st.calls += other.calls;
+                st.total += other.total;
+                st.self += other.self;
+                st.max = std::max(st.max, other.max);
+            }
+        }
+    }
+    int64_t frametime = 0;
+    for (auto const &[name, st]: stats)
+        frametime += st.self;
+
+    std::vector<std::pair<std::string, Stat>> sorted(stats.begin(), stats.end());
+    std::sort(sorted.begin(), sorted.end(), [] (auto const &a, auto const &b) {
+        return a.second.self > b.second.self;
+    });
+
+    std::ostringstream ss;
+    char buf[256];
+    if (frameid != -1)
+        ss << "frame " << frameid << ": ";
+    sprintf(buf, "%zd nodes, %.3f ms\n", sorted.size(), frametime * 1e-3);
+    ss << buf;
+    ss << "   self ms   total ms    max ms  calls  node\n";
+    for (auto const &[name, st]: sorted) {
+        sprintf(buf, "%10.3f %10.3f %9.3f %6d  ", st.self * 1e-3,
+                st.total * 1e-3, st.max * 1e-3, st.calls);
+        ss << buf << name << "\n";
+    }
+    return ss.str();
+}
+
+ZENO_API Profiler &getProfiler() {
+    static Profiler profiler;
+    return profiler;
+}
+
+ZENO_API ProfileScope::ProfileScope(std::string const &name,
+        int frameid, int substepid) {
+    auto &prof = getProfiler();
+    if (!prof.enabled.load(std::memory_order_relaxed))
+        return;
+    m_log = &prof.threadLog();
+    m_name = &name;
+    m_frameid = frameid;
+    m_substepid = substepid;
+    m_parent = t_current;
+    m_task = getTaskDepth();
+    m_nested = m_parent && m_parent->m_task == m_task;
+    m_depth = m_nested ? m_parent->m_depth + 1 : 0;
+    t_current = this;
+    m_begin = prof.now();
+}
+
+ZENO_API ProfileScope::~ProfileScope() {
+    if (!m_log)
+        return;
+    Profiler::Event e;
+    e.begin = m_begin;
+    e.duration = getProfiler().now() - m_begin;
+    e.children = m_children;
+    e.name = *m_name;
+    e.tid = m_log->tid;
+    e.depth = m_depth;
+    e.frameid = m_frameid;
+    e.substepid = m_substepid;
+    if (m_nested)
+        m_parent->m_children += e.duration;
+    t_current = m_parent;
+    getProfiler().record(*m_log, std::move(e));
+}
+
+}
@@ -5,38 +5,244 @@
 #include <zeno/zeno.h>
 #include <zeno/extra/Visualization.h>
 #include <zeno/extra/GlobalState.h>
+#include <zeno/types/ListObject.h>
 #include <zeno/utils/filesystem.h>
+#include <zeno/utils/zlog.h>
+#include <condition_variable>
 #include <fstream>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <map>
+#include <set>
+#include <cstdlib>
 #include <cstdio>
 
 namespace zeno::Visualization {
 
-static int objid = 0;
+static std::mutex objid_mtx;  // VIEW nodes may dump concurrently
 
-ZENO_API std::string exportPath() {
+static fs::path frameDir(GlobalState const &state) {
     char buf[100];
-    sprintf(buf, "%06d", zeno::state.frameid);
-    auto path = fs::path(zeno::state.iopath) / buf;
+    sprintf(buf, "%06d", state.frameid);
+    auto path = fs::path(state.iopath) / buf;
     if (!fs::is_directory(path)) {
-        fs::create_directory(path);
+        fs::create_directories(path);
+    }
+    return path;
+}
+
+ZENO_API std::string exportPath(GlobalState &state) {
+    auto path = frameDir(state);
+    int objid;
+    {
+        std::lock_guard lck(objid_mtx);
+        objid = state.objid++;
     }
-    sprintf(buf, "%06d", objid++);
+    char buf[100];
+    sprintf(buf, "%06d", objid);
     path /= buf;
     //printf("EXPORTPATH: %s\n", path.c_str());
     return path.string();
 }
 
-ZENO_API void endFrame() {
-    char buf[100];
-    sprintf(buf, "%06d", zeno::state.frameid);
-    auto path = fs::path(zeno::state.iopath) / buf;
-    if (!fs::is_directory(path)) {
-        fs::create_directory(path);
+ZENO_API std::string exportPath() {
+    return exportPath(zeno::state);
+}
+
+ZENO_API std::string exportPath(GlobalState &state, std::string const &key) {
+    auto path = frameDir(state);
+    int seq;
+    {
+        std::lock_guard lck(objid_mtx);
+        seq = state.exported[key]++;
     }
-    path /= "done.lock";
-    std::ofstream ofs(path.string());
+    path /= seq ? key + "-" + std::to_string(seq) : key;
+    return path.string();
+}
+
+static void writeDoneLock(std::string const &path) {
+    std::ofstream ofs(path);
     ofs.write("DONE", 4);
-    objid = 0;
+}
+
+static int env_int(const char *name, int defl) {
+    auto val = getenv(name);
+    return val ? atoi(val) : defl;
+}
+
+namespace {
+
+struct ExportJob {
+    std::shared_ptr<IObject> obj;
+    std::string path;
+    std::string lockpath;  // done.lock of the frame, unique across scenes
+    size_t bytes = 0;
+};
+
+struct ExportQueue {
+    std::mutex mtx;
+    std::condition_variable cv_jobs;   // a job was pushed, or stopped
+    std::condition_variable cv_space;  // a job was written
+    std::deque<ExportJob> jobs;
+    std::map<std::string, int> inflight;  // done.lock -> dumps not written
+    std::set<std::string> locks;  // of ended frames waiting for dumps
+    size_t bytes = 0;  // memory held by snapshots queued or being written
+    size_t maxBytes = 0;
+    size_t maxJobs = 0;
+    bool stopped = false;
+    std::vector<std::thread> writers;
+
+    ExportQueue() {
+        maxBytes = (size_t)std::max(0, env_int("ZEN_EXPORT_BUDGET", 1024)) << 20;
+        maxJobs = std::max(1, env_int("ZEN_EXPORT_QUEUE", 16));
+        int nthreads = env_int("ZEN_EXPORT_THREADS", 2);
+        for (int i = 0; i < nthreads; i++) {
+            writers.emplace_back([this] { writer_main(); });
+        }
+    }
+
+    ~ExportQueue() {
+        flush();
+        {
+            std::lock_guard lck(mtx);
+            stopped = true;
+        }
+        cv_jobs.notify_all();
+        for (auto &thr: writers) {
+            thr.join();
+        }
+    }
+
+    void push(ExportJob job) {
+        std::unique_lock lck(mtx);
+        // back-pressure: the solver waits for the writers to catch up, but
+        // an object larger than the whole budget still goes if it's alone
+        cv_space.wait(lck, [&] {
+            return jobs.size() < maxJobs
+                && (bytes == 0 || bytes + job.bytes <= maxBytes);
+        });
+        bytes += job.bytes;
+        inflight[job.lockpath]++;
+        jobs.push_back(std::move(job));
+        cv_jobs.notify_one();
+    }
+
+    void endFrame(std::string const &lockpath) {
+        {
+            std::lock_guard lck(mtx);
+            if (inflight.count(lockpath)) {
+                locks.insert(lockpath);
+                return;
+            }
+        }
+        writeDoneLock(lockpath);
+    }
+
+    void flush() {
+        std::unique_lock lck(mtx);
+        cv_space.wait(lck, [&] {
+            return inflight.empty();
+        });
+    }
+
+    void writer_main() {
+        std::unique_lock lck(mtx);
+        while (true) {
+            cv_jobs.wait(lck, [&] {
+                return stopped || jobs.size();
+            });
+            if (jobs.empty())
+                break;
+            auto job = std::move(jobs.front());
+            jobs.pop_front();
+
+            lck.unlock();
+            try {
+                job.obj->dumpfile(job.path);
+            } catch (std::exception const &e) {
+                zlog::error("failed to export {}: {}", job.path, e.what());
+            }
+            job.obj = nullptr;  // release the snapshot before reporting space
+            lck.lock();
+
+            bytes -= job.bytes;
+            if (auto it = inflight.find(job.lockpath); !--it->second) {
+                inflight.erase(it);
+                if (locks.erase(job.lockpath))
+                    writeDoneLock(job.lockpath);
+            }
+            cv_space.notify_all();
+        }
+    }
+};
+
+}
+
+static ExportQueue &getExportQueue() {
+    static ExportQueue queue;
+    return queue;
+}
+
+// writers may only see immutable copies, the solver goes on modifying the
+// outputs in-place (e.g. loops carrying state across frames)
+static std::shared_ptr<IObject> snapshot(std::shared_ptr<IObject> const &obj) {
+    if (auto list = dynamic_cast<ListObject *>(obj.get())) {
+        auto res = std::make_shared<ListObject>();
+        for (auto const &elm: list->arr) {
+            auto copy = elm ? snapshot(elm) : nullptr;
+            if (elm && !copy)
+                return nullptr;
+            res->arr.push_back(std::move(copy));
+        }
+        return res;
+    }
+    return obj->clone();
+}
+
+static void exportTo(std::shared_ptr<IObject> const &obj, GlobalState &state,
+        std::string path) {
+    auto &queue = getExportQueue();
+    if (queue.writers.size()) {
+        if (auto snap = snapshot(obj)) {
+            ExportJob job;
+            job.bytes = snap->memoryUsage();
+            job.obj = std::move(snap);
+            job.path = std::move(path);
+            job.lockpath = (frameDir(state) / "done.lock").string();
+            queue.push(std::move(job));
+            return;
+        }
+    }
+    obj->dumpfile(path);
+}
+
+ZENO_API void exportObject(std::shared_ptr<IObject> const &obj, GlobalState &state) {
+    exportTo(obj, state, exportPath(state));
+}
+
+ZENO_API void exportObject(std::shared_ptr<IObject> const &obj) {
+    exportObject(obj, zeno::state);
+}
+
+ZENO_API void exportObject(std::shared_ptr<IObject> const &obj,
+        GlobalState &state, std::string const &key) {
+    exportTo(obj, state, exportPath(state, key));
+}
+
+ZENO_API void flushExports() {
+    getExportQueue().flush();
+}
+
+ZENO_API void endFrame(GlobalState &state) {
+    auto path = frameDir(state) / "done.lock";
+    getExportQueue().endFrame(path.string());
+    state.objid = 0;
+    state.exported.clear();
+}
+
+ZENO_API void endFrame() {
+    endFrame(zeno::state);
 }
 
 }
@@ -3,6 +3,7 @@
 #include <zeno/utils/defs.h>
 #include <string>
 #include <vector>
+#include <set>
 
 namespace zeno {
 
@@ -31,15 +32,25 @@ struct Descriptor {
   std::vector<SocketDescriptor> outputs;
   std::vector<ParamDescriptor> params;
   std::vector<std::string> categories;
+  // class-wide hints for the graph scheduler, e.g. "lazy" for nodes that
+  // pull their inputs on demand in doApply, "serial" for nodes touching
+  // graph-wide or global state that must not run concurrently, "exclusive"
+  // for nodes that may only be applied while no other node is (see zeno.h)
+  std::set<std::string> traits;
 
   ZENO_API Descriptor();
   ZENO_API Descriptor(
 	  std::vector<SocketDescriptor> const &inputs,
 	  std::vector<SocketDescriptor> const &outputs,
 	  std::vector<ParamDescriptor> const &params,
-	  std::vector<std::string> const &categories);
+	  std::vector<std::string> const &categories,
+	  std::set<std::string> const &traits = {});
 
   ZENO_API std::string serialize() const;
+
+  bool has_trait(std::string const &name) const {
+    return traits.find(name) != traits.end();
+  }
 };
 
 }
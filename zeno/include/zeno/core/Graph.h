@@ -2,9 +2,14 @@
 
 #include <zeno/utils/defs.h>
 #include <zeno/core/IObject.h>
+#include <zeno/core/INode.h>
 #include <zeno/utils/safe_dynamic_cast.h>
+#include <cstdint>
 #include <memory>
+#include <atomic>
+#include <mutex>
 #include <string>
+#include <vector>
 #include <set>
 #include <map>
 
@@ -12,15 +17,53 @@ namespace zeno {
 
 struct Scene;
 struct INode;
+struct ObjectSink;
+struct ObjectReader;
 
+// visited marks of one evaluation pass; loop and function bodies push a
+// copy per iteration, which only overlays its parent: marks live in storage
+// shared along the chain and a mark is only seen by the context that made
+// it and its children, so entering or leaving a body costs O(body)
 struct Context {
-    std::set<std::string> visited;
+    struct Mark {
+        int depth = -1;
+        unsigned epoch = 0;
+    };
+
+    struct Marks {
+        std::vector<Mark> nodes;  // indexed by INode::myid
+        std::vector<unsigned> chain;  // epoch of the live context per depth
+        unsigned nextEpoch = 0;
+    };
+
+    std::shared_ptr<Marks> marks;
+    std::vector<int> touched;  // ids marked by this context
+    unsigned epoch = 0;
+    int depth = 0;  // copies are pushed by loop bodies, see ContextManaged
+
+    inline bool isVisited(INode *node) const {
+        auto const &m = marks->nodes[node->myid];
+        return m.depth >= 0 && m.depth <= depth
+            && marks->chain[m.depth] == m.epoch;
+    }
+
+    inline void setVisited(INode *node) {
+        marks->nodes[node->myid] = {depth, epoch};
+        touched.push_back(node->myid);
+    }
 
+    // take over the marks of a popped child, e.g. the last loop iteration
     inline void mergeVisited(Context const &other) {
-        visited.insert(other.visited.begin(), other.visited.end());
+        for (auto id: other.touched) {
+            auto &m = marks->nodes[id];
+            if (m.depth == other.depth && m.epoch == other.epoch) {
+                m = {depth, epoch};
+                touched.push_back(id);
+            }
+        }
     }
 
-    ZENO_API Context();
+    ZENO_API explicit Context(size_t nnodes, int depth = 0);
     ZENO_API Context(Context const &other);
     ZENO_API ~Context();
 };
@@ -30,6 +73,12 @@ struct Graph {
 
     std::map<std::string, std::unique_ptr<INode>> nodes;
 
+    // dense execution plan built by compile(), nodes indexed by INode::myid
+    std::vector<INode *> nodesById;
+    bool isCompiled = false;
+    // changed by every edit, unique across graphs, see instantiate
+    unsigned editVersion = 0;
+
     std::map<std::string, std::shared_ptr<IObject>> subInputs;
     std::map<std::string, std::shared_ptr<IObject>> subOutputs;
     std::map<std::string, std::string> subOutputNodes;
@@ -40,7 +89,22 @@ struct Graph {
     std::unique_ptr<Context> ctx;
 
     bool isViewed = true;
-    bool hasAnyView = false;
+    // VIEW objects of our nodes are named after this and their myid, so
+    // that exported files are the same whichever thread dumps first; for
+    // graphs called by a node, the caller's name and a separator
+    std::string viewPrefix = "n";
+    std::atomic<bool> hasAnyView{false};
+
+    // outputs of the current applyNodes pass, in bytes: peakBytes is the
+    // most held at once, producedBytes what would be held without release
+    bool isReleasing = false;
+    bool isTracking = false;  // releasing, or for the MemoryReport
+    std::atomic<int64_t> liveBytes{0};
+    std::atomic<int64_t> peakBytes{0};
+    std::atomic<int64_t> producedBytes{0};
+    // storage counted in liveBytes, see IObject::countMemoryUsage
+    std::mutex trackMtx;
+    std::map<void const *, size_t> trackedStorage;
 
     ZENO_API Graph();
     ZENO_API ~Graph();
@@ -59,16 +123,38 @@ struct Graph {
                 "graph output `" + id + "` ");
     }
 
+    // a copy of our nodes with state of its own, for each Subgraph node
+    // calling us, so that calls don't clobber each other's outputs and
+    // can run concurrently; editVersion is copied to tell when it's stale
+    ZENO_API std::unique_ptr<Graph> instantiate() const;
+    // INode::saveState of each node, for checkpoints
+    ZENO_API bool saveState(ObjectSink &out) const;
+    ZENO_API void loadState(ObjectReader &in);
+
     ZENO_API void clearNodes();
+    ZENO_API void compile();
+    ZENO_API void mergeDuplicates();
     ZENO_API void applyNodes(std::set<std::string> const &ids);
+    ZENO_API void scheduleNodes(std::set<std::string> const &ids);
     ZENO_API void addNode(std::string const &cls, std::string const &id);
+    ZENO_API void removeNode(std::string const &id);
     ZENO_API void applyNode(std::string const &id);
+    ZENO_API void applyNode(INode *node);
+    ZENO_API bool isIncremental() const;
+    ZENO_API void computeLiveness(std::set<std::string> const &ids);
+    ZENO_API void trackOutputs(INode *node);
+    // held by node outputs now, each object and shared buffer counted once
+    ZENO_API int64_t residentBytes(
+            std::map<std::string, int64_t> *byNode = nullptr) const;
+    ZENO_API void releaseInputs(INode *node);
     ZENO_API void completeNode(std::string const &id);
     ZENO_API void bindNodeInput(std::string const &dn, std::string const &ds,
         std::string const &sn, std::string const &ss);
+    ZENO_API void unbindNodeInput(std::string const &dn, std::string const &ds);
     ZENO_API void setNodeParam(std::string const &id, std::string const &par,
         IValue const &val);
     ZENO_API void setNodeOption(std::string const &id, std::string const &name);
+    ZENO_API void unsetNodeOption(std::string const &id, std::string const &name);
     ZENO_API std::shared_ptr<IObject> const &getNodeOutput(
         std::string const &sn, std::string const &ss) const;
 };
@@ -4,7 +4,9 @@
 #include <zeno/core/IObject.h>
 #include <zeno/utils/safe_dynamic_cast.h>
 #include <memory>
+#include <atomic>
 #include <string>
+#include <vector>
 #include <set>
 #include <map>
 
@@ -12,6 +14,9 @@ namespace zeno {
 
 struct Graph;
 struct INodeClass;
+struct GlobalState;
+struct ObjectSink;
+struct ObjectReader;
 
 struct INode {
 public:
@@ -26,16 +31,71 @@ public:
     std::map<std::string, IValue> params;
     std::set<std::string> options;
 
+    // inputBounds resolved by Graph::compile, so that applying doesn't
+    // need to look up node or socket names again
+    struct InputLink {
+        std::string ds, sn, ss;
+        INode *srcNode = nullptr;
+        std::shared_ptr<IObject> *srcSlot = nullptr;
+        std::shared_ptr<IObject> *dstSlot = nullptr;
+        unsigned srcVersion = 0;  // srcNode->applyVersion when last applied
+    };
+    std::vector<InputLink> inputLinks;
+    int myid = -1;
+
+    // incremental evaluation: a pure node is only re-applied when dirty
+    // (params, options or bindings changed) or when any upstream node
+    // was re-applied since its last apply, otherwise outputs are reused
+    bool isPure = false;
+    bool mutatesInputs = false;
+    std::atomic<bool> isDirty{true};
+    unsigned applyVersion = 0;
+
+    // consumers left to apply in this pass before outputs can be released,
+    // see Graph::computeLiveness
+    std::atomic<int> liveUses{0};
+    bool isReleasable = false;
+
+    // an identical pure node found by Graph::compile, applied in our stead:
+    // we get copies of its outputs, so that consumers modifying them
+    // in-place still don't see each other
+    INode *cseSource = nullptr;
+    std::vector<INode *> cseCopies;  // nodes having us as cseSource
+    unsigned cseVersion = 0;  // cseSource->applyVersion when last copied
+
     ZENO_API INode();
     ZENO_API virtual ~INode();
 
     ZENO_API void doComplete();
     ZENO_API virtual void doApply();
+    ZENO_API bool isUpToDate() const;
+    ZENO_API void reuseApply();
+    ZENO_API void updateVersion();
+    ZENO_API void cseApply();
+    ZENO_API void cseCopy();
+    ZENO_API GlobalState &getGlobalState() const;  // of our scene
+    // name of our exported VIEW objects: graph->viewPrefix and myid
+    ZENO_API std::string viewKey() const;
+
+    // state carried across frames, for checkpoints (see extra/Checkpoint.h):
+    // outputs of ONCE nodes by default, nodes keeping state in members
+    // override these; false if some of it can't be encoded
+    ZENO_API virtual bool saveState(ObjectSink &out) const;
+    ZENO_API virtual void loadState(ObjectReader &in);
+
+    // not to be applied while any other node is: "exclusive" nodes (see
+    // Descriptor.h), and nodes applying some, e.g. Subgraph
+    ZENO_API virtual bool isExclusive();
 
 protected:
     ZENO_API bool checkApplyCondition();
     ZENO_API void requireInput(std::string const &ds);
+    ZENO_API void requireInput(InputLink const &link);
     ZENO_API void coreApply();
+    ZENO_API void cacheApply();
+    ZENO_API void dumpView();
+    ZENO_API bool saveOutputs(ObjectSink &out) const;
+    ZENO_API void loadOutputs(ObjectReader &in);
 
     ZENO_API virtual void complete();
     ZENO_API virtual void apply() = 0;
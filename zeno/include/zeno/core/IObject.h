@@ -4,6 +4,7 @@
 #include <variant>
 #include <string>
 #include <memory>
+#include <map>
 
 namespace zeno {
 
@@ -17,11 +18,24 @@ struct IObject {
     ZENO_API virtual std::shared_ptr<IObject> clone() const;
     ZENO_API virtual bool assign(IObject *other);
     ZENO_API virtual void dumpfile(std::string const &path);
+    ZENO_API virtual size_t memoryUsage() const;
+    // memoryUsage of storage not in counted yet, which is added to it by
+    // address with its size: the object, and buffers shared between
+    // objects, e.g. attributes of primitive copies, so each counts once
+    ZENO_API virtual size_t countMemoryUsage(
+            std::map<void const *, size_t> &counted) const;
 #else
     virtual ~IObject() = default;
     virtual std::shared_ptr<IObject> clone() const { return nullptr; }
     virtual bool assign(IObject *other) { return false; }
     virtual void dumpfile(std::string const &path) {}
+    virtual size_t memoryUsage() const { return 0; }
+    virtual size_t countMemoryUsage(
+            std::map<void const *, size_t> &counted) const {
+        if (counted.count(this))
+            return 0;
+        return counted[this] = memoryUsage();
+    }
 #endif
 
     template <class T>
@@ -2,6 +2,7 @@
 
 #include <zeno/utils/defs.h>
 #include <memory>
+#include <atomic>
 #include <string>
 #include <map>
 
@@ -9,6 +10,7 @@ namespace zeno {
 
 struct Session;
 struct Graph;
+struct GlobalState;
 
 struct Scene {
     std::map<std::string, std::unique_ptr<Graph>> graphs;
@@ -16,6 +18,22 @@ struct Scene {
     Graph *currGraph = nullptr;
     Session *sess = nullptr;
 
+    // run independent nodes concurrently, set ZEN_SERIAL=1 to debug serially
+    bool isParallel = true;
+    // reuse outputs of unchanged pure nodes, set ZEN_FULLEVAL=1 to disable
+    bool isIncremental = true;
+    // drop intermediate outputs once consumed, set ZEN_KEEPOUTPUTS=1 to keep
+    bool releaseOutputs = true;
+    // apply identical pure nodes only once, set ZEN_KEEPDUPLICATES=1 to disable
+    bool mergeDuplicates = true;
+    // set from another thread to stop applying at the next node
+    std::atomic<bool> cancelRequested{false};
+
+    // frame and substep state, so that scenes can run side by side; the
+    // default scene uses zeno::state, driven by the python front end
+    GlobalState *globalState = nullptr;
+    std::unique_ptr<GlobalState> m_globalState;
+
     ZENO_API Scene();
     ZENO_API ~Scene();
 
@@ -3,6 +3,7 @@
 #include <zeno/utils/defs.h>
 #include <zeno/core/Descriptor.h>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <map>
 
@@ -14,6 +15,7 @@ struct INode;
 
 struct INodeClass {
     std::unique_ptr<Descriptor> desc;
+    std::string name;  // id it was defined with
 
     ZENO_API INodeClass(Descriptor const &desc);
     ZENO_API virtual ~INodeClass();
@@ -35,6 +37,10 @@ struct ImplNodeClass : INodeClass {
 
 struct Session {
     std::map<std::string, std::unique_ptr<INodeClass>> nodeClasses;
+    // held while libraries define node classes, e.g. a LazyNodeClass
+    // loading its library on another thread, and by readers of
+    // nodeClasses that may run meanwhile
+    mutable std::recursive_mutex nodeClassesMutex;
     std::unique_ptr<Scene> defaultScene;
 
     ZENO_API Session();
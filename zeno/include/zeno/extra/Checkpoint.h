@@ -0,0 +1,27 @@
+#pragma once
+
+#include <zeno/utils/defs.h>
+#include <string>
+
+namespace zeno {
+
+struct Scene;
+
+// the scene's GlobalState and the state of every node (INode::saveState),
+// so that a simulation can go on from the frame it was saved at; loading
+// expects the same graphs to be loaded already. Objects of types without
+// an ObjectCodec, e.g. bullet worlds, can't be saved: saveCheckpoint then
+// writes nothing and returns false
+ZENO_API bool saveCheckpoint(Scene &scene, std::string const &path);
+ZENO_API void loadCheckpoint(Scene &scene, std::string const &path);
+
+// for frame drivers (zenorun, zenqt/system/run.py), configured by env:
+//   ZEN_CHECKPOINT=n       saves <iopath>/checkpoints/<frame>.zckpt every n
+//                          frames, keeping the last ZEN_CHECKPOINT_KEEP (2)
+//   ZEN_RESUME=frame       restores the one of that frame, or the newest
+//   ZEN_RESUME=latest      with latest, before running
+ZENO_API void checkpointFrame(Scene &scene);  // after frameEnd
+ZENO_API int resumeFrame(Scene &scene);  // the first frame to run
+ZENO_API std::string checkpointPath(Scene &scene, int frameid);
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <zeno/utils/defs.h>
+#include <zeno/core/IObject.h>
+#include <memory>
+#include <list>
+#include <string>
+#include <mutex>
+#include <map>
+
+namespace zeno {
+
+struct INode;
+
+// outputs of nodes with the CACHE option, stored under a hash of the node
+// class, params and input contents, so that expensive nodes are skipped
+// across runs, or across machines sharing ZEN_CACHEDIR (default
+// <tmp>/zeno-cache); least recently used entries are evicted once the
+// directory exceeds ZEN_CACHE_BUDGET megabytes (default 4096)
+//
+// only for nodes whose outputs depend on nothing else: the key doesn't
+// see files read, the frame number, or the node's code changing, clear
+// the directory after rebuilding such nodes
+struct DiskCache {
+    using Outputs = std::map<std::string, std::shared_ptr<IObject>>;
+
+    std::string dir;
+    size_t budget = 0;
+
+    ZENO_API DiskCache();
+
+    // empty if the node can't be cached, e.g. an input type we can't hash
+    ZENO_API std::string nodeKey(INode const *node) const;
+    ZENO_API bool load(std::string const &key, Outputs &outputs);
+    ZENO_API void store(std::string const &key, Outputs const &outputs);
+    ZENO_API void evict();  // least recently used entries, down to budget
+
+private:
+    struct Entry {
+        size_t size;
+        std::list<std::string>::iterator lru;
+    };
+
+    // entries are listed once per dir, then kept up to date by our loads
+    // and stores; those of other processes sharing it count from the next
+    // listing, on the next run
+    void scanLocked();
+    void touchLocked(std::string const &key, size_t size);
+    void evictLocked();
+
+    std::mutex m_mtx;
+    std::string m_scanned;  // dir of the entries below
+    std::map<std::string, Entry> m_entries;
+    std::list<std::string> m_lru;  // least recently used first
+    size_t m_total = 0;
+};
+
+ZENO_API DiskCache &getDiskCache();
+
+}
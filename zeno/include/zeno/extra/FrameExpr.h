@@ -0,0 +1,13 @@
+#pragma once
+
+#include <zeno/utils/defs.h>
+#include <string>
+
+namespace zeno {
+
+// evaluate a param string as the editor's python f-string, e.g.
+// "out{frame:04d}.obj"; only arithmetic on `frame` is supported, strings
+// that fail to evaluate are returned unchanged, like zenqt's evaluateExpr
+ZENO_API std::string evaluateFrameExpr(std::string const &expr, int frame);
+
+}
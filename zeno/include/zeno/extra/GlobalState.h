@@ -2,6 +2,7 @@
 
 #include <zeno/utils/defs.h>
 #include <string>
+#include <map>
 
 namespace zeno {
 
@@ -14,6 +15,8 @@ struct GlobalState {
     bool has_frame_completed = false;
     bool has_substep_executed = false;
     bool time_step_integrated = false;
+    int objid = 0;  // next object exported in this frame, see Visualization
+    std::map<std::string, int> exported;  // per name, in this frame
 
     inline bool isAfterFrame() const {
         return has_frame_completed || !time_step_integrated;
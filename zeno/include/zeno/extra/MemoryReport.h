@@ -0,0 +1,54 @@
+#pragma once
+
+#include <zeno/utils/defs.h>
+#include <cstdint>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <map>
+
+namespace zeno {
+
+struct Graph;
+
+// memory held by node outputs, sampled after each applyNodes pass of the
+// scenes' graphs: resident by node at the end of each frame, and the peak
+// during it; enable with ZEN_MEMREPORT=/path/to/report.txt (written on
+// exit) or from python. Sizes are IObject::countMemoryUsage, storage
+// shared by several objects counted once, objects of types not
+// implementing memoryUsage count as 0
+struct MemoryReport {
+    struct Frame {
+        int frameid = 0;
+        int64_t resident = 0;  // at the end of the frame
+        // most held during a pass, an upper bound: outputs replaced by
+        // the pass are counted until the end of it
+        int64_t peak = 0;
+        std::map<std::string, int64_t> nodes;  // graph/node if not main
+    };
+
+    std::atomic<bool> enabled{false};
+    std::string reportPath;
+
+private:
+    std::mutex m_mtx;
+    std::map<int, std::map<std::string, Frame>> m_frames;  // by graph
+
+public:
+    ZENO_API MemoryReport();
+    ZENO_API ~MemoryReport();
+
+    MemoryReport(MemoryReport const &) = delete;
+    MemoryReport &operator=(MemoryReport const &) = delete;
+
+    // base is residentBytes before the pass
+    ZENO_API void record(Graph const &graph, int64_t base);
+    ZENO_API void clear();
+    ZENO_API std::vector<Frame> frames();
+    ZENO_API std::string summary(int frameid = -1);  // -1 for all frames
+};
+
+ZENO_API MemoryReport &getMemoryReport();
+
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <zeno/utils/defs.h>
+#include <zeno/core/IObject.h>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <typeindex>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace zeno {
+
+struct AttributeBuffer;
+
+// binary encoding of objects, for the disk cache and checkpoints; an
+// object written twice to the same sink is written once and referenced
+// after, so that objects shared between slots are still shared when read
+struct ObjectSink {
+    std::map<IObject const *, uint64_t> ids;
+
+    virtual void write(const void *data, size_t n) = 0;
+
+    template <class T>
+    void put(T const &val) {
+        write(&val, sizeof(val));
+    }
+
+    void putString(std::string const &str) {
+        put<uint64_t>(str.size());
+        write(str.data(), str.size());
+    }
+
+    template <class T>
+    void putVector(std::vector<T> const &vec) {
+        put<uint64_t>(vec.size());
+        write(vec.data(), vec.size() * sizeof(T));
+    }
+
+    // the type index and elements of a primitive attribute; sinks only
+    // hashing may write a digest of large buffers instead
+    ZENO_API virtual void putAttribute(AttributeBuffer const &buf);
+};
+
+struct ObjectBuffer : ObjectSink {
+    std::string data;
+
+    virtual void write(const void *p, size_t n) override {
+        data.append((const char *)p, n);
+    }
+};
+
+struct ObjectReader {
+    // truncated or corrupted data; not a zeno::Exception, callers usually
+    // just drop the file
+    struct BadData : std::runtime_error {
+        BadData() : std::runtime_error("bad object data") {}
+    };
+
+    const char *p, *end;
+    std::vector<std::shared_ptr<IObject>> objs;
+
+    ObjectReader(const char *p, const char *end) : p(p), end(end) {}
+
+    void read(void *dst, size_t n) {
+        if ((size_t)(end - p) < n)
+            throw BadData{};
+        std::copy(p, p + n, (char *)dst);
+        p += n;
+    }
+
+    template <class T>
+    T get() {
+        T val;
+        read(&val, sizeof(val));
+        return val;
+    }
+
+    std::string getString() {
+        auto n = get<uint64_t>();
+        if ((size_t)(end - p) < n)
+            throw BadData{};
+        std::string res(p, n);
+        p += n;
+        return res;
+    }
+
+    template <class T>
+    void getVector(std::vector<T> &vec) {
+        auto n = get<uint64_t>();
+        if ((size_t)(end - p) / sizeof(T) < n)
+            throw BadData{};
+        vec.resize(n);
+        read(vec.data(), n * sizeof(T));
+    }
+};
+
+// false if obj, or an object in it, is of a type without codec
+ZENO_API bool encodeObject(ObjectSink &out, IObject const *obj);
+ZENO_API std::shared_ptr<IObject> decodeObject(ObjectReader &in);
+
+struct ObjectCodec {
+    std::string tag;
+    std::function<bool(ObjectSink &, IObject const *)> encode;
+    std::function<std::shared_ptr<IObject>(ObjectReader &)> decode;
+};
+
+// for object types of extensions, by exact type, like ZENDEFNODE:
+//   static int defMyObject = zeno::defObjectCodec<MyObject>("my", enc, dec);
+ZENO_API void _defObjectCodec(std::type_index type, ObjectCodec &&codec);
+
+template <class T, class Enc, class Dec>
+int defObjectCodec(std::string const &tag, Enc &&encode, Dec &&decode) {
+    _defObjectCodec(typeid(T), {tag,
+        [encode] (ObjectSink &out, IObject const *obj) {
+            return encode(out, static_cast<T const &>(*obj));
+        }, std::forward<Dec>(decode)});
+    return 1;
+}
+
+}
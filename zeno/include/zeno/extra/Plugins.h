@@ -0,0 +1,42 @@
+#pragma once
+
+#include <zeno/utils/defs.h>
+#include <zeno/core/Session.h>
+#include <functional>
+#include <string>
+#include <vector>
+#include <mutex>
+
+namespace zeno {
+
+// stands in for a node class whose library is not loaded yet: the
+// descriptor comes from the manifest, the library is only loaded when a
+// node of the class is first created, its ZENDEFNODE then fills in `impl`
+// (see Session::_defNodeClass) and the stub forwards to it
+struct LazyNodeClass : INodeClass {
+    std::function<void()> load;
+    std::unique_ptr<INodeClass> impl;
+    mutable std::once_flag loaded;
+
+    ZENO_API LazyNodeClass(Descriptor const &desc, std::function<void()> load);
+    ZENO_API ~LazyNodeClass() override;
+
+    ZENO_API std::unique_ptr<INode> new_instance() const override;
+};
+
+// the node libraries in libdir, i.e. zenqt/lib
+ZENO_API std::vector<std::string> findLibraries(std::string const &libdir);
+ZENO_API bool loadLibrary(std::string const &path);
+
+// loads every library in libdir, and records the node classes each one
+// defines and which other libraries of libdir it depends on, in
+// libdir/zeno_manifest.json; run at build time by zenorun --write-manifest
+ZENO_API void writePluginManifest(std::string const &libdir);
+
+// registers a LazyNodeClass for every node class in libdir's manifest,
+// returns the file names of the libraries covered, the caller loads the
+// others as before; libraries changed since the manifest was written, or
+// all of them with ZEN_EAGERLOAD=1, are not covered
+ZENO_API std::vector<std::string> loadPluginManifest(std::string const &libdir);
+
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <zeno/utils/defs.h>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <map>
+
+namespace zeno {
+
+// per-node timing, events go to per-thread buffers so that recording never
+// contends with other threads; enable with ZEN_PROFILE=/path/to/trace.json
+// each buffer keeps the last maxEvents events for the trace, summaries are
+// aggregated as events are recorded, for the last maxFrames frames
+struct Profiler {
+    struct Event {
+        std::string name;
+        int64_t begin = 0;     // microseconds since profiler creation
+        int64_t duration = 0;
+        int64_t children = 0;  // time spent in events nested in this one
+        int tid = 0;
+        int depth = 0;
+        int frameid = 0;
+        int substepid = 0;
+    };
+
+    struct Stat {
+        int calls = 0;
+        int64_t total = 0;
+        int64_t self = 0;
+        int64_t max = 0;
+    };
+
+    using Stats = std::map<std::string, Stat>;
+
+    struct ThreadLog {
+        std::mutex mtx;
+        std::vector<Event> events;  // ring of maxEvents, oldest at head
+        size_t head = 0;
+        size_t dropped = 0;
+        std::map<int, Stats> frames;
+        Stats total;
+        int tid = 0;
+    };
+
+    static constexpr size_t maxEvents = 1 << 18;
+    static constexpr size_t maxFrames = 256;
+
+    std::atomic<bool> enabled{false};
+    std::string tracePath;  // chrome trace written here on exit if set
+
+private:
+    std::chrono::steady_clock::time_point m_epoch;
+    std::mutex m_mtx;
+    std::vector<std::unique_ptr<ThreadLog>> m_logs;
+
+public:
+    ZENO_API Profiler();
+    ZENO_API ~Profiler();
+
+    Profiler(Profiler const &) = delete;
+    Profiler &operator=(Profiler const &) = delete;
+
+    ZENO_API ThreadLog &threadLog();
+    ZENO_API void record(ThreadLog &log, Event &&e);
+    ZENO_API int64_t now() const;
+    ZENO_API void clear();
+    ZENO_API std::vector<Event> events();
+    ZENO_API void dumpChromeTrace(std::string const &path);
+    ZENO_API std::string summary(int frameid = -1);  // -1 for all frames
+};
+
+ZENO_API Profiler &getProfiler();
+
+// records one event from construction to destruction, nested scopes on
+// the same thread (subgraphs, loop bodies, pulled inputs) become children;
+// not those of pool tasks the thread helps with while waiting in a scope
+struct ProfileScope {
+    Profiler::ThreadLog *m_log = nullptr;
+    ProfileScope *m_parent = nullptr;
+    bool m_nested = false;
+    int m_task = 0;
+    std::string const *m_name = nullptr;
+    int64_t m_begin = 0;
+    int64_t m_children = 0;
+    int m_depth = 0;
+    int m_frameid = 0;
+    int m_substepid = 0;
+
+    ZENO_API explicit ProfileScope(std::string const &name,
+            int frameid = 0, int substepid = 0);
+    ZENO_API ~ProfileScope();
+
+    ProfileScope(ProfileScope const &) = delete;
+    ProfileScope &operator=(ProfileScope const &) = delete;
+};
+
+}
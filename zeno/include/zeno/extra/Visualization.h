@@ -2,10 +2,37 @@
 
 #include <zeno/utils/defs.h>
 #include <string>
+#include <memory>
+
+namespace zeno {
+struct IObject;
+struct GlobalState;
+}
 
 namespace zeno::Visualization {
 
+// all of these take the frame and iopath of a scene's GlobalState, the
+// overloads without one are for zeno::state of the default scene
+ZENO_API std::string exportPath(GlobalState &state);
 ZENO_API std::string exportPath();
+// named after key rather than numbered in call order, so that paths don't
+// depend on which thread exported first; `key-1`, `key-2`... for objects
+// exported again under the same key in a frame (e.g. in loop bodies)
+ZENO_API std::string exportPath(GlobalState &state, std::string const &key);
+ZENO_API void endFrame(GlobalState &state);
 ZENO_API void endFrame();
 
+// dump obj to a new exportPath() on the export threads, so the solver can
+// go on with the next frame meanwhile; obj is snapshotted (cheap for the
+// copy-on-write prims), objects that can't be cloned are dumped in place.
+// done.lock of a frame is only written once all its dumps are flushed.
+// ZEN_EXPORT_THREADS=0 dumps synchronously, ZEN_EXPORT_BUDGET (MB) and
+// ZEN_EXPORT_QUEUE limit the snapshots in flight before the solver waits
+ZENO_API void exportObject(std::shared_ptr<IObject> const &obj, GlobalState &state);
+ZENO_API void exportObject(std::shared_ptr<IObject> const &obj);
+// to exportPath(state, key), VIEW nodes use INode::viewKey
+ZENO_API void exportObject(std::shared_ptr<IObject> const &obj,
+        GlobalState &state, std::string const &key);
+ZENO_API void flushExports();  // wait until all queued frames are written
+
 }
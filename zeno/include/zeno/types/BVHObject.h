@@ -0,0 +1,79 @@
+#pragma once
+
+#include <zeno/core/IObject.h>
+#include <zeno/utils/vec.h>
+#include <limits>
+#include <vector>
+
+namespace zeno {
+
+struct PrimitiveObject;
+
+// bounding volume hierarchy over the triangles, lines or points of a
+// primitive, built with binned SAH; it keeps its own copy of positions and
+// topology, so that refit() can follow a deforming mesh of fixed topology
+// without rebuilding; queries are const and safe to run concurrently
+struct BVHObject : IObjectClone<BVHObject> {
+    enum Kind { Points, Lines, Tris };
+
+    struct Node {
+        vec3f bmin, bmax;
+        int start;  // inner: left child, the right one follows; leaf: in order
+        int count;  // elements in a leaf, 0 for inner nodes
+        // for the far field of winding numbers: the sum of area-weighted
+        // normals of the triangles below, their area-weighted center, and a
+        // radius around it bounding them
+        vec3f area_n, center;
+        float area, radius;
+    };
+
+    Kind kind = Points;
+    std::vector<vec3f> pos;
+    std::vector<vec3i> tris;
+    std::vector<vec2i> lines;
+    std::vector<int> points;
+    std::vector<int> order;  // element ids, leaves hold ranges of it
+    std::vector<Node> nodes;  // children are stored after their parents
+
+    static constexpr float inf = std::numeric_limits<float>::infinity();
+
+    struct Nearest {
+        float dist = inf;
+        int id = -1;  // element, -1 if none within the max distance
+        vec3f pos{0};
+    };
+
+    struct Hit {
+        float t = inf;
+        int id = -1;  // triangle, -1 on a miss
+    };
+
+    size_t size() const { return order.size(); }
+
+#ifndef ZENO_APIFREE
+    ZENO_API void build(PrimitiveObject const *prim, Kind kind);
+    // false, leaving it untouched, if prim has another topology
+    ZENO_API bool refit(PrimitiveObject const *prim);
+
+    ZENO_API Nearest nearest(vec3f const &p, float maxDist = inf) const;
+    // hits along org + t * dir for t in [0, tmax], triangles only
+    ZENO_API Hit intersect(vec3f const &org, vec3f const &dir, float tmax = inf) const;
+    // elements closer to p than radius
+    ZENO_API int countWithin(vec3f const &p, float radius) const;
+    // generalized winding number, about 1 inside closed meshes and 0
+    // outside; nodes farther than beta times their radius are taken as
+    // dipoles, off by a few percent near the surface at the default
+    ZENO_API float winding(vec3f const &p, float beta = 2) const;
+#endif
+
+    virtual size_t memoryUsage() const override {
+        return sizeof(*this) + pos.capacity() * sizeof(pos[0])
+            + tris.capacity() * sizeof(tris[0])
+            + lines.capacity() * sizeof(lines[0])
+            + points.capacity() * sizeof(points[0])
+            + order.capacity() * sizeof(order[0])
+            + nodes.capacity() * sizeof(nodes[0]);
+    }
+};
+
+}
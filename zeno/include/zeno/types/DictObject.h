@@ -9,6 +9,32 @@ namespace zeno {
 
 struct DictObject : IObjectClone<DictObject> {
   std::map<std::string, std::shared_ptr<IObject>> lut;
+
+  virtual size_t memoryUsage() const override {
+    size_t res = sizeof(*this);
+    for (auto const &[key, obj]: lut) {
+      // a red-black tree node, about four pointers besides the pair
+      res += 4 * sizeof(void *) + sizeof(key) + key.capacity() + sizeof(obj);
+      if (obj)
+        res += obj->memoryUsage();
+    }
+    return res;
+  }
+
+  virtual size_t countMemoryUsage(
+      std::map<void const *, size_t> &counted) const override {
+    if (counted.count(this))
+      return 0;
+    size_t own = sizeof(*this);
+    for (auto const &[key, obj]: lut)
+      own += 4 * sizeof(void *) + sizeof(key) + key.capacity() + sizeof(obj);
+    size_t res = counted[this] = own;
+    for (auto const &[key, obj]: lut) {
+      if (obj)
+        res += obj->countMemoryUsage(counted);
+    }
+    return res;
+  }
 };
 
 }
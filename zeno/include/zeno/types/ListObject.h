@@ -15,6 +15,27 @@ struct ListObject : IObjectClone<ListObject> {
 #else
   virtual void dumpfile(std::string const &path) override {}
 #endif
+
+  virtual size_t memoryUsage() const override {
+    size_t res = sizeof(*this) + arr.capacity() * sizeof(arr[0]);
+    for (auto const &obj: arr) {
+      if (obj)
+        res += obj->memoryUsage();
+    }
+    return res;
+  }
+
+  virtual size_t countMemoryUsage(
+      std::map<void const *, size_t> &counted) const override {
+    if (counted.count(this))
+      return 0;
+    size_t res = counted[this] = sizeof(*this) + arr.capacity() * sizeof(arr[0]);
+    for (auto const &obj: arr) {
+      if (obj)
+        res += obj->countMemoryUsage(counted);
+    }
+    return res;
+  }
 };
 
 }
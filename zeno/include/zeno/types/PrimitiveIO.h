@@ -11,6 +11,8 @@
 namespace zeno {
 
 
+// attribute types are tagged like numpy dtypes, "B" and "H" holding the
+// bits of unorm8 and unorm16
 static void writezpm(PrimitiveObject const *prim, const char *path) {
     FILE *fp = fopen(path, "wb");
 
@@ -32,6 +34,13 @@ static void writezpm(PrimitiveObject const *prim, const char *path) {
             strcpy(type, id);
         _PER_ALTER(float, "f")
         _PER_ALTER(zeno::vec3f, "3f")
+        _PER_ALTER(int, "i")
+        _PER_ALTER(zeno::vec2f, "2f")
+        _PER_ALTER(zeno::vec4f, "4f")
+        _PER_ALTER(zeno::vec3i, "3i")
+        _PER_ALTER(zeno::half, "e")
+        _PER_ALTER(zeno::unorm8, "B")
+        _PER_ALTER(zeno::unorm16, "H")
 #undef _PER_ALTER
         } else {
             //printf("%s\n", name);
@@ -48,7 +57,7 @@ static void writezpm(PrimitiveObject const *prim, const char *path) {
         std::visit([=](auto const &attr) {
             assert(attr.size() == size);
             fwrite(attr.data(), sizeof(attr[0]), size, fp);
-        }, prim->attr(key));
+        }, prim->read_attr(key));
     }
 
     size = prim->points.size();
@@ -112,6 +121,13 @@ static void readzpm(PrimitiveObject *prim, const char *path) {
             prim->add_attr<T>(name);
         _PER_ALTER(float, "f")
         _PER_ALTER(zeno::vec3f, "3f")
+        _PER_ALTER(int, "i")
+        _PER_ALTER(zeno::vec2f, "2f")
+        _PER_ALTER(zeno::vec4f, "4f")
+        _PER_ALTER(zeno::vec3i, "3i")
+        _PER_ALTER(zeno::half, "e")
+        _PER_ALTER(zeno::unorm8, "B")
+        _PER_ALTER(zeno::unorm16, "H")
 #undef _PER_ALTER
         } else {
             //printf("%s\n", name);
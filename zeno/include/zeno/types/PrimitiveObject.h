@@ -2,6 +2,9 @@
 
 #include <zeno/core/IObject.h>
 #include <zeno/utils/vec.h>
+#include <zeno/utils/quantized.h>
+#include <algorithm>
+#include <cstdint>
 #include <variant>
 #include <memory>
 #include <string>
@@ -10,12 +13,146 @@
 
 namespace zeno {
 
-using AttributeArray =
-    std::variant<std::vector<zeno::vec3f>, std::vector<float>>;
+// only ever append alternatives, their index is stored in object caches
+using AttributeArray = std::variant<
+    std::vector<zeno::vec3f>, std::vector<float>,
+    std::vector<int>, std::vector<zeno::vec2f>, std::vector<zeno::vec4f>,
+    std::vector<zeno::vec3i>, std::vector<zeno::half>,
+    std::vector<zeno::unorm8>, std::vector<zeno::unorm16>>;
+
+// one attribute element converted to another type: scalars are broadcast
+// to vectors, vectors truncated or padded with zeros
+template <class T, class S> T attr_cast(S const &val) {
+  if constexpr (std::is_same_v<T, S>) {
+    return val;
+  } else if constexpr (is_vec_v<T>) {
+    T res;
+    for (size_t k = 0; k < is_vec_n<T>; k++) {
+      if constexpr (is_vec_v<S>)
+        res[k] = k < is_vec_n<S> ? attr_cast<decay_vec_t<T>>(val[k])
+                                 : decay_vec_t<T>(0);
+      else
+        res[k] = attr_cast<decay_vec_t<T>>(val);
+    }
+    return res;
+  } else if constexpr (is_vec_v<S>) {
+    return attr_cast<T>(val[0]);
+  } else if constexpr (is_quantized_v<T> || is_quantized_v<S>) {
+    return T((float)val);
+  } else {
+    return T(val);
+  }
+}
+
+template <class T, size_t I = 0> constexpr size_t attributeIndex() {
+  if constexpr (std::is_same_v<std::variant_alternative_t<I, AttributeArray>,
+                               std::vector<T>>)
+    return I;
+  else
+    return attributeIndex<T, I + 1>();
+}
+
+// an array of the alternative at index, of size zeroed elements
+template <size_t I = 0>
+AttributeArray makeAttributeArray(size_t index, size_t size) {
+  if constexpr (I < std::variant_size_v<AttributeArray>) {
+    if (index == I)
+      return AttributeArray(std::in_place_index<I>, size);
+    return makeAttributeArray<I + 1>(index, size);
+  } else {
+    return AttributeArray();
+  }
+}
+
+// storage of large attribute arrays is kept when they're freed and handed
+// out again for arrays of the same type and about the same size, so that
+// frames producing similar primitives stop page-faulting fresh memory in;
+// pooled bytes are capped to ZEN_POOL_BUDGET megabytes (default 512), the
+// least recently freed are released first
+struct AttributePoolStats {
+  size_t pooled = 0;  // bytes held for reuse
+  size_t hits = 0;    // acquires served from the pool
+  size_t misses = 0;  // acquires of pooled sizes that allocated
+};
+
+#ifndef ZENO_APIFREE
+// elements zeroed if zero, else unspecified (zeroed when freshly allocated)
+ZENO_API AttributeArray acquireAttributeArray(size_t index, size_t size, bool zero);
+ZENO_API void recycleAttributeArray(AttributeArray &&arr);
+ZENO_API AttributePoolStats getAttributePoolStats();
+ZENO_API void trimAttributePool();
+#else
+inline AttributeArray acquireAttributeArray(size_t index, size_t size, bool) {
+  return makeAttributeArray(index, size);
+}
+inline void recycleAttributeArray(AttributeArray &&) {}
+#endif
+
+// reference-counted attribute storage: copying a primitive only shares the
+// buffers, and write() duplicates a buffer just before it's modified while
+// shared, so that attributes never written are never copied
+struct AttributeBuffer {
+  std::shared_ptr<AttributeArray> m_ptr;
+  // bumped by write() and resize(), so that anything derived from the
+  // storage before, e.g. a digest (see DiskCache), is known to be stale
+  uint64_t m_version = 0;
+
+  static std::shared_ptr<AttributeArray> wrap(AttributeArray &&arr) {
+    return std::shared_ptr<AttributeArray>(
+        new AttributeArray(std::move(arr)), [](AttributeArray *p) {
+          recycleAttributeArray(std::move(*p));
+          delete p;
+        });
+  }
+
+  AttributeBuffer() : m_ptr(wrap(AttributeArray())) {}
+
+  explicit AttributeBuffer(AttributeArray &&arr) : m_ptr(wrap(std::move(arr))) {}
+
+  AttributeArray const &read() const { return *m_ptr; }
+
+  AttributeArray &write() {
+    if (m_ptr.use_count() > 1)
+      m_ptr = wrap(std::visit([&](auto const &src) {
+        using V = std::decay_t<decltype(src)>;
+        auto arr = acquireAttributeArray(m_ptr->index(), src.size(), false);
+        std::copy(src.begin(), src.end(), std::get<V>(arr).begin());
+        return arr;
+      }, *m_ptr));
+    m_version++;
+    return *m_ptr;
+  }
+
+  // new elements are zeroed and old ones kept if keep, else all of them
+  // are unspecified; storage is swapped for a pooled one when growing
+  void resize(size_t size, bool keep = true) {
+    AttributeArray arr;
+    bool replace = std::visit([&](auto &src) {
+      using V = std::decay_t<decltype(src)>;
+      if (m_ptr.use_count() == 1 && size <= src.capacity()) {
+        src.resize(size);
+        return false;
+      }
+      arr = acquireAttributeArray(m_ptr->index(), size, false);
+      auto &dst = std::get<V>(arr);
+      if (keep) {
+        size_t n = std::min(size, src.size());
+        std::copy(src.begin(), src.begin() + n, dst.begin());
+        std::fill(dst.begin() + n, dst.end(), typename V::value_type{});
+      }
+      return true;
+    }, *m_ptr);
+    if (replace)
+      m_ptr = wrap(std::move(arr));
+    m_version++;
+  }
+
+  bool is_shared() const { return m_ptr.use_count() > 1; }
+};
 
 struct PrimitiveObject : zeno::IObjectClone<PrimitiveObject> {
 
-  std::map<std::string, AttributeArray> m_attrs;
+  std::map<std::string, AttributeBuffer> m_attrs;
   size_t m_size{0};
 
   std::vector<int> points;
@@ -31,43 +168,121 @@ struct PrimitiveObject : zeno::IObjectClone<PrimitiveObject> {
 
   template <class T> std::vector<T> &add_attr(std::string const &name) {
     if (!has_attr(name))
-      m_attrs[name] = std::vector<T>(m_size);
+      m_attrs[name] = AttributeBuffer(
+          acquireAttributeArray(attributeIndex<T>(), m_size, true));
     return attr<T>(name);
   }
   template <class T> std::vector<T> &add_attr(std::string const &name, T value) {
+    if (!has_attr(name)) {
+      auto &arr = add_attr_uninit<T>(name);
+      std::fill(arr.begin(), arr.end(), value);
+    }
+    return attr<T>(name);
+  }
+  // for producers overwriting every element: a new attribute's elements
+  // are unspecified, pooled storage isn't cleared first
+  template <class T> std::vector<T> &add_attr_uninit(std::string const &name) {
     if (!has_attr(name))
-      m_attrs[name] = std::vector<T>(m_size, value);
+      m_attrs[name] = AttributeBuffer(
+          acquireAttributeArray(attributeIndex<T>(), m_size, false));
     return attr<T>(name);
   }
+
+  // attr() on a non-const primitive is for writing: it unshares the buffer,
+  // use read_attr() when only reading; references returned by attr() must
+  // not be kept across copies of this primitive
   template <class T> std::vector<T> &attr(std::string const &name) {
-    return std::get<std::vector<T>>(m_attrs.at(name));
+    return std::get<std::vector<T>>(m_attrs.at(name).write());
   }
 
-  AttributeArray &attr(std::string const &name) { return m_attrs.at(name); }
+  AttributeArray &attr(std::string const &name) {
+    return m_attrs.at(name).write();
+  }
 
   template <class T> std::vector<T> const &attr(std::string const &name) const {
-    return std::get<std::vector<T>>(m_attrs.at(name));
+    return read_attr<T>(name);
   }
 
   AttributeArray const &attr(std::string const &name) const {
-    return m_attrs.at(name);
+    return read_attr(name);
+  }
+
+  template <class T>
+  std::vector<T> const &read_attr(std::string const &name) const {
+    return std::get<std::vector<T>>(m_attrs.at(name).read());
+  }
+
+  AttributeArray const &read_attr(std::string const &name) const {
+    return m_attrs.at(name).read();
   }
 
   bool has_attr(std::string const &name) const {
     return m_attrs.find(name) != m_attrs.end();
   }
 
+  // a converted copy, for consumers taking one type only, see attr_cast
+  template <class T> std::vector<T> attr_as(std::string const &name) const {
+    return std::visit([](auto const &arr) {
+      std::vector<T> res(arr.size());
+      for (size_t i = 0; i < arr.size(); i++)
+        res[i] = attr_cast<T>(arr[i]);
+      return res;
+    }, read_attr(name));
+  }
+
   template <class T> bool attr_is(std::string const &name) const {
-    return std::holds_alternative<std::vector<T>>(m_attrs.at(name));
+    return std::holds_alternative<std::vector<T>>(m_attrs.at(name).read());
   }
 
   size_t size() const { return m_size; }
 
+  virtual size_t memoryUsage() const override {
+    size_t res = sizeof(*this);
+    for (auto const &[key, val] : m_attrs) {
+      std::visit([&](auto const &val) {
+        res += val.capacity() * sizeof(val[0]);
+      }, val.read());
+    }
+    res += points.capacity() * sizeof(points[0]);
+    res += lines.capacity() * sizeof(lines[0]);
+    res += tris.capacity() * sizeof(tris[0]);
+    res += quads.capacity() * sizeof(quads[0]);
+    return res;
+  }
+
+  // attribute buffers shared with copies of us are counted once
+  virtual size_t countMemoryUsage(
+      std::map<void const *, size_t> &counted) const override {
+    if (counted.count(this))
+      return 0;
+    size_t res = counted[this] = sizeof(*this)
+      + points.capacity() * sizeof(points[0])
+      + lines.capacity() * sizeof(lines[0])
+      + tris.capacity() * sizeof(tris[0])
+      + quads.capacity() * sizeof(quads[0]);
+    for (auto const &[key, val] : m_attrs) {
+      void const *buf = val.m_ptr.get();
+      if (counted.count(buf))
+        continue;
+      res += counted[buf] = std::visit([](auto const &val) {
+        return val.capacity() * sizeof(val[0]);
+      }, val.read());
+    }
+    return res;
+  }
+
   void resize(size_t size) {
     m_size = size;
-    for (auto &[key, val] : m_attrs) {
-      std::visit([&](auto &val) { val.resize(m_size); }, val);
-    }
+    for (auto &[key, val] : m_attrs)
+      val.resize(m_size);
+  }
+
+  // resize leaving all elements of all attributes unspecified, for
+  // producers about to overwrite them; shared buffers aren't copied
+  void resize_uninit(size_t size) {
+    m_size = size;
+    for (auto &[key, val] : m_attrs)
+      val.resize(m_size, false);
   }
 };
 
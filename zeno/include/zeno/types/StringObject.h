@@ -19,6 +19,10 @@ struct StringObject : IObjectClone<StringObject> {
   void set(std::string const &x) {
     value = x;
   }
+
+  virtual size_t memoryUsage() const override {
+    return sizeof(*this) + value.capacity();
+  }
 };
 
 }
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <zeno/utils/defs.h>
+#include <functional>
+#include <exception>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <condition_variable>
+
+namespace zeno {
+
+// work-stealing pool: each worker owns a deque, pops its own tasks LIFO
+// and steals others' FIFO; tasks submitted from outside go to a shared queue
+struct ThreadPool {
+    using Task = std::function<void()>;
+
+private:
+    struct Worker {
+        std::mutex mtx;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+    std::deque<Task> m_injected;
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    std::atomic<int> m_pending{0};
+    bool m_stopped = false;
+
+    bool pop_task(int self, Task &task);
+    void worker_main(int self);
+
+public:
+    ZENO_API explicit ThreadPool(int nthreads);
+    ZENO_API ~ThreadPool();
+
+    ThreadPool(ThreadPool const &) = delete;
+    ThreadPool &operator=(ThreadPool const &) = delete;
+
+    ZENO_API void submit(Task task);
+    // run one pending task on the calling thread, used to help while waiting
+    ZENO_API bool run_one();
+    // help running tasks until running drops to 0, blocking while there is
+    // none to take; whoever drops it must call notify_done() afterwards
+    ZENO_API void help_until_done(std::atomic<int> const &running);
+    ZENO_API void notify_done();
+
+    int size() const {
+        return m_threads.size();
+    }
+};
+
+// threads zeno keeps busy at most, ZEN_NUM_THREADS or the hardware's: the
+// pool is sized by it and OpenMP capped to it; extensions with schedulers
+// of their own (e.g. TBB under OpenVDB) should cap them to it too
+ZENO_API int getThreadBudget();
+ZENO_API ThreadPool &getThreadPool();
+
+// pool tasks the calling thread is running, nested ones included: 2 for
+// a task taken while waiting on a task group inside another task, 0 out
+// of any; code keeping per-thread state can tell their tasks apart by it
+ZENO_API int getTaskDepth();
+
+// fork-join helper: wait() helps executing pool tasks, only blocking when
+// there is none to take, so task groups can be nested inside tasks without
+// deadlocking the pool
+struct TaskGroup {
+    ThreadPool &pool;
+    std::atomic<int> m_running{0};
+    std::mutex m_mtx;
+    std::exception_ptr m_error;
+
+    explicit TaskGroup(ThreadPool &pool = getThreadPool()) : pool(pool) {}
+
+    ~TaskGroup() {
+        pool.help_until_done(m_running);
+    }
+
+    template <class F>
+    void run(F &&f) {
+        m_running.fetch_add(1, std::memory_order_relaxed);
+        pool.submit([this, f = std::forward<F>(f)] () mutable {
+            try {
+                f();
+            } catch (...) {
+                std::lock_guard lck(m_mtx);
+                if (!m_error)
+                    m_error = std::current_exception();
+            }
+            // the group may be gone as soon as the count drops
+            auto &p = pool;
+            if (m_running.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                p.notify_done();
+        });
+    }
+
+    bool has_error() {
+        std::lock_guard lck(m_mtx);
+        return (bool)m_error;
+    }
+
+    void wait() {
+        pool.help_until_done(m_running);
+        if (m_error) {
+            auto err = m_error;
+            m_error = nullptr;
+            std::rethrow_exception(err);
+        }
+    }
+};
+
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <zeno/utils/ThreadPool.h>
+#include <functional>
+#include <algorithm>
+#include <iterator>
+#include <cstddef>
+#include <vector>
+
+namespace zeno {
+
+// loops over the shared pool instead of OpenMP, so that they nest in and
+// run beside parallel nodes within the thread budget; the range is cut in
+// chunks of grain indices, 0 for about four chunks per thread, and ranges
+// of one chunk, or all with a budget of one, run on the calling thread
+//
+// the caller works on its own chunks only, never on unrelated pool tasks
+// as TaskGroup::wait does, so loops are fine under a node's mutex; helpers
+// started after all chunks are taken just return
+
+inline size_t parallel_grain(size_t n, size_t grain) {
+    if (grain)
+        return grain;
+    size_t chunks = 4 * (size_t)getThreadPool().size() + 4;
+    return std::max<size_t>(512, (n + chunks - 1) / chunks);
+}
+
+namespace _parallel_details {
+
+struct Loop {
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> done{0};
+    std::atomic<bool> failed{false};
+    size_t nchunks = 0;
+    std::function<void(size_t)> body;  // only called on a claimed chunk
+    std::exception_ptr error;
+
+    void work() {
+        size_t c;
+        while ((c = next.fetch_add(1, std::memory_order_relaxed)) < nchunks) {
+            if (!failed.load(std::memory_order_relaxed)) {
+                try {
+                    body(c);
+                } catch (...) {
+                    if (!failed.exchange(true))
+                        error = std::current_exception();
+                }
+            }
+            done.fetch_add(1, std::memory_order_acq_rel);
+        }
+    }
+};
+
+}
+
+template <class F>
+void parallel_for(size_t begin, size_t end, F const &f, size_t grain = 0) {
+    if (begin >= end)
+        return;
+    grain = parallel_grain(end - begin, grain);
+    if (end - begin <= grain || getThreadBudget() == 1) {
+        for (size_t i = begin; i < end; i++)
+            f(i);
+        return;
+    }
+    auto loop = std::make_shared<_parallel_details::Loop>();
+    loop->nchunks = (end - begin + grain - 1) / grain;
+    loop->body = [&f, begin, end, grain] (size_t c) {
+        size_t b = begin + c * grain, e = std::min(end, b + grain);
+        for (size_t i = b; i < e; i++)
+            f(i);
+    };
+    auto &pool = getThreadPool();
+    size_t nhelpers = std::min(loop->nchunks - 1, (size_t)pool.size());
+    for (size_t k = 0; k < nhelpers; k++)
+        pool.submit([loop] { loop->work(); });
+    loop->work();
+    // chunks claimed but not done are running on other threads right now
+    while (loop->done.load(std::memory_order_acquire) < loop->nchunks)
+        std::this_thread::yield();
+    if (loop->error)
+        std::rethrow_exception(loop->error);
+}
+
+template <class F>
+void parallel_for(size_t n, F const &f, size_t grain = 0) {
+    parallel_for(0, n, f, grain);
+}
+
+// op(acc, f(i)) within each chunk, then chunk results in order, so that
+// the result only depends on the grain for non-associative ops (floats)
+template <class T, class F, class Op>
+T parallel_reduce(size_t begin, size_t end, T identity, F const &f,
+        Op const &op, size_t grain = 0) {
+    if (begin >= end)
+        return identity;
+    grain = parallel_grain(end - begin, grain);
+    size_t nchunks = (end - begin + grain - 1) / grain;
+    std::vector<T> partial(nchunks, identity);
+    parallel_for(nchunks, [&] (size_t c) {
+        size_t b = begin + c * grain, e = std::min(end, b + grain);
+        T acc = identity;
+        for (size_t i = b; i < e; i++)
+            acc = op(acc, f(i));
+        partial[c] = acc;
+    }, 1);
+    T res = identity;
+    for (auto const &val: partial)
+        res = op(res, val);
+    return res;
+}
+
+// sorts chunks concurrently, then merges neighbours pairwise in rounds;
+// not stable, like std::sort
+template <class It, class Comp>
+void parallel_sort(It first, It last, Comp const &comp, size_t grain = 0) {
+    size_t n = std::distance(first, last);
+    grain = parallel_grain(n, grain);
+    if (n <= grain) {
+        std::sort(first, last, comp);
+        return;
+    }
+    size_t nchunks = (n + grain - 1) / grain;
+    parallel_for(nchunks, [&] (size_t c) {
+        std::sort(first + c * grain, first + std::min(n, (c + 1) * grain), comp);
+    }, 1);
+    for (size_t width = grain; width < n; width *= 2) {
+        parallel_for((n + 2 * width - 1) / (2 * width), [&] (size_t k) {
+            size_t b = k * 2 * width;
+            size_t m = std::min(n, b + width), e = std::min(n, b + 2 * width);
+            if (m < e)
+                std::inplace_merge(first + b, first + m, first + e, comp);
+        }, 1);
+    }
+}
+
+template <class It>
+void parallel_sort(It first, It last, size_t grain = 0) {
+    parallel_sort(first, last, std::less<>{}, grain);
+}
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+namespace zeno {
+
+// compact scalar storage for attributes: each converts from and to float,
+// so arithmetic on them happens in float and only storing rounds
+
+// IEEE binary16, rounded to nearest even, overflowing to infinity
+struct half {
+  uint16_t bits;
+
+  half() = default;
+
+  half(float f) {
+    uint32_t x;
+    std::memcpy(&x, &f, sizeof(x));
+    uint32_t sign = (x >> 16) & 0x8000;
+    uint32_t absx = x & 0x7fffffff;
+    if (absx >= 0x7f800000) {  // inf, or nan kept quiet
+      bits = sign | 0x7c00 | (absx > 0x7f800000 ? 0x200 : 0);
+    } else if (absx >= 0x477ff000) {  // rounds to 65520 or more
+      bits = sign | 0x7c00;
+    } else if (absx < 0x38800000) {  // subnormal, in units of 2^-24
+      float a;
+      std::memcpy(&a, &absx, sizeof(a));
+      bits = sign | (uint16_t)std::nearbyint(a * 16777216.0f);
+    } else {  // rebias the exponent by 127 - 15, round the dropped bits
+      absx += 0xc8000fff + ((absx >> 13) & 1);
+      bits = sign | (absx >> 13);
+    }
+  }
+
+  operator float() const {
+    uint32_t sign = (uint32_t)(bits & 0x8000) << 16;
+    uint32_t exp = (bits >> 10) & 0x1f;
+    uint32_t mant = bits & 0x3ff;
+    if (exp == 0) {
+      float f = mant * (1.0f / 16777216.0f);
+      return sign ? -f : f;
+    }
+    uint32_t x = sign | (exp == 31 ? 0x7f800000 | (mant << 13)
+        : ((exp + 112) << 23) | (mant << 13));
+    float f;
+    std::memcpy(&f, &x, sizeof(f));
+    return f;
+  }
+};
+
+// [0, 1] in N-bit steps, clamped when stored, nan stored as 0
+template <class U> struct unorm {
+  static constexpr float scale = (float)(U)~(U)0;
+
+  U bits;
+
+  unorm() = default;
+
+  unorm(float f)
+      : bits((U)std::lround((f > 0 ? (f < 1 ? f : 1) : 0) * scale)) {}
+
+  operator float() const { return bits / scale; }
+};
+
+using unorm8 = unorm<uint8_t>;
+using unorm16 = unorm<uint16_t>;
+
+template <class T> struct is_quantized : std::false_type {};
+template <> struct is_quantized<half> : std::true_type {};
+template <class U> struct is_quantized<unorm<U>> : std::true_type {};
+
+template <class T>
+inline constexpr bool is_quantized_v = is_quantized<std::decay_t<T>>::value;
+
+} // namespace zeno
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <zeno/utils/parallel.h>
+#include <zeno/utils/quantized.h>
+#include <zeno/utils/vec.h>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <cmath>
+#include <vector>
+
+namespace zeno {
+
+// per component statistics of an array of scalars or vectors: sums and
+// moments in double, min and max in the element's type (float for the
+// quantized ones), argmin and argmax the first index reaching them, -1 if
+// none (empty, or all NaN)
+template <class S, size_t N>
+struct ArrayStats {
+    size_t count = 0;
+    double sum[N]{};
+    double m2[N]{};  // sum of squared deviations from the mean
+    S min[N], max[N];
+    int argmin[N], argmax[N];
+
+    static constexpr S highest() {
+        if constexpr (std::numeric_limits<S>::has_infinity)
+            return std::numeric_limits<S>::infinity();
+        else
+            return std::numeric_limits<S>::max();
+    }
+
+    static constexpr S lowest() {
+        if constexpr (std::numeric_limits<S>::has_infinity)
+            return -std::numeric_limits<S>::infinity();
+        else
+            return std::numeric_limits<S>::lowest();
+    }
+
+    ArrayStats() {
+        std::fill_n(min, N, highest());
+        std::fill_n(max, N, lowest());
+        std::fill_n(argmin, N, -1);
+        std::fill_n(argmax, N, -1);
+    }
+
+    double mean(size_t c) const {
+        return count ? sum[c] / count : 0;
+    }
+
+    // of the population
+    double variance(size_t c) const {
+        return count ? m2[c] / count : 0;
+    }
+
+    // Chan et al.'s pairwise update, other holding the elements after ours
+    void merge(ArrayStats const &other) {
+        if (!other.count)
+            return;
+        if (!count) {
+            *this = other;
+            return;
+        }
+        double n = double(count) + other.count;
+        for (size_t c = 0; c < N; c++) {
+            double delta = other.mean(c) - mean(c);
+            m2[c] += other.m2[c] + delta * delta * count / n * other.count;
+            sum[c] += other.sum[c];
+            if (other.min[c] < min[c]) {
+                min[c] = other.min[c];
+                argmin[c] = other.argmin[c];
+            }
+            if (other.max[c] > max[c]) {
+                max[c] = other.max[c];
+                argmax[c] = other.argmax[c];
+            }
+        }
+        count += other.count;
+    }
+};
+
+template <class T>
+using array_stats_scalar_t = std::conditional_t<
+    is_quantized_v<decay_vec_t<T>>, float, decay_vec_t<T>>;
+
+template <class T>
+using ArrayStatsFor = ArrayStats<array_stats_scalar_t<T>, is_vec_n<T>>;
+
+// counts of values in [lo, hi] split in counts.size() equal bins, the last
+// one closed, others left out; vectors are binned by their length
+struct ArrayHistogram {
+    float lo = 0, hi = 1;
+    std::vector<size_t> counts;
+};
+
+namespace _reduction_details {
+
+// fixed, so that results are the same for any number of threads
+constexpr size_t kChunk = 1 << 14;
+// independent accumulators the compiler can keep in one vector register
+constexpr size_t kLanes = 8;
+
+template <class S, class T>
+S component(T const &val, size_t c) {
+    if constexpr (is_vec_v<T>)
+        return S(val[c]);
+    else
+        return S(val);
+}
+
+template <class T>
+float magnitude(T const &val) {
+    if constexpr (is_vec_v<T>) {
+        float res = 0;
+        for (size_t c = 0; c < is_vec_n<T>; c++) {
+            float x = (float)val[c];
+            res += x * x;
+        }
+        return std::sqrt(res);
+    } else {
+        return (float)val;
+    }
+}
+
+template <class T>
+void histogram_chunk(T const *data, size_t b, size_t e,
+        ArrayHistogram const &hist, std::vector<std::atomic<size_t>> &counts) {
+    size_t nbins = hist.counts.size();
+    std::vector<size_t> local(nbins);
+    float scale = hist.hi > hist.lo ? nbins / (hist.hi - hist.lo) : 0;
+    for (size_t i = b; i < e; i++) {
+        float x = magnitude(data[i]);
+        if (!(x >= hist.lo && x <= hist.hi))
+            continue;
+        local[std::min(size_t((x - hist.lo) * scale), nbins - 1)]++;
+    }
+    for (size_t k = 0; k < nbins; k++)
+        if (local[k])
+            counts[k].fetch_add(local[k], std::memory_order_relaxed);
+}
+
+template <class S, size_t N, class T>
+void stats_chunk(T const *data, size_t b, size_t e, ArrayStats<S, N> &st) {
+    constexpr size_t L = kLanes;
+    double sum[L][N] = {};
+    S mn[L][N], mx[L][N];
+    for (size_t l = 0; l < L; l++) {
+        std::fill_n(mn[l], N, st.highest());
+        std::fill_n(mx[l], N, st.lowest());
+    }
+    // min and max taking the accumulator first skip NaNs
+    size_t i = b;
+    for (; i + L <= e; i += L) {
+        for (size_t l = 0; l < L; l++) {
+            for (size_t c = 0; c < N; c++) {
+                S x = component<S>(data[i + l], c);
+                sum[l][c] += x;
+                mn[l][c] = std::min(mn[l][c], x);
+                mx[l][c] = std::max(mx[l][c], x);
+            }
+        }
+    }
+    for (; i < e; i++) {
+        for (size_t c = 0; c < N; c++) {
+            S x = component<S>(data[i], c);
+            sum[0][c] += x;
+            mn[0][c] = std::min(mn[0][c], x);
+            mx[0][c] = std::max(mx[0][c], x);
+        }
+    }
+    st.count = e - b;
+    for (size_t l = 0; l < L; l++) {
+        for (size_t c = 0; c < N; c++) {
+            st.sum[c] += sum[l][c];
+            st.min[c] = std::min(st.min[c], mn[l][c]);
+            st.max[c] = std::max(st.max[c], mx[l][c]);
+        }
+    }
+
+    // the chunk is still in cache for the deviations from its mean
+    double mean[N], m2[L][N] = {};
+    for (size_t c = 0; c < N; c++)
+        mean[c] = st.mean(c);
+    for (i = b; i + L <= e; i += L) {
+        for (size_t l = 0; l < L; l++) {
+            for (size_t c = 0; c < N; c++) {
+                double d = component<S>(data[i + l], c) - mean[c];
+                m2[l][c] += d * d;
+            }
+        }
+    }
+    for (; i < e; i++) {
+        for (size_t c = 0; c < N; c++) {
+            double d = component<S>(data[i], c) - mean[c];
+            m2[0][c] += d * d;
+        }
+    }
+    for (size_t l = 0; l < L; l++)
+        for (size_t c = 0; c < N; c++)
+            st.m2[c] += m2[l][c];
+
+    size_t found = 0;
+    for (i = b; i < e && found < 2 * N; i++) {
+        for (size_t c = 0; c < N; c++) {
+            S x = component<S>(data[i], c);
+            if (st.argmin[c] < 0 && x == st.min[c])
+                st.argmin[c] = (int)i, found++;
+            if (st.argmax[c] < 0 && x == st.max[c])
+                st.argmax[c] = (int)i, found++;
+        }
+    }
+}
+
+}
+
+// one parallel pass over arr, also binning into hist if given, its range
+// and number of bins set
+template <class T>
+ArrayStatsFor<T> array_stats(std::vector<T> const &arr, ArrayHistogram *hist = nullptr) {
+    using namespace _reduction_details;
+    size_t n = arr.size();
+    size_t nchunks = (n + kChunk - 1) / kChunk;
+    std::vector<ArrayStatsFor<T>> partial(nchunks);
+    std::vector<std::atomic<size_t>> counts(hist ? hist->counts.size() : 0);
+    parallel_for(nchunks, [&] (size_t k) {
+        size_t b = k * kChunk, e = std::min(n, b + kChunk);
+        stats_chunk(arr.data(), b, e, partial[k]);
+        if (hist && counts.size())
+            histogram_chunk(arr.data(), b, e, *hist, counts);
+    }, 1);
+    ArrayStatsFor<T> res;
+    for (auto const &st: partial)
+        res.merge(st);
+    if (hist)
+        for (size_t k = 0; k < counts.size(); k++)
+            hist->counts[k] = counts[k].load();
+    return res;
+}
+
+template <class T>
+void array_histogram(std::vector<T> const &arr, ArrayHistogram &hist) {
+    using namespace _reduction_details;
+    size_t n = arr.size();
+    std::vector<std::atomic<size_t>> counts(hist.counts.size());
+    if (counts.size()) {
+        parallel_for((n + kChunk - 1) / kChunk, [&] (size_t k) {
+            size_t b = k * kChunk;
+            histogram_chunk(arr.data(), b, std::min(n, b + kChunk), hist, counts);
+        }, 1);
+    }
+    for (size_t k = 0; k < counts.size(); k++)
+        hist.counts[k] = counts[k].load();
+}
+
+}
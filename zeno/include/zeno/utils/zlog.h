@@ -2,7 +2,12 @@
 
 #define FMT_HEADER_ONLY
 
+#include <zeno/utils/defs.h>
+#include <functional>
 #include <sstream>
+#include <cstdio>
+#include <atomic>
+#include <string>
 
 #if ZLOG_USE_ANDROID
 #include <android/log.h>
@@ -19,6 +24,19 @@ namespace zlog {
         fatal = 'f',
     };
 
+    // severity, in declaration order, for comparing against thresholds
+    constexpr int level_rank(LogLevel level) {
+        switch (level) {
+        case LogLevel::trace: return 0;
+        case LogLevel::debug: return 1;
+        case LogLevel::info: return 2;
+        case LogLevel::critical: return 3;
+        case LogLevel::warning: return 4;
+        case LogLevel::error: return 5;
+        default: return 6;
+        }
+    }
+
 #if ZLOG_USE_ANDROID
     static inline void log_print(LogLevel level, const char *msg) {
         __android_log_print(level == LogLevel::trace ? ANDROID_LOG_VERBOSE :
@@ -59,11 +77,91 @@ namespace zlog {
         _impl_format(os, std::string(fmt).c_str(), std::forward<Ts>(ts)...);
     }
 
+    struct Module;
+
+    // messages are queued in a lock-free ring buffer and written by a
+    // background thread, so that hot loops don't serialize on stderr;
+    // errors and worse are flushed right away, as is everything with
+    // ZEN_LOG_SYNC set
+    ZENO_API void push(Module const &mod, LogLevel level, std::string &&msg);
+    ZENO_API void flush();
+    ZENO_API std::ostringstream &_impl_stream();  // thread-local, reused
+
+    // where flushed messages go, stderr (or logcat) by default; called on
+    // one thread at a time, pass nullptr to restore the default
+    using Sink = std::function<void(LogLevel level, const char *module,
+            std::string const &msg)>;
+    ZENO_API void set_sink(Sink sink);
+
+    // messages below the threshold of their module are dropped before
+    // formatting; thresholds come from ZEN_LOG, e.g. "warning,zfx=debug"
+    // (default info), or set_level, which without a module sets them all
+    struct Module {
+        const char *name;
+        std::atomic<int> threshold;
+
+        bool enabled(LogLevel level) const {
+            return level_rank(level) >= threshold.load(std::memory_order_relaxed);
+        }
+
+        template <class ...Ts>
+        void log(LogLevel level, const char *fmt, Ts &&...ts) const {
+            if (!enabled(level))
+                return;
+            auto &ss = _impl_stream();
+            format(ss, fmt, std::forward<Ts>(ts)...);
+            push(*this, level, ss.str());
+        }
+
+        template <class ...Ts>
+        void trace(Ts &&...ts) const {
+            log(LogLevel::trace, std::forward<Ts>(ts)...);
+        }
+
+        template <class ...Ts>
+        void debug(Ts &&...ts) const {
+            log(LogLevel::debug, std::forward<Ts>(ts)...);
+        }
+
+        template <class ...Ts>
+        void info(Ts &&...ts) const {
+            log(LogLevel::info, std::forward<Ts>(ts)...);
+        }
+
+        template <class ...Ts>
+        void critical(Ts &&...ts) const {
+            log(LogLevel::critical, std::forward<Ts>(ts)...);
+        }
+
+        template <class ...Ts>
+        void warning(Ts &&...ts) const {
+            log(LogLevel::warning, std::forward<Ts>(ts)...);
+        }
+
+        template <class ...Ts>
+        void error(Ts &&...ts) const {
+            log(LogLevel::error, std::forward<Ts>(ts)...);
+        }
+
+        template <class ...Ts>
+        void fatal(Ts &&...ts) const {
+            log(LogLevel::fatal, std::forward<Ts>(ts)...);
+        }
+    };
+
+    // the same module for the same name, e.g. at namespace scope:
+    //   static auto &log = zlog::module("zfx");
+    ZENO_API Module &module(const char *name);
+    ZENO_API void set_level(LogLevel level, const char *name = nullptr);
+
+    inline Module &default_module() {
+        static Module &mod = module("zeno");
+        return mod;
+    }
+
     template <class ...Ts>
     void log(LogLevel level, const char *fmt, Ts &&...ts) {
-        std::stringstream ss;
-        format(ss, fmt, std::forward<Ts>(ts)...);
-        log_print(level, ss.str().c_str());
+        default_module().log(level, fmt, std::forward<Ts>(ts)...);
     }
 
     template <class ...Ts>
@@ -8,15 +8,23 @@
 
 namespace zeno {
 
+// libraries audited for applying their nodes concurrently are built with
+// ZENO_CONCURRENT_NODES defined, those of others are marked "exclusive"
 template <class F>
 inline int defNodeClass(F const &ctor, std::string const &id, Descriptor const &desc = {}) {
+#ifdef ZENO_CONCURRENT_NODES
     return getSession().defNodeClass(ctor, id, desc);
+#else
+    auto exclusive = desc;
+    exclusive.traits.insert("exclusive");
+    return getSession().defNodeClass(ctor, id, exclusive);
+#endif
 }
 
 template <class T>
 [[deprecated("use ZENDEFNODE(T, ...)")]]
 inline int defNodeClass(std::string const &id, Descriptor const &desc = {}) {
-    return getSession().defNodeClass(std::make_unique<T>, id, desc);
+    return defNodeClass(std::make_unique<T>, id, desc);
 }
 
 inline std::string dumpDescriptors() {
@@ -39,6 +47,10 @@ inline void addNode(std::string const &cls, std::string const &id) {
     return getSession().getDefaultScene().getGraph().addNode(cls, id);
 }
 
+inline void removeNode(std::string const &id) {
+    return getSession().getDefaultScene().getGraph().removeNode(id);
+}
+
 inline void completeNode(std::string const &id) {
     return getSession().getDefaultScene().getGraph().completeNode(id);
 }
@@ -52,6 +64,10 @@ inline void bindNodeInput(std::string const &dn, std::string const &ds,
     return getSession().getDefaultScene().getGraph().bindNodeInput(dn, ds, sn, ss);
 }
 
+inline void unbindNodeInput(std::string const &dn, std::string const &ds) {
+    return getSession().getDefaultScene().getGraph().unbindNodeInput(dn, ds);
+}
+
 inline void setNodeParam(std::string const &id, std::string const &par,
         IValue const &val) {
     return getSession().getDefaultScene().getGraph().setNodeParam(id, par, val);
@@ -61,6 +77,10 @@ inline void setNodeOption(std::string const &id, std::string const &name) {
     return getSession().getDefaultScene().getGraph().setNodeOption(id, name);
 }
 
+inline void unsetNodeOption(std::string const &id, std::string const &name) {
+    return getSession().getDefaultScene().getGraph().unsetNodeOption(id, name);
+}
+
 inline void loadScene(const char *json) {
     return getSession().getDefaultScene().loadScene(json);
 }
@@ -4,6 +4,7 @@
 #include <zeno/types/StringObject.h>
 #include <zeno/types/ConditionObject.h>
 #include <zeno/extra/evaluate_condition.h>
+#include <zeno/extra/ObjectCodec.h>
 
 
 namespace zeno {
@@ -26,6 +27,28 @@ struct CachedByKey : zeno::INode {
     }
 
     virtual void apply() override {}
+
+    virtual bool saveState(ObjectSink &out) const override {
+        if (!INode::saveState(out))
+            return false;
+        out.put<uint64_t>(cache.size());
+        for (auto const &[key, value]: cache) {
+            out.putString(key);
+            if (!encodeObject(out, value.get()))
+                return false;
+        }
+        return true;
+    }
+
+    virtual void loadState(ObjectReader &in) override {
+        INode::loadState(in);
+        cache.clear();
+        auto n = in.get<uint64_t>();
+        for (uint64_t i = 0; i < n; i++) {
+            auto key = in.getString();
+            cache[key] = decodeObject(in);
+        }
+    }
 };
 
 ZENDEFNODE(CachedByKey, {
@@ -33,6 +56,7 @@ ZENDEFNODE(CachedByKey, {
     {"output"},
     {},
     {"control"},
+    {"lazy"},
 });
 
 struct CachedOnce : zeno::INode {
@@ -49,6 +73,20 @@ struct CachedOnce : zeno::INode {
         auto ptr = get_input("input");
         set_output("output", std::move(ptr));
     }
+
+    virtual bool saveState(ObjectSink &out) const override {
+        if (!INode::saveState(out))
+            return false;
+        out.put(m_done);
+        return !m_done || saveOutputs(out);
+    }
+
+    virtual void loadState(ObjectReader &in) override {
+        INode::loadState(in);
+        m_done = in.get<bool>();
+        if (m_done)
+            loadOutputs(in);
+    }
 };
 
 ZENDEFNODE(CachedOnce, {
@@ -56,6 +94,7 @@ ZENDEFNODE(CachedOnce, {
     {"output"},
     {},
     {"control"},
+    {"lazy"},
 });
 
 
@@ -80,6 +119,20 @@ struct CachedIf : zeno::INode {
         auto ptr = get_input("input");
         set_output("output", std::move(ptr));
     }
+
+    virtual bool saveState(ObjectSink &out) const override {
+        if (!INode::saveState(out))
+            return false;
+        out.put(m_done);
+        return !m_done || saveOutputs(out);
+    }
+
+    virtual void loadState(ObjectReader &in) override {
+        INode::loadState(in);
+        m_done = in.get<bool>();
+        if (m_done)
+            loadOutputs(in);
+    }
 };
 
 ZENDEFNODE(CachedIf, {
@@ -87,6 +140,7 @@ ZENDEFNODE(CachedIf, {
     {"output"},
     {},
     {"control"},
+    {"lazy"},
 });
 
 }
@@ -4,6 +4,9 @@
 #include <zeno/types/ConditionObject.h>
 #include <zeno/extra/ContextManaged.h>
 #include <zeno/extra/evaluate_condition.h>
+#include <zeno/utils/ThreadPool.h>
+#include <functional>
+#include <atomic>
 
 namespace zeno {
 
@@ -12,6 +15,17 @@ struct IBeginFor : zeno::INode {
 
     virtual bool isContinue() const = 0;
     virtual void update() = 0;
+
+    // random access to the iterations, for running them in parallel
+    virtual int iterationCount() const = 0;
+    virtual void iterationOutputs(int index,
+        std::map<std::string, std::shared_ptr<IObject>> &outs) const = 0;
+
+    bool isParallel() const {
+        auto it = params.find("parallel");
+        return it != params.end() && std::holds_alternative<int>(it->second)
+            && std::get<int>(it->second);
+    }
 };
 
 
@@ -31,18 +45,28 @@ struct BeginFor : IBeginFor {
     }
 
     virtual void update() override {
-        auto ret = std::make_shared<zeno::NumericObject>();
-        ret->set(m_index);
-        set_output("index", std::move(ret));
+        iterationOutputs(m_index, outputs);
         m_index++;
     }
+
+    virtual int iterationCount() const override {
+        return m_count;
+    }
+
+    virtual void iterationOutputs(int index,
+        std::map<std::string, std::shared_ptr<IObject>> &outs) const override {
+        auto ret = std::make_shared<zeno::NumericObject>();
+        ret->set(index);
+        outs["index"] = std::move(ret);
+    }
 };
 
 ZENDEFNODE(BeginFor, {
     {"count"},
     {"index", "FOR"},
-    {},
+    {{"int", "parallel", "0"}},
     {"control"},
+    {"lazy"},
 });
 
 
@@ -55,11 +79,22 @@ struct EndFor : zeno::ContextManagedNode {
             abort();
         }
         graph->applyNode(sn);
+        if (fore->isParallel()) {
+            applyParallel(fore);
+            return;
+        }
+        // `object` of each iteration is gathered into `list`
+        auto list = std::make_shared<zeno::ListObject>();
+        bool gather = has_input("object");
         std::unique_ptr<zeno::Context> old_ctx = nullptr;
         while (fore->isContinue()) {
             fore->update();
             push_context();
-            zeno::INode::doApply();
+            for (auto const &link: inputLinks) {
+                requireInput(link);
+            }
+            if (gather)
+                list->arr.push_back(get_input("object"));
             old_ctx = pop_context();
         }
         if (old_ctx) {
@@ -67,16 +102,21 @@ struct EndFor : zeno::ContextManagedNode {
             graph->ctx->mergeVisited(*old_ctx);
             old_ctx = nullptr;
         }
+        set_output("list", std::move(list));
+        coreApply();  // VIEW shows the gathered list, once
     }
 
+    void applyParallel(IBeginFor *fore);
+
     virtual void apply() override {}
 };
 
 ZENDEFNODE(EndFor, {
-    {"FOR"},
-    {},
+    {"FOR", "object"},
+    {"list"},
     {},
     {"control"},
+    {"lazy"},
 });
 
 
@@ -95,8 +135,268 @@ ZENDEFNODE(BreakFor, {
     {},
     {},
     {"control"},
+    {"lazy"},
 });
 
+
+namespace {
+
+// stands for a node outside of the loop body in a LoopInstance, outputs
+// are those of the outside node, evaluated once before the iterations
+struct LoopProxy : zeno::INode {
+    virtual void doApply() override {}
+    virtual void apply() override {}
+};
+
+// private copy of the loop body, so that iterations running concurrently
+// each get their own node outputs; nodes keep their names, so that lazy
+// nodes looking others up in graph->nodes (e.g. nested loops) still work
+struct LoopInstance {
+    zeno::Graph graph;
+    zeno::INode *fore = nullptr;
+    std::vector<std::pair<zeno::INode *, zeno::INode *>> clones;
+    std::set<zeno::INode *> proxies;
+    // outputs of outside nodes, by proxy, copied for each iteration as
+    // non-pure nodes of the body take them
+    std::map<zeno::INode *, std::pair<zeno::INode *, std::set<std::string>>> copied;
+    std::string viewPrefix;  // of the EndFor node, see run
+    int depth = 0;
+
+    LoopInstance(zeno::Graph *outer, IBeginFor *fore_,
+            std::vector<zeno::INode *> const &body,
+            std::set<zeno::INode *> const &outside,
+            std::string const &viewPrefix) : viewPrefix(viewPrefix) {
+        graph.scene = outer->scene;
+        graph.isViewed = outer->isViewed;
+        depth = outer->ctx->depth + 1;
+        for (auto node: body) {
+            auto clone = node->nodeClass->new_instance();
+            clone->graph = &graph;
+            clone->myname = node->myname;
+            clone->nodeClass = node->nodeClass;
+            clone->params = node->params;
+            clone->options = node->options;
+            clone->inputBounds = node->inputBounds;
+            clone->doComplete();
+            clones.emplace_back(node, clone.get());
+            graph.nodes[node->myname] = std::move(clone);
+        }
+        std::map<zeno::INode *, zeno::INode *> sources;
+        for (auto node: outside) {
+            auto proxy = add_proxy(node);
+            proxy->outputs = node->outputs;
+            proxy->muted_output = node->muted_output;
+            proxies.insert(proxy);
+            sources[proxy] = node;
+        }
+        fore = add_proxy(fore_);
+        graph.compile();
+
+        for (auto const &[node, clone]: clones) {
+            if (clone->nodeClass->desc->has_trait("pure"))
+                continue;
+            for (auto const &link: clone->inputLinks) {
+                auto it = sources.find(link.srcNode);
+                if (it == sources.end())
+                    continue;
+                // seen modifying its inputs in-place before, see
+                // INode::updateVersion, that can't be undone by copies
+                if (node->mutatesInputs)
+                    throw zeno::Exception("`" + node->myname
+                            + "` writes to `" + link.sn
+                            + "` from outside of the parallel loop body");
+                auto &[src, keys] = copied[link.srcNode];
+                src = it->second;
+                keys.insert(link.ss);
+            }
+        }
+    }
+
+    zeno::INode *add_proxy(zeno::INode *node) {
+        auto proxy = std::make_unique<LoopProxy>();
+        proxy->graph = &graph;
+        proxy->myname = node->myname;
+        proxy->nodeClass = node->nodeClass;
+        auto res = proxy.get();
+        graph.nodes[node->myname] = std::move(proxy);
+        return res;
+    }
+
+    static std::shared_ptr<zeno::IObject> copy(zeno::INode *src,
+            std::shared_ptr<zeno::IObject> const &obj) {
+        if (!obj)
+            return nullptr;
+        auto res = obj->clone();
+        if (!res)
+            throw zeno::Exception("`" + src->myname + "` from outside of the "
+                    "parallel loop body can't be copied for each iteration");
+        return res;
+    }
+
+    void run(IBeginFor *fore_, int index, std::vector<std::string> const &tails) {
+        fore_->iterationOutputs(index, fore->outputs);
+        for (auto const &[proxy, source]: copied) {
+            auto const &[src, keys] = source;
+            if (src->muted_output) {
+                proxy->muted_output = copy(src, src->muted_output);
+                continue;
+            }
+            for (auto const &key: keys) {
+                if (auto it = src->outputs.find(key); it != src->outputs.end())
+                    proxy->outputs[key] = copy(src, it->second);
+            }
+        }
+        // VIEW objects of each iteration apart, whichever instance runs it
+        graph.viewPrefix = viewPrefix + std::to_string(index) + "_";
+        // nested, so that nodes are never reused or released in the body
+        graph.ctx = std::make_unique<zeno::Context>(graph.nodesById.size(), depth);
+        for (auto const &name: tails) {
+            graph.applyNode(name);
+        }
+        graph.ctx = nullptr;
+    }
+
+    // an outside object passed through as output is how in-place nodes
+    // show, these would race with other iterations
+    void check_shared_writes() const {
+        for (auto const &[node, clone]: clones) {
+            for (auto const &link: clone->inputLinks) {
+                if (!proxies.count(link.srcNode) || !*link.dstSlot)
+                    continue;
+                for (auto const &[key, obj]: clone->outputs) {
+                    if (obj == *link.dstSlot)
+                        throw zeno::Exception("`" + clone->myname
+                                + "` writes to `" + link.sn
+                                + "` from outside of the parallel loop body");
+                }
+            }
+        }
+    }
+};
+
+}
+
+void EndFor::applyParallel(IBeginFor *fore) {
+    // the body is whatever EndFor pulls that depends on BeginFor; nested
+    // loop heads come along so that each instance iterates them on its own
+    std::map<zeno::INode *, bool> depends;
+    std::function<bool(zeno::INode *)> depends_on_fore;
+    depends_on_fore = [&] (zeno::INode *node) {
+        if (node == fore)
+            return true;
+        if (auto it = depends.find(node); it != depends.end())
+            return it->second;
+        depends[node] = false;
+        bool res = false;
+        for (auto const &link: node->inputLinks) {
+            if (link.srcNode && depends_on_fore(link.srcNode))
+                res = true;
+        }
+        return depends[node] = res;
+    };
+
+    std::vector<zeno::INode *> body;
+    std::set<zeno::INode *> outside, seen;
+    bool exclusive = false;
+    std::function<void(zeno::INode *)> visit;
+    visit = [&] (zeno::INode *node) {
+        if (node == fore || !seen.insert(node).second)
+            return;
+        if (!depends_on_fore(node) && !dynamic_cast<IBeginFor *>(node)) {
+            outside.insert(node);
+            return;
+        }
+        if (dynamic_cast<BreakFor *>(node))
+            throw zeno::Exception("BreakFor is not allowed in parallel loop `"
+                    + fore->myname + "`");
+        if (node->nodeClass->desc->has_trait("serial"))
+            throw zeno::Exception("`" + node->myname + "` touches graph-wide "
+                    "state and can't run in parallel loop `" + fore->myname + "`");
+        if (node->isExclusive())
+            exclusive = true;
+        body.push_back(node);
+        for (auto const &link: node->inputLinks) {
+            if (link.srcNode)
+                visit(link.srcNode);
+        }
+    };
+
+    std::vector<std::string> tails;
+    std::string object_sn, object_ss;
+    for (auto const &link: inputLinks) {
+        if (link.ds == "object") {
+            object_sn = link.sn;
+            object_ss = link.ss;
+        }
+        if (!link.srcNode || link.srcNode == fore)
+            continue;
+        visit(link.srcNode);
+        tails.push_back(link.sn);
+    }
+    for (auto node: outside) {  // loop invariants, evaluated only once
+        graph->applyNode(node);
+    }
+
+    int count = fore->iterationCount();
+    std::vector<std::shared_ptr<zeno::IObject>> results(count);
+    std::atomic<LoopInstance *> last{nullptr};
+    auto gather = [&] (LoopInstance &inst, int index) {
+        if (object_sn.size())
+            results[index] = inst.graph.getNodeOutput(object_sn, object_ss);
+        if (index == count - 1)
+            last = &inst;  // takes no iteration after this one
+    };
+
+    if (count > 0) {
+        // the first iteration runs alone, to reject shared writes before
+        // any of them could race
+        auto prefix = viewKey() + "_";
+        auto first = std::make_unique<LoopInstance>(graph, fore, body, outside, prefix);
+        first->run(fore, 0, tails);
+        first->check_shared_writes();
+        gather(*first, 0);
+
+        std::vector<std::unique_ptr<LoopInstance>> insts;
+        insts.push_back(std::move(first));
+        // exclusive nodes in the body take the iterations one at a time
+        int ninsts = exclusive ? 1 : std::min(count - 1, zeno::getThreadPool().size());
+        for (int i = 1; i < ninsts; i++) {
+            insts.push_back(std::make_unique<LoopInstance>(graph, fore, body, outside, prefix));
+        }
+
+        std::atomic<int> next{1};
+        zeno::TaskGroup group;
+        for (int i = 0; i < ninsts; i++) {
+            group.run([&, inst = insts[i].get()] {
+                for (int index; (index = next++) < count;) {
+                    if (group.has_error())
+                        return;
+                    inst->run(fore, index, tails);
+                    gather(*inst, index);
+                }
+            });
+        }
+        group.wait();
+        fore->iterationOutputs(count - 1, fore->outputs);
+
+        // like the serial loop, nodes referred from outside see the last
+        // iteration; written here, our graph isn't for the workers to touch
+        for (auto const &[node, clone]: last.load()->clones) {
+            for (auto const &[key, obj]: clone->outputs) {
+                node->outputs[key] = obj;
+            }
+            node->muted_output = clone->muted_output;
+            graph->ctx->setVisited(node);
+        }
+    }
+
+    auto list = std::make_shared<zeno::ListObject>();
+    if (object_sn.size())
+        list->arr = std::move(results);
+    set_output("list", std::move(list));
+    coreApply();
+}
+
 struct IfElse : zeno::INode {
     virtual void doApply() override {
         requireInput("cond");
@@ -126,6 +426,7 @@ ZENDEFNODE(IfElse, {
     {"result"},
     {},
     {"control"},
+    {"lazy"},
 });
 
 
@@ -295,20 +596,29 @@ struct BeginForEach : IBeginFor {
     }
 
     virtual void update() override {
-        auto ret = std::make_shared<zeno::NumericObject>();
-        ret->set(m_index);
-        set_output("index", std::move(ret));
-        auto obj = m_list->arr[m_index];
-        set_output("object", std::move(obj));
+        iterationOutputs(m_index, outputs);
         m_index++;
     }
+
+    virtual int iterationCount() const override {
+        return m_list->arr.size();
+    }
+
+    virtual void iterationOutputs(int index,
+        std::map<std::string, std::shared_ptr<IObject>> &outs) const override {
+        auto ret = std::make_shared<zeno::NumericObject>();
+        ret->set(index);
+        outs["index"] = std::move(ret);
+        outs["object"] = m_list->arr[index];
+    }
 };
 
 ZENDEFNODE(BeginForEach, {
     {"list"},
     {"object", "index", "FOR"},
-    {},
+    {{"int", "parallel", "0"}},
     {"control"},
+    {"lazy"},
 });
 
 }
@@ -20,6 +20,7 @@ ZENDEFNODE(DictSize, {
     {{"numeric:int", "size"}},
     {},
     {"dict"},
+    {"pure"},
 });
 
 
@@ -37,6 +38,7 @@ ZENDEFNODE(DictGetItem, {
     {{"any", "object"}},
     {},
     {"dict"},
+    {"pure"},
 });
 
 
@@ -52,6 +54,7 @@ ZENDEFNODE(EmptyDict, {
     {{"dict", "dict"}},
     {},
     {"dict"},
+    {"pure"},
 });
 
 
@@ -93,6 +96,7 @@ ZENDEFNODE(MakeDict, {
     {{"dict", "dict"}},
     {},
     {"dict"},
+    {"pure"},
 });
 
 
@@ -112,6 +116,7 @@ ZENDEFNODE(DictUnion, {
     {{"dict", "dict"}},
     {},
     {"dict"},
+    {"pure"},
 });
 
 
@@ -136,6 +141,7 @@ ZENDEFNODE(ExtractDict, {
     {},
     {},
     {"dict"},
+    {"pure"},
 });
 
 }
@@ -32,6 +32,7 @@ ZENDEFNODE(FuncBegin, {
     {"args", "FUNC"},
     {},
     {"functional"},
+    {"lazy"},
 });
 
 
@@ -68,6 +69,7 @@ ZENDEFNODE(FuncEnd, {
     {"function"},
     {},
     {"functional"},
+    {"lazy"},
 });
 
 
@@ -91,6 +93,7 @@ ZENDEFNODE(FuncCall, {
     {"rets"},
     {},
     {"functional"},
+    {"serial"},
 });
 
 }
@@ -19,6 +19,7 @@ ZENDEFNODE(ListLength, {
     {"length"},
     {},
     {"list"},
+    {"pure"},
 });
 
 
@@ -36,6 +37,7 @@ ZENDEFNODE(ExtractList, {
     {"object"},
     {},
     {"list"},
+    {"pure"},
 });
 
 
@@ -51,6 +53,7 @@ ZENDEFNODE(EmptyList, {
     {"list"},
     {},
     {"list"},
+    {"pure"},
 });
 
 
@@ -91,6 +94,7 @@ ZENDEFNODE(MakeSmallList, {
     {"list"},
     {},
     {"list"},
+    {"pure"},
 });
 
 ZENO_API void ListObject::dumpfile(std::string const &path) {
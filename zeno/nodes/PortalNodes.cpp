@@ -21,6 +21,7 @@ ZENDEFNODE(PortalIn, {
     {},
     {{"string", "name", "RenameMe!"}},
     {"portal"},
+    {"serial"},
 });
 
 struct PortalOut : zeno::INode {
@@ -38,6 +39,7 @@ ZENDEFNODE(PortalOut, {
     {"port"},
     {{"string", "name", "RenameMe!"}},
     {"portal"},
+    {"serial"},
 });
 
 
@@ -57,6 +59,7 @@ ZENDEFNODE(Route, {
     {"output"},
     {},
     {"portal"},
+    {"pure"},
 });
 
 
@@ -77,6 +80,7 @@ ZENDEFNODE(Clone, {
     {"newObject"},
     {},
     {"portal"},
+    {"pure"},
 });
 
 
@@ -55,8 +55,9 @@ ZENDEFNODE(RunBeforeFrame, {
 
 struct SetFrameTime : zeno::INode {
     virtual void apply() override {
+        auto &state = getGlobalState();
         auto time = get_input<zeno::NumericObject>("time")->get<float>();
-        zeno::state.frame_time = time;
+        state.frame_time = time;
     }
 };
 
@@ -65,12 +66,14 @@ ZENDEFNODE(SetFrameTime, {
     {},
     {},
     {"frame"},
+    {"serial"},
 });
 
 struct GetFrameTime : zeno::INode {
     virtual void apply() override {
+        auto &state = getGlobalState();
         auto time = std::make_shared<zeno::NumericObject>();
-        time->set(zeno::state.frame_time);
+        time->set(state.frame_time);
         set_output("time", std::move(time));
     }
 };
@@ -80,12 +83,14 @@ ZENDEFNODE(GetFrameTime, {
     {"time"},
     {},
     {"frame"},
+    {"serial"},
 });
 
 struct GetFrameTimeElapsed : zeno::INode {
     virtual void apply() override {
+        auto &state = getGlobalState();
         auto time = std::make_shared<zeno::NumericObject>();
-        time->set(zeno::state.frame_time_elapsed);
+        time->set(state.frame_time_elapsed);
         set_output("time", std::move(time));
     }
 };
@@ -95,12 +100,14 @@ ZENDEFNODE(GetFrameTimeElapsed, {
     {"time"},
     {},
     {"frame"},
+    {"serial"},
 });
 
 struct GetFrameNum : zeno::INode {
     virtual void apply() override {
+        auto &state = getGlobalState();
         auto num = std::make_shared<zeno::NumericObject>();
-        num->set(zeno::state.frameid);
+        num->set(state.frameid);
         set_output("FrameNum", std::move(num));
     }
 };
@@ -110,13 +117,15 @@ ZENDEFNODE(GetFrameNum, {
     {"FrameNum"},
     {},
     {"frame"},
+    {"serial"},
 });
 
 struct GetTime : zeno::INode {
     virtual void apply() override {
+        auto &state = getGlobalState();
         auto time = std::make_shared<zeno::NumericObject>();
-        time->set(zeno::state.frameid * zeno::state.frame_time
-            + zeno::state.frame_time_elapsed);
+        time->set(state.frameid * state.frame_time
+            + state.frame_time_elapsed);
         set_output("time", std::move(time));
     }
 };
@@ -126,12 +135,14 @@ ZENDEFNODE(GetTime, {
     {"time"},
     {},
     {"frame"},
+    {"serial"},
 });
 
 struct GetFramePortion : zeno::INode {
     virtual void apply() override {
+        auto &state = getGlobalState();
         auto portion = std::make_shared<zeno::NumericObject>();
-        portion->set(zeno::state.frame_time_elapsed / zeno::state.frame_time);
+        portion->set(state.frame_time_elapsed / state.frame_time);
         set_output("FramePortion", std::move(portion));
     }
 };
@@ -141,24 +152,26 @@ ZENDEFNODE(GetFramePortion, {
     {"FramePortion"},
     {},
     {"frame"},
+    {"serial"},
 });
 
 struct IntegrateFrameTime : zeno::INode {
     virtual void apply() override {
-        float dt = zeno::state.frame_time;
+        auto &state = getGlobalState();
+        float dt = state.frame_time;
         if (has_input("desired_dt")) {
             dt = get_input<zeno::NumericObject>("desired_dt")->get<float>();
             auto min_scale = get_param<float>("min_scale");
-            dt = std::max(std::fabs(dt), min_scale * zeno::state.frame_time);
+            dt = std::max(std::fabs(dt), min_scale * state.frame_time);
         }
-        if (zeno::state.frame_time_elapsed + dt >= zeno::state.frame_time) {
-            dt = zeno::state.frame_time - zeno::state.frame_time_elapsed;
-            zeno::state.frame_time_elapsed = zeno::state.frame_time;
-            zeno::state.has_frame_completed = true;
+        if (state.frame_time_elapsed + dt >= state.frame_time) {
+            dt = state.frame_time - state.frame_time_elapsed;
+            state.frame_time_elapsed = state.frame_time;
+            state.has_frame_completed = true;
         } else {
-            zeno::state.frame_time_elapsed += dt;
+            state.frame_time_elapsed += dt;
         }
-        zeno::state.time_step_integrated = true;
+        state.time_step_integrated = true;
         auto ret = std::make_shared<zeno::NumericObject>();
         ret->set(dt);
         set_output("actual_dt", std::move(ret));
@@ -170,5 +183,6 @@ ZENDEFNODE(IntegrateFrameTime, {
     {"actual_dt"},
     {{"float", "min_scale", "0.0001"}},
     {"frame"},
+    {"serial"},
 });
 #endif
@@ -18,6 +18,7 @@ ZENDEFNODE(MakeString, {
     {{"string", "value"}},
     {{"string", "value", ""}},
     {"string"},
+    {"pure"},
 });
 
 struct MakeMultilineString : MakeString {
@@ -28,6 +29,7 @@ ZENDEFNODE(MakeMultilineString, {
     {{"string", "value"}},
     {{"multiline_string", "value", ""}},
     {"string"},
+    {"pure"},
 });
 
 /*static int objid = 0;
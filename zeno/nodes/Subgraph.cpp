@@ -3,6 +3,7 @@
 #include <zeno/extra/Visualization.h>
 #endif
 #include <zeno/types/ConditionObject.h>
+#include <zeno/extra/ObjectCodec.h>
 #include <zeno/utils/safe_at.h>
 #include <cassert>
 
@@ -55,19 +56,62 @@ ZENDEFNODE(SubOutput, {
      {"string", "name", "output1"},
      {"string", "defl", ""}},
     {"subgraph"},
+    {"serial"},
 });
 
 
+// serial only against other nodes of their own graph, i.e. of our instance
+static bool is_instance_serial(zeno::INode *node) {
+    auto const &name = node->nodeClass->name;
+    return name == "SubOutput" || name == "PortalIn" || name == "PortalOut";
+}
+
 struct Subgraph : zeno::INode {
-    virtual void apply() override {
+    // our own instance of the subgraph, so that its node outputs and state
+    // (e.g. ONCE nodes) are per call site, and we can run concurrently
+    // with other Subgraph nodes calling the same one, unless it has
+    // exclusive nodes or serial ones touching global state
+    std::unique_ptr<zeno::Graph> m_inst;
+    bool m_exclusive = false;
+    std::vector<Subgraph *> m_nested;  // Subgraph nodes of the instance
+
+    zeno::Graph *getInstance() {
         auto name = get_param<std::string>("name");
-
-        auto subg = safe_at(graph->scene->graphs, name, "subgraph");
+        auto const &subg = safe_at(graph->scene->graphs, name, "subgraph");
         assert(subg->scene == graph->scene);
+        if (!m_inst || m_inst->editVersion != subg->editVersion) {
+            m_inst = subg->instantiate();  // edited by the editor since
+            m_exclusive = false;
+            m_nested.clear();
+            for (auto const &[id, node]: m_inst->nodes) {
+                if (auto sub = dynamic_cast<Subgraph *>(node.get()))
+                    m_nested.push_back(sub);
+                else if (node->isExclusive() || (!is_instance_serial(node.get())
+                            && node->nodeClass->desc->has_trait("serial")))
+                    m_exclusive = true;
+            }
+        }
+        return m_inst.get();
+    }
+
+    virtual bool isExclusive() override {
+        getInstance();
+        if (m_exclusive)
+            return true;
+        // asked each time, they are instantiated again when edited
+        for (auto sub: m_nested)
+            if (sub->isExclusive())
+                return true;
+        return false;
+    }
+
+    virtual void apply() override {
+        auto subg = getInstance();
 
 #ifdef ZENO_VISUALIZATION
         // VIEW subnodes only if subgraph is VIEW'ed
         subg->isViewed = has_option("VIEW");
+        subg->viewPrefix = viewKey() + "_";
 #endif
 
         for (auto const &[key, obj]: inputs) {
@@ -78,8 +122,7 @@ struct Subgraph : zeno::INode {
         for (auto &[key, obj]: subg->subOutputs) {
 #ifdef ZENO_VISUALIZATION
             if (subg->isViewed && !subg->hasAnyView) {
-                auto path = zeno::Visualization::exportPath();
-                obj->dumpfile(path);
+                zeno::Visualization::exportObject(obj, getGlobalState(), viewKey());
                 subg->hasAnyView = true;
             }
 #endif
@@ -89,6 +132,20 @@ struct Subgraph : zeno::INode {
         subg->subInputs.clear();
         subg->subOutputs.clear();
     }
+
+    virtual bool saveState(zeno::ObjectSink &out) const override {
+        if (!INode::saveState(out))
+            return false;
+        out.put<bool>(m_inst != nullptr);
+        return !m_inst || m_inst->saveState(out);
+    }
+
+    virtual void loadState(zeno::ObjectReader &in) override {
+        INode::loadState(in);
+        m_inst = nullptr;
+        if (in.get<bool>())
+            getInstance()->loadState(in);
+    }
 };
 
 ZENDEFNODE(Subgraph, {
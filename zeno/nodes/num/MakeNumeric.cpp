@@ -16,6 +16,7 @@ ZENDEFNODE(NumericInt, {
     {{"numeric:int", "value"}},
     {{"int", "value", "0"}},
     {"numeric"},
+    {"pure"},
 });
 
 
@@ -34,6 +35,7 @@ ZENDEFNODE(NumericIntVec2, {
     {{"numeric:vec2i", "vec2"}},
     {{"int", "x", "0"}, {"int", "y", "0"}},
     {"numeric"},
+    {"pure"},
 });
 
 
@@ -53,6 +55,7 @@ ZENDEFNODE(NumericIntVec3, {
     {{"numeric:vec3i", "vec3"}},
     {{"int", "x", "0"}, {"int", "y", "0"}, {"int", "z", "0"}},
     {"numeric"},
+    {"pure"},
 });
 
 
@@ -74,6 +77,7 @@ ZENDEFNODE(NumericIntVec4, {
     {{"float", "x", "0"}, {"float", "y", "0"},
      {"float", "z", "0"}, {"float", "w", "0"}},
     {"numeric"},
+    {"pure"},
 });
 
 
@@ -90,6 +94,7 @@ ZENDEFNODE(NumericFloat, {
     {{"numeric:float", "value"}},
     {{"float", "value", "0"}},
     {"numeric"},
+    {"pure"},
 });
 
 
@@ -108,6 +113,7 @@ ZENDEFNODE(NumericVec2, {
     {{"numeric:vec2f", "vec2"}},
     {{"float", "x", "0"}, {"float", "y", "0"}},
     {"numeric"},
+    {"pure"},
 });
 
 
@@ -128,6 +134,7 @@ ZENDEFNODE(NumericVec3, {
     {{"numeric:vec3f", "vec3"}},
     {{"float", "x", "0"}, {"float", "y", "0"}, {"float", "z", "0"}},
     {"numeric"},
+    {"pure"},
 });
 
 
@@ -149,6 +156,7 @@ ZENDEFNODE(NumericVec4, {
     {{"float", "x", "0"}, {"float", "y", "0"},
      {"float", "z", "0"}, {"float", "w", "0"}},
     {"numeric"},
+    {"pure"},
 });
 
 }
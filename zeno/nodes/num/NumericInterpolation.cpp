@@ -84,6 +84,7 @@ ZENDEFNODE(NumericInterpolation, {
     {{"numeric", "dst"}},
     {{"int", "isClamped", "0"}},
     {"numeric"},
+    {"pure"},
 });
 
 }
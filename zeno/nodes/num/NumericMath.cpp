@@ -41,6 +41,7 @@ ZENDEFNODE(MakeOrthonormalBase, {
     {{"numeric:vec3f", "normal"}, "tangent", {"numeric:vec3f", "bitangent"}},
     {},
     {"math"},
+    {"pure"},
 });
 
 
@@ -72,6 +73,7 @@ ZENDEFNODE(UnpackNumericVec, {
      {"numeric:scalar", "Z"}, {"numeric:scalar", "W"}},
     {},
     {"numeric"},
+    {"pure"},
 }); // TODO: add PackNumericVec too.
 
 
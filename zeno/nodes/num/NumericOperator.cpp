@@ -220,6 +220,7 @@ ZENDEFNODE(NumericOperator, {
     {{"numeric", "ret"}},
     {{"string", "op_type", "copy"}},
     {"numeric"},
+    {"pure"},
 });
 
 }
@@ -4,6 +4,7 @@
 #include <zeno/types/NumericObject.h>
 #include <zeno/types/PrimitiveObject.h>
 #include <zeno/utils/vec.h>
+#include <zeno/utils/parallel.h>
 #include <zeno/zeno.h>
 
 namespace zeno {
@@ -36,22 +37,20 @@ struct Make2DGridPrimitive : INode {
 
     auto prim = std::make_shared<PrimitiveObject>();
     prim->resize(nx * ny);
-    auto &pos = prim->add_attr<vec3f>("pos");
-#pragma omp parallel for
+    auto &pos = prim->add_attr_uninit<vec3f>("pos");
     // for (size_t y = 0; y < ny; y++) {
     //     for (size_t x = 0; x < nx; x++) {
-    for (int index = 0; index < nx * ny; index++) {
+    parallel_for((size_t)(nx * ny), [&] (size_t index) {
       int x = index % nx;
       int y = index / nx;
       vec3f p = o + x * ax + y * ay;
       size_t i = x + y * nx;
       pos[i] = p;
       // }
-    }
+    });
     if (get_param<int>("hasFaces")) {
         prim->tris.resize((nx - 1) * (ny - 1) * 2);
-#pragma omp parallel for
-        for (int index = 0; index < (nx - 1) * (ny - 1); index++) {
+        parallel_for((size_t)((nx - 1) * (ny - 1)), [&] (size_t index) {
           int x = index % (nx - 1);
           int y = index / (nx - 1);
           prim->tris[index * 2][0] = y * nx + x;
@@ -60,7 +59,7 @@ struct Make2DGridPrimitive : INode {
           prim->tris[index * 2 + 1][0] = (y + 1) * nx + x + 1;
           prim->tris[index * 2 + 1][1] = (y + 1) * nx + x;
           prim->tris[index * 2 + 1][2] = y * nx + x;
-        }
+        });
     }
     set_output("prim", std::move(prim));
   }
@@ -81,6 +80,8 @@ ZENDEFNODE(Make2DGridPrimitive,
         {"int", "hasFaces", "1"},
         }, /* category: */ {
         "primitive",
+        }, /* traits: */ {
+        "pure",
         }});
 
 struct Make3DGridPrimitive : INode {
@@ -118,18 +119,17 @@ struct Make3DGridPrimitive : INode {
 
     auto prim = std::make_shared<PrimitiveObject>();
     prim->resize(nx * ny * nz);
-    auto &pos = prim->add_attr<vec3f>("pos");
-#pragma omp parallel for
+    auto &pos = prim->add_attr_uninit<vec3f>("pos");
     // for (size_t y = 0; y < ny; y++) {
     //     for (size_t x = 0; x < nx; x++) {
-    for (int index = 0; index < nx * ny * nz; index++) {
+    parallel_for((size_t)(nx * ny * nz), [&] (size_t index) {
       int x = index % nx;
       int y = index / nx % ny;
       int z = index / nx / ny;
       vec3f p = o + x * ax + y * ay + z * az;
       pos[index] = p;
       // }
-    }
+    });
     set_output("prim", std::move(prim));
   }
 };
@@ -143,6 +143,8 @@ ZENDEFNODE(Make3DGridPrimitive,
         {"int", "isCentered", "0"},
         }, /* category: */ {
         "primitive",
+        }, /* traits: */ {
+        "pure",
         }});
 
 struct MakeCubePrimitive : INode {
@@ -159,18 +161,17 @@ struct MakeCubePrimitive : INode {
     
     auto prim = std::make_shared<PrimitiveObject>();
     prim->resize(nx * ny * nz);
-    auto &pos = prim->add_attr<vec3f>("pos");
-#pragma omp parallel for
+    auto &pos = prim->add_attr_uninit<vec3f>("pos");
     // for (size_t y = 0; y < ny; y++) {
     //     for (size_t x = 0; x < nx; x++) {
-    for (int index = 0; index < nx * ny * nz; index++) {
+    parallel_for((size_t)(nx * ny * nz), [&] (size_t index) {
       int x = index % nx;
       int y = index / nx % ny;
       int z = index / nx / ny;
       vec3f p = o + vec3f(x * spacing, y * spacing, z * spacing);
       pos[index] = p;
       // }
-    }
+    });
     set_output("prim", std::move(prim));
   }
 };
@@ -184,5 +185,7 @@ ZENDEFNODE(MakeCubePrimitive,
         {},
         }, /* category: */ {
         "primitive",
+        }, /* traits: */ {
+        "pure",
         }});
 } // namespace zeno
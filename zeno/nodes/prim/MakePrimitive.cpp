@@ -23,6 +23,8 @@ ZENDEFNODE(MakePrimitive,
     }, /* params: */ {
     }, /* category: */ {
     "primitive",
+    }, /* traits: */ {
+    "pure",
     }});
 
 
@@ -43,6 +45,8 @@ ZENDEFNODE(PrimitiveGetSize,
     }, /* params: */ {
     }, /* category: */ {
     "primitive",
+    }, /* traits: */ {
+    "pure",
     }});
 
 
@@ -65,6 +69,8 @@ ZENDEFNODE(PrimitiveResize,
     }, /* params: */ {
     }, /* category: */ {
     "primitive",
+    }, /* traits: */ {
+    "pure",
     }});
 
 
@@ -73,22 +79,31 @@ struct PrimitiveAddAttr : zeno::INode {
     auto prim = get_input<PrimitiveObject>("prim");
     auto name = std::get<std::string>(get_param("name"));
     auto type = std::get<std::string>(get_param("type"));
-    if (type == "float") {
-      if(has_input("fillValue")){
-        auto fillvalue = get_input<NumericObject>("fillValue")->get<float>();
-        prim->add_attr<float>(name, fillvalue);
-      }
-      else {
-        prim->add_attr<float>(name);
-      }
-    } else if (type == "float3") {
-        if(has_input("fillValue")){
-          auto fillvalue = get_input<NumericObject>("fillValue")->get<vec3f>();
-          prim->add_attr<vec3f>(name, fillvalue);
-        }
-        else {
-          prim->add_attr<vec3f>(name);
+    auto add = [&] (auto tag) {
+        using T = decltype(tag);
+        if (has_input("fillValue")) {
+            auto const &value = get_input<NumericObject>("fillValue")->value;
+            prim->add_attr<T>(name, std::visit([] (auto const &val) {
+                return attr_cast<T>(val);
+            }, value));
+        } else {
+            prim->add_attr<T>(name);
         }
+    };
+    if (0) {
+#define _PER_TYPE(T, id) \
+    } else if (type == id) { \
+        add(T{});
+    _PER_TYPE(float, "float")
+    _PER_TYPE(vec3f, "float3")
+    _PER_TYPE(int, "int")
+    _PER_TYPE(vec2f, "float2")
+    _PER_TYPE(vec4f, "float4")
+    _PER_TYPE(vec3i, "int3")
+    _PER_TYPE(half, "half")
+    _PER_TYPE(unorm8, "unorm8")
+    _PER_TYPE(unorm16, "unorm16")
+#undef _PER_TYPE
     } else {
         printf("%s\n", type.c_str());
         assert(0 && "Bad attribute type");
@@ -108,6 +123,8 @@ ZENDEFNODE(PrimitiveAddAttr,
     {"string", "type", "float3"},
     }, /* category: */ {
     "primitive",
+    }, /* traits: */ {
+    "pure",
     }});
 
 
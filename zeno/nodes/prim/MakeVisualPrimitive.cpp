@@ -67,6 +67,8 @@ ZENDEFNODE(MakeVisualAABBPrimitive,
         {{"int", "connType", "2"}},
         }, /* category: */ {
         "visualize",
+        }, /* traits: */ {
+        "pure",
         }});
 
 
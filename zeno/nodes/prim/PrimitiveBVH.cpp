@@ -0,0 +1,234 @@
+#include <zeno/zeno.h>
+#include <zeno/types/PrimitiveObject.h>
+#include <zeno/types/NumericObject.h>
+#include <zeno/types/BVHObject.h>
+#include <zeno/utils/parallel.h>
+#include <zeno/utils/zlog.h>
+
+namespace zeno {
+
+static auto &bvhlog = zlog::module("bvh");
+
+static BVHObject::Kind bvh_kind(PrimitiveObject const *prim, std::string const &type) {
+    if (type == "tris") return BVHObject::Tris;
+    if (type == "lines") return BVHObject::Lines;
+    if (type == "points") return BVHObject::Points;
+    if (type != "auto")
+        throw zeno::Exception("bad BVH type `" + type + "`");
+    return prim->tris.size() ? BVHObject::Tris
+        : prim->lines.size() ? BVHObject::Lines : BVHObject::Points;
+}
+
+// query nodes write into a copy of prim, sharing its other attributes
+static std::shared_ptr<PrimitiveObject> bvh_query_prim(
+        std::shared_ptr<PrimitiveObject> const &prim, std::vector<vec3f> &pos) {
+    if (prim->has_attr("pos"))
+        pos = prim->attr_as<vec3f>("pos");
+    else
+        pos.assign(prim->size(), vec3f(0));
+    return std::make_shared<PrimitiveObject>(*prim);
+}
+
+static void bvh_need_tris(BVHObject const *bvh, std::string const &node) {
+    if (bvh->kind != BVHObject::Tris)
+        throw zeno::Exception(node + " needs a BVH over triangles");
+}
+
+struct PrimitiveBuildBVH : zeno::INode {
+    virtual void apply() override {
+        auto prim = get_input<PrimitiveObject>("prim");
+        auto type = std::get<std::string>(get_param("type"));
+        auto bvh = std::make_shared<BVHObject>();
+        bvh->build(prim.get(), bvh_kind(prim.get(), type));
+        bvhlog.debug("built {} nodes over {} elements", bvh->nodes.size(), bvh->size());
+        set_output("bvh", std::move(bvh));
+    }
+};
+
+ZENDEFNODE(PrimitiveBuildBVH,
+    { /* inputs: */ {
+    "prim",
+    }, /* outputs: */ {
+    "bvh",
+    }, /* params: */ {
+    {"string", "type", "auto"},
+    }, /* category: */ {
+    "primitive",
+    }, /* traits: */ {
+    "pure",
+    }});
+
+// for a deforming mesh, build once (e.g. ONCE) and refit every frame
+struct BVHRefit : zeno::INode {
+    virtual void apply() override {
+        auto bvh = get_input<BVHObject>("bvh");
+        auto prim = get_input<PrimitiveObject>("prim");
+        if (!bvh->refit(prim.get())) {
+            bvhlog.info("topology changed, rebuilding");
+            bvh->build(prim.get(), bvh->kind);
+        }
+        set_output("bvh", get_input("bvh"));
+    }
+};
+
+ZENDEFNODE(BVHRefit,
+    { /* inputs: */ {
+    "bvh",
+    "prim",
+    }, /* outputs: */ {
+    "bvh",
+    }, /* params: */ {
+    }, /* category: */ {
+    "primitive",
+    }});
+
+struct BVHNearestPoint : zeno::INode {
+    virtual void apply() override {
+        auto bvh = get_input<BVHObject>("bvh");
+        float maxDist = has_input("maxDist")
+            ? get_input<NumericObject>("maxDist")->get<float>() : BVHObject::inf;
+        std::vector<vec3f> pos;
+        auto prim = bvh_query_prim(get_input<PrimitiveObject>("prim"), pos);
+        auto &dist = prim->add_attr_uninit<float>(std::get<std::string>(get_param("distAttr")));
+        auto &near = prim->add_attr_uninit<vec3f>(std::get<std::string>(get_param("posAttr")));
+        auto &id = prim->add_attr_uninit<int>(std::get<std::string>(get_param("idAttr")));
+        parallel_for(pos.size(), [&] (size_t i) {
+            auto res = bvh->nearest(pos[i], maxDist);
+            // nothing within maxDist: -1 and the query point itself
+            dist[i] = res.id < 0 ? -1 : res.dist;
+            near[i] = res.id < 0 ? pos[i] : res.pos;
+            id[i] = res.id;
+        }, 256);
+        set_output("prim", std::move(prim));
+    }
+};
+
+ZENDEFNODE(BVHNearestPoint,
+    { /* inputs: */ {
+    "bvh",
+    "prim",
+    "maxDist",
+    }, /* outputs: */ {
+    "prim",
+    }, /* params: */ {
+    {"string", "distAttr", "dist"},
+    {"string", "posAttr", "nearestPos"},
+    {"string", "idAttr", "nearestId"},
+    }, /* category: */ {
+    "primitive",
+    }, /* traits: */ {
+    "pure",
+    }});
+
+struct BVHRayIntersect : zeno::INode {
+    virtual void apply() override {
+        auto bvh = get_input<BVHObject>("bvh");
+        bvh_need_tris(bvh.get(), "BVHRayIntersect");
+        float maxDist = has_input("maxDist")
+            ? get_input<NumericObject>("maxDist")->get<float>() : BVHObject::inf;
+        std::vector<vec3f> pos;
+        auto prim = bvh_query_prim(get_input<PrimitiveObject>("prim"), pos);
+        // per point directions from dirAttr if present, else the dir input
+        auto dirAttr = std::get<std::string>(get_param("dirAttr"));
+        std::vector<vec3f> dir;
+        if (prim->has_attr(dirAttr))
+            dir = prim->attr_as<vec3f>(dirAttr);
+        else
+            dir.assign(pos.size(), has_input("dir")
+                ? get_input<NumericObject>("dir")->get<vec3f>() : vec3f(0, -1, 0));
+        auto &dist = prim->add_attr_uninit<float>(std::get<std::string>(get_param("distAttr")));
+        auto &hit = prim->add_attr_uninit<vec3f>(std::get<std::string>(get_param("posAttr")));
+        auto &id = prim->add_attr_uninit<int>(std::get<std::string>(get_param("idAttr")));
+        parallel_for(pos.size(), [&] (size_t i) {
+            auto res = bvh->intersect(pos[i], dir[i], maxDist);
+            // misses: -1 and the origin
+            dist[i] = res.id < 0 ? -1 : res.t;
+            hit[i] = res.id < 0 ? pos[i] : pos[i] + res.t * dir[i];
+            id[i] = res.id;
+        }, 256);
+        set_output("prim", std::move(prim));
+    }
+};
+
+ZENDEFNODE(BVHRayIntersect,
+    { /* inputs: */ {
+    "bvh",
+    "prim",
+    "dir",
+    "maxDist",
+    }, /* outputs: */ {
+    "prim",
+    }, /* params: */ {
+    {"string", "dirAttr", "dir"},
+    {"string", "distAttr", "hitDist"},
+    {"string", "posAttr", "hitPos"},
+    {"string", "idAttr", "hitId"},
+    }, /* category: */ {
+    "primitive",
+    }, /* traits: */ {
+    "pure",
+    }});
+
+struct BVHRadiusCount : zeno::INode {
+    virtual void apply() override {
+        auto bvh = get_input<BVHObject>("bvh");
+        float radius = get_input<NumericObject>("radius")->get<float>();
+        std::vector<vec3f> pos;
+        auto prim = bvh_query_prim(get_input<PrimitiveObject>("prim"), pos);
+        auto &count = prim->add_attr_uninit<int>(std::get<std::string>(get_param("countAttr")));
+        parallel_for(pos.size(), [&] (size_t i) {
+            count[i] = bvh->countWithin(pos[i], radius);
+        }, 256);
+        set_output("prim", std::move(prim));
+    }
+};
+
+ZENDEFNODE(BVHRadiusCount,
+    { /* inputs: */ {
+    "bvh",
+    "prim",
+    "radius",
+    }, /* outputs: */ {
+    "prim",
+    }, /* params: */ {
+    {"string", "countAttr", "count"},
+    }, /* category: */ {
+    "primitive",
+    }, /* traits: */ {
+    "pure",
+    }});
+
+struct BVHInsideTest : zeno::INode {
+    virtual void apply() override {
+        auto bvh = get_input<BVHObject>("bvh");
+        bvh_need_tris(bvh.get(), "BVHInsideTest");
+        auto beta = get_param<float>("beta");
+        std::vector<vec3f> pos;
+        auto prim = bvh_query_prim(get_input<PrimitiveObject>("prim"), pos);
+        auto &winding = prim->add_attr_uninit<float>(std::get<std::string>(get_param("windingAttr")));
+        auto &inside = prim->add_attr_uninit<int>(std::get<std::string>(get_param("insideAttr")));
+        parallel_for(pos.size(), [&] (size_t i) {
+            winding[i] = bvh->winding(pos[i], beta);
+            inside[i] = winding[i] > 0.5f;
+        }, 256);
+        set_output("prim", std::move(prim));
+    }
+};
+
+ZENDEFNODE(BVHInsideTest,
+    { /* inputs: */ {
+    "bvh",
+    "prim",
+    }, /* outputs: */ {
+    "prim",
+    }, /* params: */ {
+    {"string", "windingAttr", "winding"},
+    {"string", "insideAttr", "inside"},
+    {"float", "beta", "2"},
+    }, /* category: */ {
+    "primitive",
+    }, /* traits: */ {
+    "pure",
+    }});
+
+}
@@ -30,6 +30,8 @@ ZENDEFNODE(PrimitiveSimplePoints,
     }, /* params: */ {
     }, /* category: */ {
     "primitive",
+    }, /* traits: */ {
+    "pure",
     }});
 
 
@@ -54,6 +56,8 @@ ZENDEFNODE(PrimitiveSimpleLines,
     }, /* params: */ {
     }, /* category: */ {
     "primitive",
+    }, /* traits: */ {
+    "pure",
     }});
 
 
@@ -78,6 +82,8 @@ ZENDEFNODE(PrimitiveSimpleTris,
     }, /* params: */ {
     }, /* category: */ {
     "primitive",
+    }, /* traits: */ {
+    "pure",
     }});
 
 
@@ -102,6 +108,8 @@ ZENDEFNODE(PrimitiveSimpleQuads,
     }, /* params: */ {
     }, /* category: */ {
     "primitive",
+    }, /* traits: */ {
+    "pure",
     }});
 
 
@@ -125,6 +133,8 @@ ZENDEFNODE(PrimitiveClearConnect,
     }, /* params: */ {
     }, /* category: */ {
     "primitive",
+    }, /* traits: */ {
+    "pure",
     }});
 
 }
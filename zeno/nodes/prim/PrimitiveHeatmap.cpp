@@ -2,6 +2,7 @@
 #include <zeno/types/PrimitiveObject.h>
 #include <zeno/types/StringObject.h>
 #include <zeno/types/NumericObject.h>
+#include <zeno/utils/parallel.h>
 #include <sstream>
 
 namespace zeno {
@@ -67,6 +68,8 @@ ZENDEFNODE(MakeHeatmap,
         //{"string", "_RAMPS", "0 0 0.8 0.8 0.8 1"},
         }, /* category: */ {
         "visualize",
+        }, /* traits: */ {
+        "pure",
         }});
 
 
@@ -83,11 +86,11 @@ struct PrimitiveColorByHeatmap : zeno::INode {
             minv = get_input<NumericObject>("min")->get<float>();
         auto &clr = prim->add_attr<zeno::vec3f>("clr");
         auto &src = prim->attr<float>(attrName);
-        #pragma omp parallel for //ideally this could be done in opengl
-        for (int i = 0; i < src.size(); i++) {
+        //ideally this could be done in opengl
+        parallel_for(src.size(), [&] (size_t i) {
             src[i] = (src[i]-minv)/(maxv-minv);
             clr[i] = heatmap->interp(src[i]);
-        }
+        });
 
         set_output("prim", std::move(prim));
     }
@@ -102,6 +105,8 @@ ZENDEFNODE(PrimitiveColorByHeatmap,
         {"string", "attrName", "rho"},
         }, /* category: */ {
         "visualize",
+        }, /* traits: */ {
+        "pure",
         }});
 
 }
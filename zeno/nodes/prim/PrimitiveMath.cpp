@@ -14,7 +14,7 @@ struct PlaneProjectPrimitive2DAABB : INode {
         auto prim = get_input<PrimitiveObject>("prim");
 
         vec2f bmin(+1e6), bmax(-1e6);
-        auto &pos = prim->attr<vec3f>("pos");
+        auto const &pos = prim->read_attr<vec3f>("pos");
         for (int i = 0; i < prim->lines.size(); i++) {
             auto line = prim->lines[i];
             auto p = pos[line[0]], q = pos[line[1]];
@@ -40,4 +40,5 @@ ZENDEFNODE(PlaneProjectPrimitive2DAABB, {
     {"boundMin2D", "boundMax2D"},
     {},
     {"math"},
+    {"pure"},
 });
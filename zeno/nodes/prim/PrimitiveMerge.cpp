@@ -2,7 +2,9 @@
 #include <zeno/types/PrimitiveObject.h>
 #include <zeno/types/ListObject.h>
 #include <zeno/utils/vec.h>
+#include <algorithm>
 #include <cstring>
+#include <map>
 #include <cstdlib>
 #include <cassert>
 
@@ -14,19 +16,47 @@ struct PrimitiveMerge : zeno::INode {
     auto list = get_input<ListObject>("listPrim");
     auto outprim = std::make_shared<PrimitiveObject>();
 
-    size_t len = 0;
+    std::vector<PrimitiveObject *> prims;
+    size_t total = 0;
     for (auto const &obj: list->arr) {
         auto prim = dynamic_cast<PrimitiveObject *>(obj.get());
         assert(prim);
-        for (auto const &[key, varr]: prim->m_attrs) {
+        prims.push_back(prim);
+        total += prim->size();
+    }
+    // sized once and each element written once, ranges of primitives
+    // lacking an attribute are zeroed
+    outprim->resize(total);
+    std::map<std::string, std::vector<bool>> filled;
+    size_t len = 0;
+    for (size_t i = 0; i < prims.size(); i++) {
+        for (auto const &[key, varr]: prims[i]->m_attrs) {
             std::visit([&, key_ = key](auto const &arr) {
                 using T = std::decay_t<decltype(arr[0])>;
-                auto &outarr = outprim->add_attr<T>(key_);
-                for (auto const &val: arr) {
-                    outarr.push_back(val);
-                }
-            }, varr);
+                auto &outarr = outprim->add_attr_uninit<T>(key_);
+                std::copy(arr.begin(), arr.end(), outarr.begin() + len);
+                auto &mask = filled[key_];
+                mask.resize(prims.size());
+                mask[i] = true;
+            }, varr.read());
         }
+        len += prims[i]->size();
+    }
+    for (auto const &[key, mask]: filled) {
+        std::visit([&](auto &outarr) {
+            size_t base = 0;
+            for (size_t i = 0; i < prims.size(); i++) {
+                if (!mask[i])
+                    std::fill(outarr.begin() + base,
+                        outarr.begin() + base + prims[i]->size(),
+                        std::decay_t<decltype(outarr[0])>{});
+                base += prims[i]->size();
+            }
+        }, outprim->attr(key));
+    }
+
+    len = 0;
+    for (auto prim: prims) {
         for (auto const &idx: prim->points) {
             outprim->points.push_back(idx + len);
         }
@@ -41,7 +71,6 @@ struct PrimitiveMerge : zeno::INode {
         }
         len += prim->size();
     }
-    outprim->resize(len);
 
     set_output("prim", std::move(outprim));
   }
@@ -52,6 +81,7 @@ ZENDEFNODE(PrimitiveMerge, {
     {"prim"},
     {},
     {"primitive"},
+    {"pure"},
 });
 
 
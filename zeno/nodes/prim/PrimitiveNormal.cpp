@@ -14,7 +14,7 @@ struct PrimitiveCalcNormal : zeno::INode {
     auto prim = get_input<PrimitiveObject>("prim");
 
     auto &nrm = prim->add_attr<zeno::vec3f>("nrm");
-    auto &pos = prim->attr<zeno::vec3f>("pos");
+    auto const &pos = prim->read_attr<zeno::vec3f>("pos");
     for (size_t i = 0; i < nrm.size(); i++) {
         nrm[i] = zeno::vec3f(0);
     }
@@ -39,6 +39,7 @@ ZENDEFNODE(PrimitiveCalcNormal, {
     {"prim"},
     {},
     {"primitive"},
+    {"pure"},
 });
 
 struct PrimitiveSplitEdges : zeno::INode {
@@ -55,7 +56,7 @@ struct PrimitiveSplitEdges : zeno::INode {
                 arr[i * 3 + 1] = oldarr[ind[1]];
                 arr[i * 3 + 2] = oldarr[ind[2]];
             }
-        }, arr);
+        }, arr.write());
     }
     prim->resize(prim->tris.size() * 3);
 
@@ -72,6 +73,7 @@ ZENDEFNODE(PrimitiveSplitEdges, {
     {"prim"},
     {},
     {"primitive"},
+    {"pure"},
 });
 
 
@@ -111,6 +113,8 @@ ZENDEFNODE(PrimitiveFaceToEdges,
     {"int", "clearFaces", "1"},
     }, /* category: */ {
     "primitive",
+    }, /* traits: */ {
+    "pure",
     }});
 
 }
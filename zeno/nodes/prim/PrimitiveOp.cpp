@@ -2,6 +2,7 @@
 #include <zeno/types/PrimitiveObject.h>
 #include <zeno/types/NumericObject.h>
 #include <zeno/utils/vec.h>
+#include <zeno/utils/parallel.h>
 #include <cstring>
 #include <cstdlib>
 #include <cassert>
@@ -25,11 +26,10 @@ struct UnaryOperator {
     template <class TOut, class TA>
     void operator()(std::vector<TOut> &arrOut, std::vector<TA> const &arrA) {
         size_t n = std::min(arrOut.size(), arrA.size());
-        #pragma omp parallel for
-        for (int i = 0; i < n; i++) {
+        parallel_for(n, [&] (size_t i) {
             auto val = func(arrA[i]);
-            arrOut[i] = (decltype(arrOut[0]))val;
-        }
+            arrOut[i] = attr_cast<TOut>(val);
+        });
     }
 };
 
@@ -40,7 +40,7 @@ struct PrimitiveUnaryOp : zeno::INode {
     auto attrA = std::get<std::string>(get_param("attrA"));
     auto attrOut = std::get<std::string>(get_param("attrOut"));
     auto op = std::get<std::string>(get_param("op"));
-    auto const &arrA = primA->attr(attrA);
+    auto const &arrA = primA->read_attr(attrA);
     auto &arrOut = primOut->attr(attrOut);
     std::visit([op](auto &arrOut, auto const &arrA) {
         if constexpr (zeno::is_vec_castable_v<decltype(arrOut[0]), decltype(arrA[0])>) {
@@ -85,6 +85,8 @@ ZENDEFNODE(PrimitiveUnaryOp,
     {"string", "op", "copy"},
     }, /* category: */ {
     "primitive",
+    }, /* traits: */ {
+    "pure",
     }});
 
 
@@ -97,11 +99,10 @@ struct BinaryOperator {
     void operator()(std::vector<TOut> &arrOut,
         std::vector<TA> const &arrA, std::vector<TB> const &arrB) {
         size_t n = std::min(arrOut.size(), std::min(arrA.size(), arrB.size()));
-        #pragma omp parallel for
-        for (int i = 0; i < n; i++) {
+        parallel_for(n, [&] (size_t i) {
             auto val = func(arrA[i], arrB[i]);
-            arrOut[i] = (decltype(arrOut[0]))val;
-        }
+            arrOut[i] = attr_cast<TOut>(val);
+        });
     }
 };
 
@@ -114,8 +115,8 @@ struct PrimitiveBinaryOp : zeno::INode {
     auto attrB = std::get<std::string>(get_param("attrB"));
     auto attrOut = std::get<std::string>(get_param("attrOut"));
     auto op = std::get<std::string>(get_param("op"));
-    auto const &arrA = primA->attr(attrA);
-    auto const &arrB = primB->attr(attrB);
+    auto const &arrA = primA->read_attr(attrA);
+    auto const &arrB = primB->read_attr(attrB);
     auto &arrOut = primOut->attr(attrOut);
     std::visit([op](auto &arrOut, auto const &arrA, auto const &arrB) {
         if constexpr (is_decay_same_v<decltype(arrOut[0]),
@@ -169,6 +170,8 @@ ZENDEFNODE(PrimitiveBinaryOp,
     {"string", "op", "copyA"},
     }, /* category: */ {
     "primitive",
+    }, /* traits: */ {
+    "pure",
     }});
 
 
@@ -180,17 +183,16 @@ struct PrimitiveMix : zeno::INode {
         auto attrA = std::get<std::string>(get_param("attrA"));
         auto attrB = std::get<std::string>(get_param("attrB"));
         auto attrOut = std::get<std::string>(get_param("attrOut"));
-        auto const &arrA = primA->attr(attrA);
-        auto const &arrB = primB->attr(attrB);
+        auto const &arrA = primA->read_attr(attrA);
+        auto const &arrB = primB->read_attr(attrB);
         auto &arrOut = primOut->attr(attrOut);
         auto coef = get_input<zeno::NumericObject>("coef")->get<float>();
         
         std::visit([coef](auto &arrA, auto &arrB, auto &arrOut) {
           if constexpr (std::is_same_v<decltype(arrA), decltype(arrB)> && std::is_same_v<decltype(arrA), decltype(arrOut)>) {
-#pragma omp parallel for
-            for (int i = 0; i < arrOut.size(); i++) {
+            parallel_for(arrOut.size(), [&] (size_t i) {
                 arrOut[i] = (1.0-coef)*arrA[i] + coef*arrB[i];
-            }
+            });
           }
         }, arrA, arrB, arrOut);
         set_output("primOut", get_input("primOut"));
@@ -210,6 +212,8 @@ ZENDEFNODE(PrimitiveMix,
     {"string", "attrOut", "pos"},
     }, /* category: */ {
     "primitive",
+    }, /* traits: */ {
+    "pure",
     }});
 
 
@@ -222,11 +226,10 @@ struct HalfBinaryOperator {
     void operator()(std::vector<TOut> &arrOut,
         std::vector<TA> const &arrA, TB const &valB) {
         size_t n = std::min(arrOut.size(), arrA.size());
-        #pragma omp parallel for
-        for (int i = 0; i < n; i++) {
+        parallel_for(n, [&] (size_t i) {
             auto val = func(arrA[i], valB);
-            arrOut[i] = (decltype(arrOut[0]))val;
-        }
+            arrOut[i] = attr_cast<TOut>(val);
+        });
     }
 };
 
@@ -237,7 +240,7 @@ struct PrimitiveHalfBinaryOp : zeno::INode {
     auto attrA = std::get<std::string>(get_param("attrA"));
     auto attrOut = std::get<std::string>(get_param("attrOut"));
     auto op = std::get<std::string>(get_param("op"));
-    auto const &arrA = primA->attr(attrA);
+    auto const &arrA = primA->read_attr(attrA);
     auto &arrOut = primOut->attr(attrOut);
     auto const &valB = get_input<NumericObject>("valueB")->value;
     std::visit([op](auto &arrOut, auto const &arrA, auto const &valB) {
@@ -291,6 +294,8 @@ ZENDEFNODE(PrimitiveHalfBinaryOp,
     {"string", "op", "copyA"},
     }, /* category: */ {
     "primitive",
+    }, /* traits: */ {
+    "pure",
     }});
 struct PrimitiveFillAttr : zeno::INode {
   virtual void apply() override {
@@ -299,11 +304,12 @@ struct PrimitiveFillAttr : zeno::INode {
     auto attrName = std::get<std::string>(get_param("attrName"));
     auto &arr = prim->attr(attrName);
     std::visit([](auto &arr, auto const &value) {
-        if constexpr (zeno::is_vec_castable_v<decltype(arr[0]), decltype(value)>) {
-            #pragma omp parallel for
-            for (int i = 0; i < arr.size(); i++) {
-                arr[i] = decltype(arr[i])(value);
-            }
+        using T = std::decay_t<decltype(arr[0])>;
+        if constexpr (zeno::is_vec_castable_v<T, decltype(value)>
+                || (is_quantized_v<T> && !is_vec_v<decltype(value)>)) {
+            parallel_for(arr.size(), [&] (size_t i) {
+                arr[i] = attr_cast<T>(value);
+            });
         } else {
             assert(0 && "Failed to promote variant type");
         }
@@ -323,6 +329,8 @@ ZENDEFNODE(PrimitiveFillAttr,
     {"string", "attrName", "pos"},
     }, /* category: */ {
     "primitive",
+    }, /* traits: */ {
+    "pure",
     }});
 
 
@@ -338,14 +346,15 @@ struct PrimitiveRandomizeAttr : zeno::INode {
     auto attrName = std::get<std::string>(get_param("attrName"));
     auto &arr = prim->attr(attrName);
     std::visit([min, minY, minZ, max, maxY, maxZ](auto &arr) {
+        using T = std::decay_t<decltype(arr[0])>;
         for (int i = 0; i < arr.size(); i++) {
-            if constexpr (is_decay_same_v<decltype(arr[i]), zeno::vec3f>) {
+            if constexpr (is_vec_v<T>) {
                 zeno::vec3f f(drand48(), drand48(), drand48());
                 zeno::vec3f a(min, minY, minZ);
                 zeno::vec3f b(max, maxY, maxZ);
-                arr[i] = zeno::mix(a, b, f);
+                arr[i] = attr_cast<T>(zeno::mix(a, b, f));
             } else {
-                arr[i] = zeno::mix(min, max, (float)drand48());
+                arr[i] = attr_cast<T>(zeno::mix(min, max, (float)drand48()));
             }
         }
     }, arr);
@@ -372,12 +381,18 @@ ZENDEFNODE(PrimitiveRandomizeAttr,
     }});
 
 
-void print_cout(float x) {
-    printf("%f\n", x);
-}
-
-void print_cout(zeno::vec3f const &a) {
-    printf("%f %f %f\n", a[0], a[1], a[2]);
+template <class T>
+void print_cout(T const &a) {
+    if constexpr (is_vec_v<T>) {
+        for (size_t k = 0; k < is_vec_n<T>; k++) {
+            if (k) printf(" ");
+            print_cout(a[k]);
+        }
+    } else if constexpr (std::is_integral_v<T>) {
+        printf("%d", (int)a);
+    } else {
+        printf("%f", (float)a);
+    }
 }
 
 
@@ -389,12 +404,13 @@ struct PrimitivePrintAttr : zeno::INode {
         printf("attribute `%s`, length %zd:\n", attrName.c_str(), arr.size());
         for (int i = 0; i < arr.size(); i++) {
             print_cout(arr[i]);
+            printf("\n");
         }
         if (arr.size() == 0) {
             printf("(no data)\n");
         }
         printf("\n");
-    }, prim->attr(attrName));
+    }, prim->read_attr(attrName));
 
     set_output("prim", get_input("prim"));
   }
@@ -1,63 +1,60 @@
 #include <zeno/zeno.h>
 #include <zeno/types/PrimitiveObject.h>
 #include <zeno/types/NumericObject.h>
+#include <zeno/utils/reduction.h>
 #include <zeno/utils/vec.h>
 #include <cstring>
 #include <cstdlib>
 #include <cassert>
-//#include <tbb/parallel_for.h>
-//#include <tbb/parallel_reduce.h>
 
 namespace zeno {
 
-template <class T>
-static T prim_reduce(PrimitiveObject *prim, std::string channel, std::string type)
-{
-    std::vector<T> const &temp = prim->attr<T>(channel);
-    
-    if(type==std::string("avg")){
-		T total = temp[0];
-		for (int i = 1; i < temp.size(); i++) {
-			total += temp[i];
-		}
-        return total/(T)(temp.size());
+// c-th component of each result to a numeric, of S for vectors
+template <class S, size_t N, class F>
+static NumericValue stats_numeric(F const &f) {
+    if constexpr (N == 1) {
+        return S(f(0));
+    } else {
+        vec<N, S> res;
+        for (size_t c = 0; c < N; c++)
+            res[c] = S(f(c));
+        return res;
     }
-    if(type==std::string("max")){
-		T total = temp[0];
-		for (int i = 1; i < temp.size(); i++) {
-			total = zeno::max(total, temp[i]);
-		}
-        return total;   
-    }
-    if(type==std::string("min")){
-		T total = temp[0];
-		for (int i = 1; i < temp.size(); i++) {
-			total = zeno::min(total, temp[i]);
-		}
-        return total;
-    }
-    if(type==std::string("absmax"))
-    {
-        T total=zeno::abs(temp[0]);
-		for (int i = 1; i < temp.size(); i++) {
-			total = zeno::max(total, zeno::abs(temp[i]));
-		}
-        return total;
-    }
-    return T(0);
 }
 
+// min and max stay integers for integer attributes, others are floats
+template <class S0, size_t N>
+static NumericValue stats_reduce(ArrayStats<S0, N> const &st, std::string const &op) {
+    using S = std::conditional_t<std::is_integral_v<S0>, int, float>;
+    if (op == "avg" || op == "mean")
+        return stats_numeric<float, N>([&] (size_t c) { return st.mean(c); });
+    if (op == "sum")
+        return stats_numeric<float, N>([&] (size_t c) { return st.sum[c]; });
+    if (op == "variance")
+        return stats_numeric<float, N>([&] (size_t c) { return st.variance(c); });
+    if (op == "min")
+        return stats_numeric<S, N>([&] (size_t c) { return st.min[c]; });
+    if (op == "max")
+        return stats_numeric<S, N>([&] (size_t c) { return st.max[c]; });
+    if (op == "absmax")
+        return stats_numeric<S, N>([&] (size_t c) {
+            return st.count ? std::max(std::abs(st.min[c]), std::abs(st.max[c])) : S0(0);
+        });
+    if (op == "argmin")
+        return stats_numeric<int, N>([&] (size_t c) { return st.argmin[c]; });
+    if (op == "argmax")
+        return stats_numeric<int, N>([&] (size_t c) { return st.argmax[c]; });
+    throw zeno::Exception("bad reduction op `" + op + "`");
+}
 
 struct PrimitiveReduction : zeno::INode {
     virtual void apply() override{
         auto prim = get_input<PrimitiveObject>("prim");
         auto attrToReduce = std::get<std::string>(get_param("attr"));
         auto op = std::get<std::string>(get_param("op"));
-        zeno::NumericValue result;
-        if (prim->attr_is<zeno::vec3f>(attrToReduce))
-            result = prim_reduce<zeno::vec3f>(prim.get(), attrToReduce, op);
-        else 
-            result = prim_reduce<float>(prim.get(), attrToReduce, op);
+        auto result = std::visit([&] (auto const &arr) {
+            return stats_reduce(array_stats(arr), op);
+        }, prim->read_attr(attrToReduce));
         auto out = std::make_shared<zeno::NumericObject>();
         out->set(result);
         set_output("result", std::move(out));
@@ -73,6 +70,111 @@ ZENDEFNODE(PrimitiveReduction,
     {"string", "op", "avg"},
     }, /* category: */ {
     "primitive",
+    }, /* traits: */ {
+    "pure",
+    }});
+
+// all reductions of PrimitiveReduction from a single pass, and a histogram
+// of histBins bins if not 0, over [histMin, histMax] if given, else the
+// attribute's range, from 0 to the farthest bounding box corner for vectors
+struct PrimitiveStatistics : zeno::INode {
+    virtual void apply() override {
+        auto prim = get_input<PrimitiveObject>("prim");
+        auto attr = std::get<std::string>(get_param("attr"));
+        int nbins = std::max(0, get_param<int>("histBins"));
+        bool ranged = has_input("histMin") && has_input("histMax");
+        ArrayHistogram hist;
+        hist.counts.resize(nbins);
+        if (ranged) {
+            hist.lo = get_input<NumericObject>("histMin")->get<float>();
+            hist.hi = get_input<NumericObject>("histMax")->get<float>();
+        }
+        std::visit([&] (auto const &arr) {
+            auto st = array_stats(arr, ranged ? &hist : nullptr);
+            for (auto op: {"sum", "mean", "variance", "min", "max", "argmin", "argmax"}) {
+                auto out = std::make_shared<NumericObject>();
+                out->set(stats_reduce(st, op));
+                set_output(op, std::move(out));
+            }
+            if (!ranged && nbins) {
+                using T = std::decay_t<decltype(arr[0])>;
+                if constexpr (is_vec_v<T>) {
+                    float r2 = 0;
+                    for (size_t c = 0; c < is_vec_n<T>; c++) {
+                        float r = std::max(std::abs((float)st.min[c]), std::abs((float)st.max[c]));
+                        r2 += r * r;
+                    }
+                    hist.lo = 0;
+                    hist.hi = std::sqrt(r2);
+                } else {
+                    hist.lo = (float)st.min[0];
+                    hist.hi = (float)st.max[0];
+                }
+                array_histogram(arr, hist);
+            }
+        }, prim->read_attr(attr));
+
+        // bins as points along x at their centers
+        auto histPrim = std::make_shared<PrimitiveObject>();
+        histPrim->resize(nbins);
+        auto &pos = histPrim->add_attr<vec3f>("pos");
+        auto &count = histPrim->add_attr<int>("count");
+        for (int k = 0; k < nbins; k++) {
+            pos[k][0] = hist.lo + (hist.hi - hist.lo) * (k + 0.5f) / nbins;
+            count[k] = (int)hist.counts[k];
+        }
+        set_output("histogram", std::move(histPrim));
+    }
+};
+ZENDEFNODE(PrimitiveStatistics,
+    { /* inputs: */ {
+    "prim",
+    "histMin",
+    "histMax",
+    }, /* outputs: */ {
+    "sum",
+    "mean",
+    "variance",
+    "min",
+    "max",
+    "argmin",
+    "argmax",
+    "histogram",
+    }, /* params: */ {
+    {"string", "attr", "pos"},
+    {"int", "histBins", "0"},
+    }, /* category: */ {
+    "primitive",
+    }, /* traits: */ {
+    "pure",
+    }});
+
+struct PrimitiveBoundingBox : zeno::INode {
+    virtual void apply() override {
+        auto prim = get_input<PrimitiveObject>("prim");
+        auto attr = std::get<std::string>(get_param("attr"));
+        std::visit([&] (auto const &arr) {
+            auto st = array_stats(arr);
+            for (auto [key, op]: {std::pair{"bmin", "min"}, std::pair{"bmax", "max"}}) {
+                auto out = std::make_shared<NumericObject>();
+                out->set(stats_reduce(st, op));
+                set_output(key, std::move(out));
+            }
+        }, prim->read_attr(attr));
+    }
+};
+ZENDEFNODE(PrimitiveBoundingBox,
+    { /* inputs: */ {
+    "prim",
+    }, /* outputs: */ {
+    "bmin",
+    "bmax",
+    }, /* params: */ {
+    {"string", "attr", "pos"},
+    }, /* category: */ {
+    "primitive",
+    }, /* traits: */ {
+    "pure",
     }});
 
 }
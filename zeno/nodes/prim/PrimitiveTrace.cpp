@@ -2,6 +2,7 @@
 #include <zeno/types/PrimitiveObject.h>
 #include <zeno/types/NumericObject.h>
 #include <zeno/utils/vec.h>
+#include <zeno/extra/ObjectCodec.h>
 #include <cstring>
 #include <cstdlib>
 #include <cassert>
@@ -26,7 +27,7 @@ struct PrimitiveTraceTrail : zeno::INode {
                 for (int i = 0; i < parsPrim->size(); i++) {
                     trailArr[base + i] = parsArr[i];
                 }
-            }, parsArr);
+            }, parsArr.read());
         }
         if (last_base > 0) {
             for (int i = 0; i < parsPrim->size(); i++) {
@@ -36,6 +37,15 @@ struct PrimitiveTraceTrail : zeno::INode {
 
         set_output("trailPrim", trailPrim);
     }
+
+    virtual bool saveState(ObjectSink &out) const override {
+        return INode::saveState(out) && encodeObject(out, trailPrim.get());
+    }
+
+    virtual void loadState(ObjectReader &in) override {
+        INode::loadState(in);
+        trailPrim = safe_dynamic_cast<PrimitiveObject>(decodeObject(in));
+    }
 };
 
 ZENDEFNODE(PrimitiveTraceTrail,
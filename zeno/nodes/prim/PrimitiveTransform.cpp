@@ -1,6 +1,7 @@
 #include <zeno/zeno.h>
 #include <zeno/types/PrimitiveObject.h>
 #include <zeno/types/NumericObject.h>
+#include <zeno/utils/parallel.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/transform.hpp>
@@ -47,26 +48,25 @@ struct TransformPrimitive : zeno::INode {
         auto matrix = matTrans*matRotz*matRoty*matRotx*matQuat*matScal;
 
         auto prim = get_input<PrimitiveObject>("prim");
+        // attributes are shared with prim until written, only pos/nrm copied
         auto outprim = std::make_unique<PrimitiveObject>(*prim);
 
         if (prim->has_attr("pos")) {
             auto &pos = outprim->attr<zeno::vec3f>("pos");
-            //#pragma omp parallel for
-            for (int i = 0; i < pos.size(); i++) {
+            parallel_for(pos.size(), [&] (size_t i) {
                 auto p = zeno::vec_to_other<glm::vec3>(pos[i]);
                 p = mapplypos(matrix, p);
                 pos[i] = zeno::other_to_vec<3>(p);
-            }
+            });
         }
 
         if (prim->has_attr("nrm")) {
             auto &nrm = outprim->attr<zeno::vec3f>("nrm");
-            //#pragma omp parallel for
-            for (int i = 0; i < nrm.size(); i++) {
+            parallel_for(nrm.size(), [&] (size_t i) {
                 auto n = zeno::vec_to_other<glm::vec3>(nrm[i]);
                 n = mapplynrm(matrix, n);
                 nrm[i] = zeno::other_to_vec<3>(n);
-            }
+            });
         }
         set_output("outPrim", std::move(outprim));
     }
@@ -77,6 +77,7 @@ ZENDEFNODE(TransformPrimitive, {
     {"outPrim"},
     {},
     {"primitive"},
+    {"pure"},
 });
 
 
@@ -59,6 +59,8 @@ ZENDEFNODE(PrimitiveShade,
     {"string", "fragpath", "assets/particles.frag"},
     }, /* category: */ {
     "visualize",
+    }, /* traits: */ {
+    "pure",
     }});
 
 }
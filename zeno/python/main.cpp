@@ -2,8 +2,12 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <zeno/zeno.h>
+#include <zeno/extra/Profiler.h>
+#include <zeno/extra/MemoryReport.h>
+#include <zeno/extra/Plugins.h>
 #ifdef ZENO_GLOBALSTATE
 #include <zeno/extra/GlobalState.h>
+#include <zeno/extra/Checkpoint.h>
 #endif
 #ifdef ZENO_VISUALIZATION
 #include <zeno/extra/Visualization.h>
@@ -14,8 +18,10 @@ namespace py = pybind11;
 PYBIND11_MODULE(zeno_pybind11_module, m) {
     m.def("dumpDescriptors", zeno::dumpDescriptors);
     m.def("bindNodeInput", zeno::bindNodeInput);
+    m.def("unbindNodeInput", zeno::unbindNodeInput);
     m.def("setNodeParam", zeno::setNodeParam);
     m.def("setNodeOption", zeno::setNodeOption);
+    m.def("unsetNodeOption", zeno::unsetNodeOption);
     m.def("clearAllState", zeno::clearAllState);
     m.def("completeNode", zeno::completeNode);
     m.def("switchGraph", zeno::switchGraph);
@@ -23,6 +29,46 @@ PYBIND11_MODULE(zeno_pybind11_module, m) {
     m.def("applyNodes", zeno::applyNodes);
     m.def("loadScene", zeno::loadScene);
     m.def("addNode", zeno::addNode);
+    m.def("removeNode", zeno::removeNode);
+    m.def("loadPluginManifest", zeno::loadPluginManifest);
+    m.def("setParallel", [] (bool parallel) {
+        zeno::getSession().getDefaultScene().isParallel = parallel;
+    });
+    m.def("setIncremental", [] (bool incremental) {
+        zeno::getSession().getDefaultScene().isIncremental = incremental;
+    });
+    m.def("setReleaseOutputs", [] (bool release) {
+        zeno::getSession().getDefaultScene().releaseOutputs = release;
+    });
+    m.def("setProfiling", [] (bool enabled) {
+        zeno::getProfiler().enabled = enabled;
+    });
+    m.def("clearProfile", [] () { zeno::getProfiler().clear(); });
+    m.def("dumpProfile", [] (std::string const &path) {
+        zeno::getProfiler().dumpChromeTrace(path);
+    });
+    m.def("profileSummary", [] (int frameid) {
+        return zeno::getProfiler().summary(frameid);
+    }, py::arg("frameid") = -1);
+    m.def("setMemoryReport", [] (bool enabled) {
+        zeno::getMemoryReport().enabled = enabled;
+    });
+    m.def("clearMemoryReport", [] () { zeno::getMemoryReport().clear(); });
+    m.def("memoryReport", [] (int frameid) {
+        return zeno::getMemoryReport().summary(frameid);
+    }, py::arg("frameid") = -1);
+    m.def("memoryFrames", [] () {
+        py::list res;
+        for (auto const &f: zeno::getMemoryReport().frames()) {
+            py::dict d;
+            d["frameid"] = f.frameid;
+            d["resident"] = f.resident;
+            d["peak"] = f.peak;
+            d["nodes"] = f.nodes;
+            res.append(std::move(d));
+        }
+        return res;
+    });
 
 #ifdef ZENO_GLOBALSTATE
     m.def("setIOPath", [] (std::string const &iopath) {
@@ -38,6 +84,15 @@ PYBIND11_MODULE(zeno_pybind11_module, m) {
 #endif
         return zeno::state.frameEnd();
     });
+    m.def("checkpointFrame", [] () {
+        zeno::checkpointFrame(zeno::getSession().getDefaultScene());
+    });
+    m.def("resumeFrame", [] () {
+        return zeno::resumeFrame(zeno::getSession().getDefaultScene());
+    });
+#ifdef ZENO_VISUALIZATION
+    m.def("flushExports", zeno::Visualization::flushExports);
+#endif
 #endif
 
     py::register_exception_translator([](std::exception_ptr p) {
@@ -0,0 +1,167 @@
+#include <zeno/utils/ThreadPool.h>
+#include <algorithm>
+#include <cstdlib>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace zeno {
+
+static thread_local ThreadPool *t_pool = nullptr;
+static thread_local int t_index = -1;
+static thread_local int t_depth = 0;
+
+ZENO_API ThreadPool::ThreadPool(int nthreads) {
+    if (nthreads < 1)
+        nthreads = 1;
+    for (int i = 0; i < nthreads; i++) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (int i = 0; i < nthreads; i++) {
+        m_threads.emplace_back([this, i] { worker_main(i); });
+    }
+}
+
+ZENO_API ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lck(m_mtx);
+        m_stopped = true;
+    }
+    m_cv.notify_all();
+    for (auto &thr: m_threads) {
+        thr.join();
+    }
+}
+
+ZENO_API void ThreadPool::submit(Task task) {
+    if (t_pool == this) {
+        auto &w = *m_workers[t_index];
+        std::lock_guard lck(w.mtx);
+        w.tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard lck(m_mtx);  // pairs with the wait in worker_main
+        if (t_pool != this)
+            m_injected.push_back(std::move(task));
+        m_pending.fetch_add(1, std::memory_order_release);
+    }
+    m_cv.notify_one();
+}
+
+bool ThreadPool::pop_task(int self, Task &task) {
+    if (self >= 0) {
+        auto &w = *m_workers[self];
+        std::lock_guard lck(w.mtx);
+        if (!w.tasks.empty()) {
+            task = std::move(w.tasks.back());
+            w.tasks.pop_back();
+            return true;
+        }
+    }
+    {
+        std::lock_guard lck(m_mtx);
+        if (!m_injected.empty()) {
+            task = std::move(m_injected.front());
+            m_injected.pop_front();
+            return true;
+        }
+    }
+    int n = m_workers.size();
+    for (int k = 1; k <= n; k++) {
+        int victim = ((self < 0 ? 0 : self) + k) % n;
+        if (victim == self)
+            continue;
+        auto &w = *m_workers[victim];
+        std::lock_guard lck(w.mtx);
+        if (!w.tasks.empty()) {
+            task = std::move(w.tasks.front());
+            w.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+ZENO_API bool ThreadPool::run_one() {
+    Task task;
+    if (!pop_task(t_pool == this ? t_index : -1, task))
+        return false;
+    m_pending.fetch_sub(1, std::memory_order_acq_rel);
+    struct Nested {
+        Nested() { t_depth++; }
+        ~Nested() { t_depth--; }
+    } nested;
+    task();
+    return true;
+}
+
+ZENO_API void ThreadPool::help_until_done(std::atomic<int> const &running) {
+    while (running.load(std::memory_order_acquire)) {
+        if (run_one())
+            continue;
+        // the group's last tasks are held by other threads: sleep until
+        // they are done, or new tasks (maybe theirs) come to help with
+        std::unique_lock lck(m_mtx);
+        m_cv.wait(lck, [&] {
+            return m_stopped || !running.load(std::memory_order_acquire)
+                || m_pending.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+ZENO_API void ThreadPool::notify_done() {
+    {
+        std::lock_guard lck(m_mtx);  // pairs with the wait in help_until_done
+    }
+    m_cv.notify_all();
+}
+
+// for the OpenMP loops left in extensions, called on each thread that may
+// start them; nested regions would multiply the budget so they run serial,
+// concurrent ones (nodes applied side by side) are trimmed by the runtime
+static void limit_openmp() {
+#ifdef _OPENMP
+    omp_set_num_threads(getThreadBudget());
+    omp_set_max_active_levels(1);
+    omp_set_dynamic(1);
+#endif
+}
+
+void ThreadPool::worker_main(int self) {
+    t_pool = this;
+    t_index = self;
+    limit_openmp();
+    while (true) {
+        if (run_one())
+            continue;
+        std::unique_lock lck(m_mtx);
+        m_cv.wait(lck, [this] {
+            return m_stopped || m_pending.load(std::memory_order_acquire) > 0;
+        });
+        if (m_stopped)
+            break;
+    }
+}
+
+ZENO_API int getThreadBudget() {
+    static int budget = [] {
+        if (auto env = getenv("ZEN_NUM_THREADS"); env && atoi(env) > 0)
+            return atoi(env);
+        return std::max(1, (int)std::thread::hardware_concurrency());
+    }();
+    return budget;
+}
+
+ZENO_API int getTaskDepth() {
+    return t_depth;
+}
+
+ZENO_API ThreadPool &getThreadPool() {
+    // threads waiting on a TaskGroup run tasks too, so one less worker
+    static ThreadPool pool(getThreadBudget() - 1);
+    static bool limited = (limit_openmp(), true);
+    (void)limited;
+    return pool;
+}
+
+}
@@ -0,0 +1,246 @@
+#include <zeno/utils/zlog.h>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <chrono>
+#include <map>
+
+namespace zlog {
+
+namespace {
+
+constexpr size_t kSlots = 4096;
+
+// bounded multi-producer queue: producers claim a position by CAS on head
+// and publish by bumping the slot's sequence, so they never block each
+// other; the one consumer (whoever holds m_drain) reads in order
+struct Slot {
+    std::atomic<size_t> seq;
+    LogLevel level;
+    Module const *mod;
+    std::string msg;  // keeps its capacity across reuse
+};
+
+struct Logger {
+    Slot slots[kSlots];
+    std::atomic<size_t> head{0};
+    size_t tail = 0;
+    std::mutex m_drain;
+    std::string batch;
+    Sink sink;
+
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    std::thread flusher;
+    std::atomic<bool> exiting{false};
+    bool sync = false;
+
+    std::mutex m_mods;
+    std::deque<Module> mods;
+    std::map<std::string, int> overrides;
+    int defl = level_rank(LogLevel::info);
+
+    Logger() {
+        for (size_t i = 0; i < kSlots; i++)
+            slots[i].seq.store(i, std::memory_order_relaxed);
+        sync = getenv("ZEN_LOG_SYNC");
+        if (auto env = getenv("ZEN_LOG"))
+            parse(env);
+        if (!sync)
+            flusher = std::thread([this] { flusher_main(); });
+        // never destroyed, static destructors may still log; whatever is
+        // left is flushed at exit and written directly after that
+        atexit([] {
+            auto &self = instance();
+            {
+                std::lock_guard lck(self.m_mtx);
+                self.exiting = true;
+            }
+            self.m_cv.notify_all();
+            if (self.flusher.joinable())
+                self.flusher.join();
+            self.drain();
+        });
+    }
+
+    static Logger &instance() {
+        static Logger *logger = new Logger;
+        return *logger;
+    }
+
+    static int parse_level(std::string const &name) {
+        static const char *names[] = {"trace", "debug", "info",
+            "critical", "warning", "error", "fatal"};
+        for (int rank = 0; rank < 7; rank++)
+            if (name == names[rank])
+                return rank;
+        return -1;
+    }
+
+    void parse(std::string const &spec) {
+        size_t p = 0;
+        while (p <= spec.size()) {
+            auto q = std::min(spec.find(',', p), spec.size());
+            auto item = spec.substr(p, q - p);
+            p = q + 1;
+            auto eq = item.find('=');
+            if (eq == std::string::npos) {
+                if (auto rank = parse_level(item); rank >= 0)
+                    defl = rank;
+            } else if (auto rank = parse_level(item.substr(eq + 1)); rank >= 0) {
+                overrides[item.substr(0, eq)] = rank;
+            }
+        }
+    }
+
+    void push(Module const &mod, LogLevel level, std::string &&msg) {
+        if (sync) {
+            std::lock_guard lck(m_drain);
+            write(mod, level, msg);
+            flush_batch();
+            return;
+        }
+        size_t pos = head.load(std::memory_order_relaxed);
+        Slot *slot;
+        while (true) {
+            slot = &slots[pos % kSlots];
+            auto seq = slot->seq.load(std::memory_order_acquire);
+            auto diff = (std::ptrdiff_t)seq - (std::ptrdiff_t)pos;
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1,
+                            std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {  // full, wait for the flusher
+                m_cv.notify_one();
+                std::this_thread::yield();
+                pos = head.load(std::memory_order_relaxed);
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+        slot->level = level;
+        slot->mod = &mod;
+        slot->msg.assign(msg);
+        slot->seq.store(pos + 1, std::memory_order_release);
+
+        if (level_rank(level) >= level_rank(LogLevel::error)
+                || exiting.load(std::memory_order_relaxed))
+            drain();
+        else if (pos % (kSlots / 4) == 0)
+            m_cv.notify_one();
+    }
+
+    void write(Module const &mod, LogLevel level, std::string const &msg) {
+        if (sink) {
+            sink(level, mod.name, msg);
+            return;
+        }
+        bool tagged = strcmp(mod.name, "zeno");
+#if ZLOG_USE_ANDROID
+        if (tagged)
+            log_print(level, ("[" + std::string(mod.name) + "] " + msg).c_str());
+        else
+            log_print(level, msg.c_str());
+#else
+        batch += "zlog/";
+        batch += (char)level;
+        batch += ": ";
+        if (tagged) {
+            batch += '[';
+            batch += mod.name;
+            batch += "] ";
+        }
+        batch += msg;
+        batch += '\n';
+#endif
+    }
+
+    void flush_batch() {
+        if (batch.empty())
+            return;
+        fwrite(batch.data(), 1, batch.size(), stderr);
+        fflush(stderr);
+        batch.clear();
+    }
+
+    void drain() {
+        std::lock_guard lck(m_drain);
+        while (true) {
+            auto &slot = slots[tail % kSlots];
+            if (slot.seq.load(std::memory_order_acquire) != tail + 1)
+                break;
+            write(*slot.mod, slot.level, slot.msg);
+            slot.seq.store(tail + kSlots, std::memory_order_release);
+            tail++;
+        }
+        flush_batch();
+    }
+
+    void flusher_main() {
+        std::unique_lock lck(m_mtx);
+        while (!exiting) {
+            m_cv.wait_for(lck, std::chrono::milliseconds(50));
+            lck.unlock();
+            drain();
+            lck.lock();
+        }
+    }
+};
+
+}
+
+ZENO_API void push(Module const &mod, LogLevel level, std::string &&msg) {
+    Logger::instance().push(mod, level, std::move(msg));
+}
+
+ZENO_API void flush() {
+    Logger::instance().drain();
+}
+
+ZENO_API std::ostringstream &_impl_stream() {
+    static thread_local std::ostringstream ss;
+    ss.str(std::string());
+    ss.clear();
+    return ss;
+}
+
+ZENO_API void set_sink(Sink sink) {
+    auto &logger = Logger::instance();
+    logger.drain();
+    std::lock_guard lck(logger.m_drain);
+    logger.sink = std::move(sink);
+}
+
+ZENO_API Module &module(const char *name) {
+    auto &logger = Logger::instance();
+    std::lock_guard lck(logger.m_mods);
+    for (auto &mod: logger.mods)
+        if (!strcmp(mod.name, name))
+            return mod;
+    auto &mod = logger.mods.emplace_back();
+    mod.name = strdup(name);
+    auto it = logger.overrides.find(name);
+    mod.threshold.store(it != logger.overrides.end() ? it->second : logger.defl);
+    return mod;
+}
+
+ZENO_API void set_level(LogLevel level, const char *name) {
+    auto &logger = Logger::instance();
+    int rank = level_rank(level);
+    if (name) {
+        module(name).threshold.store(rank);
+        std::lock_guard lck(logger.m_mods);
+        logger.overrides[name] = rank;
+        return;
+    }
+    std::lock_guard lck(logger.m_mods);
+    logger.defl = rank;
+    logger.overrides.clear();
+    for (auto &mod: logger.mods)
+        mod.threshold.store(rank);
+}
+
+}
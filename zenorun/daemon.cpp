@@ -0,0 +1,163 @@
+// long-lived worker for the editor, see zenqt/system/launch.py: node
+// libraries are loaded once, and the scene stays loaded between runs, so
+// that the editor only sends what it changed (serializeSceneDiff)
+//
+// one request per connection, a line of json:
+//   {"cmd": "run", "scene": "<loadScene json>", "nodes": {main graph nodes},
+//    "nframes": 1, "iopath": "..."}  -> FRAME: lines, then EXITING,
+//                                       CANCELLED or ERROR: message
+//   {"cmd": "cancel"}  -> OK, once the current run stopped
+//   {"cmd": "descs"}   -> same as zenorun --dump-descs
+//   {"cmd": "quit"}    -> OK, then the daemon exits
+// the daemon also exits when its stdin is closed, i.e. the editor is gone
+#include "zenorun.h"
+#include <zeno/zeno.h>
+#include <memory>
+#include <thread>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <signal.h>
+#endif
+
+using namespace rapidjson;
+
+#ifndef _WIN32
+
+static std::string readRequest(int fd) {
+    std::string res;
+    char buf[4096];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0) {
+        res.append(buf, n);
+        if (res.back() == '\n')
+            break;
+    }
+    return res;
+}
+
+static void reply(int fd, std::string const &msg) {
+    for (size_t i = 0; i < msg.size();) {
+        auto n = write(fd, msg.data() + i, msg.size() - i);
+        if (n <= 0)
+            break;
+        i += n;
+    }
+    close(fd);
+}
+
+namespace {
+
+struct Daemon {
+    zeno::Scene &scene = zeno::getSession().getDefaultScene();
+    std::thread runner;
+
+    void cancel() {
+        scene.cancelRequested = true;
+        if (runner.joinable())
+            runner.join();
+        scene.cancelRequested = false;
+    }
+
+    void run(int fd, std::shared_ptr<Document> req) {
+        cancel();  // one run at a time, the editor wants the latest one
+        runner = std::thread([fd, req] {
+            auto out = fdopen(fd, "w");
+            try {
+                Document const &doc = *req;
+                zeno::loadScene(doc["scene"].GetString());
+                runLoadedScene(doc["nodes"], doc["nframes"].GetInt(),
+                        doc["iopath"].GetString(), out);
+            } catch (std::exception const &e) {
+                fprintf(out, "ERROR: %s\n", e.what());
+            }
+            fclose(out);
+        });
+    }
+};
+
+}
+
+int runDaemon(const char *sockpath) {
+    signal(SIGPIPE, SIG_IGN);  // editor hung up, see runFrames
+
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (sock < 0 || strlen(sockpath) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "cannot create socket %s\n", sockpath);
+        return 1;
+    }
+    strcpy(addr.sun_path, sockpath);
+    unlink(sockpath);
+    if (bind(sock, (sockaddr *)&addr, sizeof(addr)) < 0 || listen(sock, 8) < 0) {
+        perror(sockpath);
+        return 1;
+    }
+    printf("zeno daemon listening on %s\n", sockpath);
+    fflush(stdout);
+
+    std::thread([sockpath] {
+        char c;
+        while (read(STDIN_FILENO, &c, 1) > 0);
+        unlink(sockpath);
+        _exit(0);
+    }).detach();
+
+    Daemon daemon;
+    while (true) {
+        int fd = accept(sock, nullptr, nullptr);
+        if (fd < 0)
+            continue;
+        auto req = std::make_shared<Document>();
+        auto line = readRequest(fd);
+        req->Parse(line.c_str());
+        if (req->HasParseError() || !req->IsObject() || !req->HasMember("cmd")) {
+            close(fd);  // e.g. the editor checking whether we're up
+            continue;
+        }
+        if (!(*req)["cmd"].IsString()) {
+            reply(fd, "ERROR: malformed request\n");
+            continue;
+        }
+        std::string cmd = (*req)["cmd"].GetString();
+        if (cmd == "run") {
+            auto const &doc = *req;
+            if (!doc.HasMember("scene") || !doc["scene"].IsString()
+                    || !doc.HasMember("nodes") || !doc["nodes"].IsObject()
+                    || !doc.HasMember("nframes") || !doc["nframes"].IsInt()
+                    || !doc.HasMember("iopath") || !doc["iopath"].IsString()) {
+                reply(fd, "ERROR: malformed run request\n");
+                continue;
+            }
+            daemon.run(fd, std::move(req));
+        } else if (cmd == "cancel") {
+            daemon.cancel();
+            reply(fd, "OK\n");
+        } else if (cmd == "descs") {
+            reply(fd, "==<DESCS>==\n" + zeno::dumpDescriptors() + "\n==<DESCS>==\n");
+        } else if (cmd == "quit") {
+            daemon.cancel();
+            reply(fd, "OK\n");
+            break;
+        } else {
+            reply(fd, "ERROR: unknown command " + cmd + "\n");
+        }
+    }
+    close(sock);
+    unlink(sockpath);
+    return 0;
+}
+
+#else
+
+int runDaemon(const char *sockpath) {
+    fprintf(stderr, "zenorun --daemon is not supported on windows yet\n");
+    return 1;
+}
+
+#endif
@@ -0,0 +1,299 @@
+// native replacement for `python -m zenqt.system prog.zsg nframes iopath`,
+// so that running a graph doesn't pay for interpreter startup and the
+// per-param pybind calls of zenqt/system/run.py
+#include "zenorun.h"
+#include <zeno/zeno.h>
+#include <zeno/extra/FrameExpr.h>
+#include <zeno/extra/Plugins.h>
+#ifdef ZENO_GLOBALSTATE
+#include <zeno/extra/GlobalState.h>
+#include <zeno/extra/Checkpoint.h>
+#endif
+#ifdef ZENO_VISUALIZATION
+#include <zeno/extra/Visualization.h>
+#endif
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <tuple>
+#include <map>
+#include <set>
+#ifndef _WIN32
+#include <dlfcn.h>
+#endif
+
+namespace fs = std::filesystem;
+using namespace rapidjson;
+
+static fs::path executableDir(const char *argv0) {
+#ifdef __linux__
+    std::error_code ec;
+    auto path = fs::read_symlink("/proc/self/exe", ec);
+    if (!ec)
+        return path.parent_path();
+#endif
+    return fs::absolute(argv0).parent_path();
+}
+
+// load every extension in libdir, libraries depending on each other may
+// fail until their dependencies are loaded, hence the retries; those in
+// the plugin manifest are only loaded once a node of theirs is created
+static void loadAutoloads(fs::path const &libdir) {
+    printf("loading addons from %s\n", libdir.string().c_str());
+    auto lazy = zeno::loadPluginManifest(libdir.string());
+    std::set<std::string> lazyNames(lazy.begin(), lazy.end());
+    std::vector<std::string> paths;
+    for (auto const &path: zeno::findLibraries(libdir.string())) {
+        if (lazyNames.count(fs::path(path).filename().string()))
+            printf("[ LAZY ] [%s]\n", path.c_str());
+        else
+            paths.push_back(path);
+    }
+
+    std::map<std::string, int> retries;
+    int max_retries = paths.size() + 2;
+    while (paths.size()) {
+        for (auto it = paths.begin(); it != paths.end();) {
+            if (zeno::loadLibrary(*it)) {
+                printf("[  OK  ] [%s]\n", it->c_str());
+                it = paths.erase(it);
+            } else if (retries[*it]++ > max_retries) {
+                printf("[FAILED] [%s]\n", it->c_str());
+#ifndef _WIN32
+                printf("%s\n", dlerror());
+#endif
+                it = paths.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+static zeno::IValue paramValue(Value const &x) {
+    if (x.IsString()) {
+        return x.GetString();
+    } else if (x.IsBool()) {
+        return (int)x.GetBool();
+    } else if (x.IsInt()) {
+        return x.GetInt();
+    } else if (x.IsNumber()) {
+        return (float)x.GetDouble();
+    } else {
+        return 0;
+    }
+}
+
+static bool isSpecial(Value const &data) {
+    return data.HasMember("special");
+}
+
+// mirrors zenqt/system/serial.py
+static void loadGraphs(Value const &graphs) {
+    zeno::clearAllState();
+
+    for (auto const &[key, graph]: graphs.GetObject()) {
+        zeno::switchGraph(key.GetString());
+        for (auto const &[ident_, data]: graph["nodes"].GetObject()) {
+            if (isSpecial(data))
+                continue;
+            std::string ident = ident_.GetString();
+            std::string name = data["name"].GetString();
+
+            bool isSubgraph = graphs.HasMember(name.c_str());
+            if (isSubgraph) {
+                zeno::addNode("Subgraph", ident);
+            } else if (name == "ExecutionOutput") {
+                zeno::addNode("Route", ident);
+            } else {
+                zeno::addNode(name, ident);
+            }
+
+            for (auto const &[sock, input]: data["inputs"].GetObject()) {
+                if (input.IsNull())
+                    continue;
+                zeno::bindNodeInput(ident, sock.GetString(),
+                        input[0].GetString(), input[1].GetString());
+            }
+
+            for (auto const &[par, value]: data["params"].GetObject()) {
+                if (isSubgraph && std::string(par.GetString()) == "name")
+                    continue;
+                zeno::setNodeParam(ident, par.GetString(), paramValue(value));
+            }
+            if (isSubgraph)
+                zeno::setNodeParam(ident, "name", name);
+
+            for (auto const &opt: data["options"].GetArray()) {
+                zeno::setNodeOption(ident, opt.GetString());
+            }
+
+            zeno::completeNode(ident);
+        }
+    }
+}
+
+bool runFrames(Value const &nodes, int nframes, FILE *out, int first) {
+    auto &scene = zeno::getSession().getDefaultScene();
+    std::set<std::string> applies;
+    // only expressions may change with frame, so only those are re-set
+    std::vector<std::tuple<std::string, std::string, std::string>> exprs;
+    for (auto const &[ident, data]: nodes.GetObject()) {
+        if (isSpecial(data))
+            continue;
+        for (auto const &opt: data["options"].GetArray()) {
+            if (std::string(opt.GetString()) == "VIEW")
+                applies.insert(ident.GetString());
+        }
+        for (auto const &[par, value]: data["params"].GetObject()) {
+            if (value.IsString() && strchr(value.GetString(), '{'))
+                exprs.emplace_back(ident.GetString(), par.GetString(), value.GetString());
+        }
+    }
+
+    zeno::switchGraph("main");
+
+    bool done = true;
+    try {
+        for (int frameid = first; frameid < nframes; frameid++) {
+            fprintf(out, "FRAME: %d\n", frameid);
+            if (fflush(out) != 0)  // nobody is listening any more
+                scene.cancelRequested = true;
+            if (scene.cancelRequested) {
+                done = false;
+                break;
+            }
+            for (auto const &[ident, par, expr]: exprs) {
+                zeno::setNodeParam(ident, par, zeno::evaluateFrameExpr(expr, frameid));
+            }
+
+#ifdef ZENO_GLOBALSTATE
+            zeno::state.frameBegin();
+            while (zeno::state.substepBegin()) {
+                zeno::applyNodes(applies);
+                zeno::state.substepEnd();
+            }
+#ifdef ZENO_VISUALIZATION
+            zeno::Visualization::endFrame();
+#endif
+            zeno::state.frameEnd();
+            zeno::checkpointFrame(scene);
+#else
+            zeno::applyNodes(applies);
+#endif
+        }
+    } catch (zeno::Exception const &) {
+        if (!scene.cancelRequested)
+            throw;
+        done = false;  // thrown by the node about to be applied
+    }
+
+#ifdef ZENO_VISUALIZATION
+    zeno::Visualization::flushExports();
+#endif
+    return done;
+}
+
+void runLoadedScene(Value const &nodes, int nframes,
+        std::string const &iopath, FILE *out) {
+#ifdef ZENO_GLOBALSTATE
+    zeno::state = zeno::GlobalState();
+    zeno::state.setIOPath(iopath);
+    int first = zeno::resumeFrame(zeno::getSession().getDefaultScene());
+#else
+    int first = 0;
+#endif
+    bool done = runFrames(nodes, nframes, out, first);
+    fprintf(out, done ? "EXITING\n" : "CANCELLED\n");
+    fflush(out);
+}
+
+// mirrors zenqt/system/run.py
+static void runScene(Value const &graphs, int nframes, std::string const &iopath) {
+    loadGraphs(graphs);
+    runLoadedScene(graphs["main"]["nodes"], nframes, iopath, stdout);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s prog.zsg [nframes] [iopath]\n", argv[0]);
+        fprintf(stderr, "       %s --dump-descs\n", argv[0]);
+        fprintf(stderr, "       %s --daemon socket\n", argv[0]);
+        fprintf(stderr, "       %s --write-manifest libdir\n", argv[0]);
+        return 1;
+    }
+
+    std::string arg1 = argv[1];
+    if (arg1 == "--write-manifest") {  // run by the build, see zenorun/CMakeLists.txt
+        if (argc < 3) {
+            fprintf(stderr, "%s: --write-manifest needs a library directory\n", argv[0]);
+            return 1;
+        }
+        try {
+            zeno::writePluginManifest(argv[2]);
+        } catch (zeno::Exception const &e) {
+            fprintf(stderr, "%s\n", e.what());
+            return 1;
+        }
+        return 0;
+    }
+
+    if (!getenv("ZEN_NOAUTOLOAD")) {
+        auto libdir = getenv("ZEN_LIBDIR");
+        loadAutoloads(libdir ? fs::path(libdir) : executableDir(argv[0]));
+    }
+
+    if (arg1 == "--dump-descs") {
+        printf("==<DESCS>==\n%s\n==<DESCS>==\n", zeno::dumpDescriptors().c_str());
+        return 0;
+    }
+    if (arg1 == "--daemon") {
+        if (argc < 3) {
+            fprintf(stderr, "%s: --daemon needs a socket path\n", argv[0]);
+            return 1;
+        }
+        return runDaemon(argv[2]);
+    }
+
+    std::ifstream fin(arg1);
+    if (!fin) {
+        fprintf(stderr, "cannot open %s\n", arg1.c_str());
+        return 1;
+    }
+    std::stringstream ss;
+    ss << fin.rdbuf();
+    std::string json = ss.str();
+
+    Document doc;
+    doc.Parse(json.c_str());
+    if (doc.HasParseError() || !doc.IsObject()) {
+        fprintf(stderr, "%s is not a valid .zsg file\n", arg1.c_str());
+        return 1;
+    }
+
+    int nframes = argc > 2 ? atoi(argv[2]) : 1;
+    std::string iopath = argc > 3 ? argv[3] : "/tmp";
+
+    Value scene;
+    if (doc.HasMember("graph")) {
+        scene.CopyFrom(doc["graph"], doc.GetAllocator());
+    } else {
+        scene.CopyFrom(doc, doc.GetAllocator());
+    }
+    if (!scene.HasMember("main")) {
+        Value wrapped(kObjectType);
+        wrapped.AddMember("main", scene, doc.GetAllocator());
+        scene = wrapped;
+    }
+
+    try {
+        runScene(scene, nframes, iopath);
+    } catch (zeno::Exception const &e) {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
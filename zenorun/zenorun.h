@@ -0,0 +1,18 @@
+#pragma once
+
+#include <rapidjson/document.h>
+#include <string>
+#include <cstdio>
+
+// frame loop of zenqt/system/run.py over the scene already loaded, with
+// progress written to out, from frame first on; returns false if cancelled
+// half-way
+bool runFrames(rapidjson::Value const &nodes, int nframes, FILE *out,
+        int first = 0);
+
+// same, with fresh frame state (or resumed, see Checkpoint.h), ending with EXITING or CANCELLED
+void runLoadedScene(rapidjson::Value const &nodes, int nframes,
+        std::string const &iopath, FILE *out);
+
+// serve run, cancel and descs requests from the editor, see daemon.cpp
+int runDaemon(const char *sockpath);
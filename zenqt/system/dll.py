@@ -21,11 +21,17 @@ def loadAutoloads():
     if not os.path.isdir(lib_dir):
         return
 
+    # those in the manifest are loaded once a node of theirs is created
+    lazy = set(core.loadPluginManifest(lib_dir))
+
     paths = []
     for name in os.listdir(lib_dir):
         path = os.path.join(lib_dir, name)
         if os.path.islink(path):
             continue
+        if name in lazy:
+            print('[ LAZY ] [{}]'.format(path))
+            continue
         if os_name == 'win32':
             if name.endswith('.dll'):
                 paths.append(name)
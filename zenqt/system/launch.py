@@ -4,18 +4,34 @@ import threading
 import atexit
 import shutil
 import subprocess
+import socket
+import copy
 import json
+import time
 import sys
 import os
 from multiprocessing import Process
 
+from .utils import rel2abs, os_name
+from .serial import serializeScene, serializeSceneDiff
+
 
 g_proc = None
 g_iopath = None
 
+g_daemon = None
+g_daemonGraphs = None  # what the daemon has loaded, see serializeSceneDiff
+g_daemonRun = None  # request of the run in progress, if any
+
 
 def killProcess():
     global g_proc
+    if g_daemonRun is not None:
+        # let the daemon stop at the next node, it keeps the scene loaded
+        for line in _daemon_request({'cmd': 'cancel'}):
+            pass
+        print('worker run cancelled')
+        return
     if g_proc is None:
         print('worker process is not running')
         return
@@ -49,6 +65,108 @@ def _launch_mproc(func, *args):
         g_proc = None
 
 
+def _native_runner():
+    # prefer the native runner if it was built, ZEN_PYRUN forces python
+    exe = rel2abs(__file__, '..', 'lib', 'zenorun.exe' if os_name == 'win32' else 'zenorun')
+    if os.path.isfile(exe) and not os.environ.get('ZEN_PYRUN'):
+        return exe
+    return None
+
+
+def _runner_command():
+    exe = _native_runner()
+    if exe is not None:
+        return [exe]
+    return [sys.executable, '-m', 'zenqt.system']
+
+
+def _daemon_path():
+    return os.path.join(tempfile.gettempdir(),
+            'zeno-daemon-{}.sock'.format(os.getpid()))
+
+
+def _daemon_request(req):
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    try:
+        sock.connect(_daemon_path())
+        sock.sendall((json.dumps(req) + '\n').encode())
+        with sock.makefile('r') as f:
+            for line in f:
+                yield line.rstrip('\n')
+    finally:
+        sock.close()
+
+
+def _start_daemon():
+    # the daemon keeps node libraries and the scene loaded between runs,
+    # set ZEN_NODAEMON=1 to spawn a runner process for each run instead
+    global g_daemon
+    global g_daemonGraphs
+    if os.environ.get('ZEN_NODAEMON') or not hasattr(socket, 'AF_UNIX'):
+        return False
+    if g_daemon is not None and g_daemon.poll() is None:
+        return True
+    exe = _native_runner()
+    if exe is None:
+        return False
+    g_daemonGraphs = None
+    # it exits once we close its stdin, so it never outlives the editor
+    g_daemon = subprocess.Popen([exe, '--daemon', _daemon_path()],
+            stdin=subprocess.PIPE)
+    while g_daemon.poll() is None:  # until node libraries are loaded
+        try:
+            sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+            sock.connect(_daemon_path())
+            sock.close()
+            return True
+        except OSError:
+            time.sleep(0.05)
+    print('zeno daemon exited with', g_daemon.returncode)
+    g_daemon = None
+    return False
+
+
+@atexit.register
+def stopDaemon():
+    global g_daemon
+    if g_daemon is not None:
+        g_daemon.stdin.close()
+        g_daemon.wait()
+        g_daemon = None
+
+
+def _daemon_run(graphs, nframes, iopath):
+    global g_daemonGraphs
+    global g_daemonRun
+    if g_daemonGraphs is None:
+        cmds = serializeScene(graphs)
+    else:
+        cmds = serializeSceneDiff(g_daemonGraphs, graphs)
+    req = {
+        'cmd': 'run',
+        'scene': json.dumps(list(cmds)),
+        'nodes': graphs['main']['nodes'],
+        'nframes': nframes,
+        'iopath': iopath,
+    }
+    g_daemonGraphs = None  # in case loading fails half-way
+    g_daemonRun = req
+    try:
+        failed = False
+        for line in _daemon_request(req):
+            print(line)
+            if line.startswith('ERROR'):
+                failed = True
+        # a later run may have cancelled us and loaded its own scene
+        if not failed and g_daemonRun is req:
+            g_daemonGraphs = copy.deepcopy(graphs)
+    except OSError as e:
+        print('zeno daemon request failed:', e)
+    finally:
+        if g_daemonRun is req:
+            g_daemonRun = None
+
+
 def launchProgram(prog, nframes):
     global g_iopath
     global g_proc
@@ -59,12 +177,13 @@ def launchProgram(prog, nframes):
     if os.environ.get('ZEN_SPROC') or os.environ.get('ZEN_DOFORK'):
         from . import run
         _launch_mproc(run.runScene, prog['graph'], nframes, g_iopath)
+    elif _start_daemon():
+        _daemon_run(prog['graph'], nframes, g_iopath)
     else:
         filepath = os.path.join(g_iopath, 'prog.zsg')
         with open(filepath, 'w') as f:
             json.dump(prog, f)
-        # TODO: replace with binary executable
-        g_proc = subprocess.Popen([sys.executable, '-m', 'zenqt.system', filepath, str(nframes), g_iopath])
+        g_proc = subprocess.Popen(_runner_command() + [filepath, str(nframes), g_iopath])
         retcode = g_proc.wait()
         if retcode != 0:
             print('zeno program exited with error code:', retcode)
@@ -74,8 +193,11 @@ def getDescriptors():
     if os.environ.get('ZEN_DOFORK'):
         from . import run
         descs = run.dumpDescriptors()
+    elif _start_daemon():
+        descs = '\n'.join(_daemon_request({'cmd': 'descs'}))
+        descs = descs.split('==<DESCS>==')[1]
     else:
-        descs = subprocess.check_output([sys.executable, '-m', 'zenqt.system', '--dump-descs'])
+        descs = subprocess.check_output(_runner_command() + ['--dump-descs'])
         descs = descs.split(b'==<DESCS>==')[1].decode()
     descs = descs.splitlines()
     descs = [parse_descriptor_line(line) for line in descs
@@ -1,7 +1,11 @@
+import copy
 import json
 
 from .dll import core
-from .serial import serializeScene
+from .serial import serializeScene, serializeSceneDiff
+
+
+g_loadedGraphs = None  # what core holds, when running in the same process
 
 
 def evaluateExpr(expr, frame):
@@ -11,13 +15,26 @@ def evaluateExpr(expr, frame):
         return expr
 
 
+def loadScene(graphs):
+    global g_loadedGraphs
+    # patch what we loaded last time, nodes untouched by the editor keep
+    # their caches and outputs instead of being created all over again
+    if g_loadedGraphs is None:
+        cmds = serializeScene(graphs)
+    else:
+        cmds = serializeSceneDiff(g_loadedGraphs, graphs)
+    g_loadedGraphs = None  # in case loading fails half-way
+    #data = json.dumps(list(cmds))
+    #core.loadScene(data)
+    for cmd, *args in cmds:
+        getattr(core, cmd)(*args)
+    g_loadedGraphs = copy.deepcopy(graphs)
+
+
 def runScene(graphs, nframes, iopath):
     core.setIOPath(iopath)
 
-    #data = json.dumps(list(serializeScene(graphs)))
-    #core.loadScene(data)
-    for cmd, *args in serializeScene(graphs):
-        getattr(core, cmd)(*args)
+    loadScene(graphs)
 
     applies = set()
     nodes = graphs['main']['nodes']
@@ -30,7 +47,7 @@ def runScene(graphs, nframes, iopath):
 
     core.switchGraph('main')
 
-    for frameid in range(nframes):
+    for frameid in range(core.resumeFrame(), nframes):
         print('FRAME:', frameid)
         ### BEGIN XINXIN HAPPY >>>>>
         for ident, data in graphs['main']['nodes'].items():
@@ -40,7 +57,9 @@ def runScene(graphs, nframes, iopath):
             inputs = data['inputs']
             params = data['params']
             for name, value in params.items():
-                if type(value) is str:
+                # only expressions may change with frame, re-setting an
+                # unchanged param would dirty the node and defeat reusing
+                if type(value) is str and '{' in value:
                     value = evaluateExpr(value, frameid)
                     core.setNodeParam(ident, name, value)
         ### ENDOF XINXIN HAPPY <<<<<
@@ -50,7 +69,10 @@ def runScene(graphs, nframes, iopath):
             core.applyNodes(applies)
             core.substepEnd()
         core.frameEnd()
+        core.checkpointFrame()
 
+    if hasattr(core, 'flushExports'):
+        core.flushExports()
     print('EXITING')
 
 
@@ -59,6 +81,7 @@ def dumpDescriptors():
 
 
 __all__ = [
+    'loadScene',
     'runScene',
     'dumpDescriptors',
 ]
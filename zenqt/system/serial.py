@@ -7,37 +7,116 @@ def serializeScene(graphs):
         yield from serializeGraph(graph['nodes'], subgkeys)
 
 
+def serializeSceneDiff(oldGraphs, graphs):
+    # patch the scene loaded from oldGraphs into graphs in-place, so that
+    # nodes untouched by the edit keep their state and outputs
+    oldSubgkeys = set(oldGraphs.keys())
+    subgkeys = set(graphs.keys())
+    for name, graph in graphs.items():
+        yield 'switchGraph', name
+        oldNodes = oldGraphs[name]['nodes'] if name in oldGraphs else {}
+        yield from serializeGraphDiff(oldNodes, graph['nodes'],
+                oldSubgkeys, subgkeys)
+
+    for name, graph in oldGraphs.items():
+        if name not in graphs:
+            yield 'switchGraph', name
+            yield from serializeGraphDiff(graph['nodes'], {},
+                    oldSubgkeys, subgkeys)
+
+
+def nodeClassAndParams(data, subgkeys):
+    name = data['name']
+    params = dict(data['params'])
+    if name in subgkeys:
+        params['name'] = name
+        name = 'Subgraph'
+    elif name == 'ExecutionOutput':
+        name = 'Route'
+    return name, params
+
+
 def serializeGraph(nodes, subgkeys):
     for ident, data in nodes.items():
         if 'special' in data:
             continue
-        name = data['name']
-        inputs = data['inputs']
-        params = data['params']
-        options = data['options']
+        yield from serializeNode(ident, data, subgkeys)
+
+
+def serializeNode(ident, data, subgkeys):
+    name, params = nodeClassAndParams(data, subgkeys)
+    inputs = data['inputs']
+    options = data['options']
+
+    yield 'addNode', name, ident
+
+    for name, input in inputs.items():
+        if input is None:
+            continue
+        srcIdent, srcSockName = input
+        yield 'bindNodeInput', ident, name, srcIdent, srcSockName
 
-        if name in subgkeys:
-            params['name'] = name
-            name = 'Subgraph'
-        elif name == 'ExecutionOutput':
-            name = 'Route'
-        yield 'addNode', name, ident
+    for name, value in params.items():
+        yield 'setNodeParam', ident, name, value
 
-        for name, input in inputs.items():
+    for name in options:
+        yield 'setNodeOption', ident, name
+
+    yield 'completeNode', ident
+
+
+def serializeGraphDiff(oldNodes, nodes, oldSubgkeys, subgkeys):
+    for ident, data in oldNodes.items():
+        if 'special' in data:
+            continue
+        if ident not in nodes or 'special' in nodes[ident]:
+            yield 'removeNode', ident
+
+    for ident, data in nodes.items():
+        if 'special' in data:
+            continue
+        oldData = oldNodes.get(ident)
+        if oldData is None or 'special' in oldData:
+            yield from serializeNode(ident, data, subgkeys)
+            continue
+        oldName, oldParams = nodeClassAndParams(oldData, oldSubgkeys)
+        name, params = nodeClassAndParams(data, subgkeys)
+        if name != oldName:  # addNode replaces it
+            yield from serializeNode(ident, data, subgkeys)
+            continue
+
+        cmds = []
+        oldInputs = oldData['inputs']
+        for name, input in data['inputs'].items():
             if input is None:
-                continue
-            srcIdent, srcSockName = input
-            yield 'bindNodeInput', ident, name, srcIdent, srcSockName
+                if oldInputs.get(name) is not None:
+                    cmds.append(('unbindNodeInput', ident, name))
+            elif list(input) != list(oldInputs.get(name) or ()):
+                srcIdent, srcSockName = input
+                cmds.append(('bindNodeInput', ident, name, srcIdent, srcSockName))
+        for name, input in oldInputs.items():
+            if input is not None and name not in data['inputs']:
+                cmds.append(('unbindNodeInput', ident, name))
 
         for name, value in params.items():
-            yield 'setNodeParam', ident, name, value
+            oldValue = oldParams.get(name)
+            if type(value) is not type(oldValue) or value != oldValue:
+                cmds.append(('setNodeParam', ident, name, value))
 
+        options = data['options']
+        for name in oldData['options']:
+            if name not in options:
+                cmds.append(('unsetNodeOption', ident, name))
         for name in options:
-            yield 'setNodeOption', ident, name
+            if name not in oldData['options']:
+                cmds.append(('setNodeOption', ident, name))
 
-        yield 'completeNode', ident
+        if cmds:
+            yield from cmds
+            yield 'completeNode', ident
 
 
 __all__ = [
     'serializeScene',
+    'serializeSceneDiff',
 ]
@@ -32,6 +32,14 @@ struct GraphicPrimitive : IGraphic {
     ( zeno::PrimitiveObject *prim
     , std::string const &path
     ) {
+    for (auto name: {"pos", "clr", "nrm"}) {
+        if (prim->has_attr(name) && !prim->attr_is<zeno::vec3f>(name))
+            prim->m_attrs[name] = zeno::AttributeBuffer(
+                prim->attr_as<zeno::vec3f>(name));
+    }
+    if (prim->has_attr("rad") && !prim->attr_is<float>("rad"))
+        prim->m_attrs["rad"] = zeno::AttributeBuffer(
+            prim->attr_as<float>("rad"));
     if (!prim->has_attr("pos")) {
         auto &pos = prim->add_attr<zeno::vec3f>("pos");
         for (size_t i = 0; i < pos.size(); i++) {
@@ -48,7 +56,7 @@ struct GraphicPrimitive : IGraphic {
         auto &nrm = prim->add_attr<zeno::vec3f>("nrm");
 
         if (prim->has_attr("rad")) {
-            auto &rad = prim->attr<float>("rad");
+            auto const &rad = prim->read_attr<float>("rad");
             for (size_t i = 0; i < nrm.size(); i++) {
                 nrm[i] = zeno::vec3f(rad[i], 0.0f, 0.0f);
             }
@@ -62,9 +70,9 @@ struct GraphicPrimitive : IGraphic {
             }
         }
     }
-    auto const &pos = prim->attr<zeno::vec3f>("pos");
-    auto const &clr = prim->attr<zeno::vec3f>("clr");
-    auto const &nrm = prim->attr<zeno::vec3f>("nrm");
+    auto const &pos = prim->read_attr<zeno::vec3f>("pos");
+    auto const &clr = prim->read_attr<zeno::vec3f>("clr");
+    auto const &nrm = prim->read_attr<zeno::vec3f>("nrm");
     vertex_count = prim->size();
 
     vbo = std::make_unique<Buffer>(GL_ARRAY_BUFFER);